@@ -1,5 +1,13 @@
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <exception>
+#include <map>
 #include <memory>
 #include <stdexcept>
+#include <thread>
+#include <vector>
+#include <boost/format.hpp>
 #include <boost/program_options.hpp>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_opengl.h>
@@ -8,6 +16,16 @@
 #include "Game.h"
 #include "Menu.h"
 #include "HighScores.h"
+#include "FontManager.h"
+#include "TextureManager.h"
+#include "SoundManager.h"
+#include "Bot.h"
+#include "Profiler.h"
+#include "RenderState.h"
+#include "Trace.h"
+#include "Exceptions.h"
+#include "Replay.h"
+#include "SimContext.h"
 
 namespace typing
 {
@@ -15,6 +33,8 @@ namespace typing
     const unsigned int App::MINOR_VERSION  = 0;
     const std::string  App::PRE_RELEASE_STRING(".beta");
 
+    thread_local const double *App::m_threadClock = NULL;
+
     std::auto_ptr<App> App::m_singleton(new App());
     App& App::GetApp ()
     {
@@ -36,15 +56,96 @@ namespace typing
             ("text-scale,t",
                 po::value<float>()->default_value(1.0f),
                 "set in-game text scale")
+            ("immediate-background",
+                po::bool_switch(),
+                "draw the background in immediate mode every frame")
+            ("record-replay",
+                po::value<std::string>(),
+                "record each game to a replay file")
+            ("play-replay",
+                po::value<std::string>(),
+                "play back a replay file, without rendering when headless")
+            ("profile-csv",
+                po::value<std::string>(),
+                "write the time spent in each part of every frame to a CSV file")
+            ("trace",
+                po::value<std::string>(),
+                "write a trace of each frame to a file for a trace viewer")
+            ("phrase-stream",
+                po::value<std::string>(),
+                "sample phrases from a large, optionally gzipped, phrase file")
+            ("phrase-reservoir",
+                po::value<unsigned int>()->default_value(64),
+                "phrases to sample for each start character and length")
+            ("phrase-refresh",
+                po::value<float>()->default_value(60.0f),
+                "seconds between samples of a streamed phrase file, 0 for once")
+            ("headless",
+                po::bool_switch(),
+                "simulate games with a bot typist, without a window or audio")
+            ("sim-games",
+                po::value<unsigned int>()->default_value(1),
+                "number of games to simulate when headless")
+            ("sim-max-time",
+                po::value<float>()->default_value(3600.0f),
+                "longest a simulated game may run in game seconds")
+            ("sim-threads",
+                po::value<unsigned int>()->default_value(1),
+                "threads to simulate games on, 0 for one per core")
+            ("sim-seed",
+                po::value<unsigned int>()->default_value(0),
+                "random seed for the first simulated game, 0 for a random seed")
+            ("bot-wpm",
+                po::value<float>()->default_value(60.0f),
+                "bot typing speed in words per minute")
+            ("bot-error-rate",
+                po::value<float>()->default_value(0.05f),
+                "chance of the bot hitting the wrong key")
+            ("bot-reaction",
+                po::value<float>()->default_value(0.4f),
+                "seconds the bot takes to react to a new target")
         ;
 
         po::store(po::parse_command_line(argc, argv, desc), m_options);
         po::notify(m_options);
+
+        // A streamed phrase file is sampled at random and resampled on a
+        // timer, so the same seed doesn't give the same phrases twice.
+        // Anything that needs a game to play out the same way again can't
+        // use it.
+        if (HasOption("phrase-stream")) {
+            const char *conflict = NULL;
+            if (HasOption("record-replay")) {
+                conflict = "record-replay";
+            } else if (HasOption("play-replay")) {
+                conflict = "play-replay";
+            } else if (IsHeadless()) {
+                conflict = "headless";
+            }
+
+            if (conflict) {
+                throw po::error(std::string("--phrase-stream can't be used "
+                                            "with --") + conflict);
+            }
+        }
     }
 
 
     void App::Init ()
     {
+        TRACE.Init();
+
+        if (IsHeadless()) {
+            // Only the game itself is needed to simulate games. Media is
+            // registered without being loaded, so nothing touches GL or
+            // the mixer.
+            TEXTURES.SetHeadless(true);
+            SOUNDS.SetHeadless(true);
+            GAME.Init();
+            PROFILER.Init();
+            return;
+        }
+
         // Initialise SDL
         if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO)) {
             // TODO: throw
@@ -76,12 +177,12 @@ namespace typing
 
         glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
         glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
-        glEnable(GL_LINE_SMOOTH);
-        glDisable(GL_LIGHTING);
-        glEnable(GL_TEXTURE_2D);
-        glEnable(GL_BLEND);
+        RENDERSTATE.Enable(GL_LINE_SMOOTH);
+        RENDERSTATE.Disable(GL_LIGHTING);
+        RENDERSTATE.Enable(GL_TEXTURE_2D);
+        RENDERSTATE.Enable(GL_BLEND);
 
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        RENDERSTATE.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         glMatrixMode(GL_PROJECTION_MATRIX);
         glOrtho(0.0, GetScreenWidth(), GetScreenHeight(), 0.0, 1024.0, -1024.0);
@@ -101,93 +202,428 @@ namespace typing
         SCORES.Load();
         MENU.Init();
         GAME.Init();
+        PROFILER.Init();
     }
 
     void App::Run ()
     {
-        SDL_Event ev;
+        if (HasOption("play-replay")) {
+            RunReplay();
+            return;
+        }
+
+        if (IsHeadless()) {
+            RunHeadless();
+            return;
+        }
+
+        // Time is counted in performance counter ticks multiplied by the tick
+        // rate, so that game ticks come out as a whole number of counts and
+        // no time is lost to rounding.
+        const Uint64 tickCounts = SDL_GetPerformanceFrequency();
+        const Uint64 maxPending = tickCounts * MAX_TICKS_PER_FRAME;
+        Uint64       lastCount  = SDL_GetPerformanceCounter();
+        Uint64       pending    = 0;
 
         m_done = false;
         while (!m_done)
         {
-            // Get the time of this frame
-            m_currentTime = static_cast<float>(SDL_GetTicks()) / 1000.0f;
+            PROFILER.BeginFrame();
 
-            SDL_StartTextInput();
-            while(SDL_PollEvent(&ev))
+            const Uint64 count = SDL_GetPerformanceCounter();
+            pending   = std::min(pending + (count - lastCount) * TICK_RATE,
+                                 maxPending);
+            lastCount = count;
+
+            // Input is given to the game at the start of the next tick, so
+            // that a replay can give it back at the same time.
+            for (bool first = true; pending >= tickCounts; first = false)
             {
-                switch(ev.type)
+                SetTicks(m_currentTicks + 1);
+                if (first) {
+                    ProfileScope profile(Profiler::ZONE_EVENTS);
+                    HandleEvents();
+                }
+
                 {
-                case SDL_KEYDOWN:
-                    MENU.OnKeyDown(ev.key.keysym.sym);
+                    ProfileScope profile(Profiler::ZONE_GAME_UPDATE);
+                    GAME.Update();
+                }
+                pending -= tickCounts;
+            }
+
+            {
+                ProfileScope profile(Profiler::ZONE_MENU_UPDATE);
+                MENU.Update();
+            }
+
+            DrawFrame(true, static_cast<float>(
+                                static_cast<double>(pending) / tickCounts));
+
+            PROFILER.EndFrame();
+
+            // Prepare for the next frame
+            m_keyStateValid = false;
+        }
+
+        // Save the game in progress if it is being recorded.
+        GAME.StopRecording();
+    }
+
+    void App::SetTicks (Uint32 ticks)
+    {
+        m_currentTicks = ticks;
+        m_currentTime  = static_cast<double>(ticks) / TICK_RATE;
+    }
+
+    void App::HandleEvents ()
+    {
+        SDL_Event ev;
+
+        SDL_StartTextInput();
+        while(SDL_PollEvent(&ev))
+        {
+            switch(ev.type)
+            {
+            case SDL_KEYDOWN:
+                // F3 belongs to the profiler, and isn't passed on.
+                if (ev.key.keysym.sym == SDLK_F3) {
+                    PROFILER.ToggleOverlay();
+                    break;
+                }
+
+                MENU.OnKeyDown(ev.key.keysym.sym);
+
+                if (!MENU.IsActive()) {
+                    GAME.OnKeyDown(ev.key.keysym.sym);
+                }
+                break;
+
+            case SDL_TEXTINPUT:
+                for (char *c = ev.text.text; *c != '\0'; c++) {
+                    MENU.OnType(*c);
 
                     if (!MENU.IsActive()) {
-                        GAME.OnKeyDown(ev.key.keysym.sym);
+                        GAME.OnType(*c);
                     }
+                }
+                break;
+
+            case SDL_QUIT:
+                m_done = true;
+                break;
+            }
+        }
+    }
+
+    // alpha is how far through the next tick the frame is drawn.
+    void App::DrawFrame (bool drawMenu, float alpha)
+    {
+        glClear(GL_STENCIL_BUFFER_BIT | GL_DEPTH_BUFFER_BIT |
+                GL_COLOR_BUFFER_BIT);
+
+        GAME.Draw(alpha);
+
+        // All the menu stuff is done in orthographic projection.
+        glMatrixMode(GL_MODELVIEW);
+        glLoadIdentity();
+        glMatrixMode(GL_PROJECTION);
+        glLoadIdentity();
+        glOrtho(0.0, GetScreenWidth(), GetScreenHeight(), 0.0,
+                1024.0, -1024.0);
+        if (drawMenu) {
+            MENU.Draw();
+        }
+        PROFILER.DrawOverlay();
+        FONTS.Flush();
+
+        ProfileScope profile(Profiler::ZONE_SWAP);
+        SDL_GL_SwapWindow(m_window);
+    }
+
+    // Plays a recorded game back as fast as possible, drawing each frame
+    // unless headless, and prints how long it took. The game sees exactly
+    // the same times and input as when it was recorded, so it plays out
+    // the same way every time.
+    void App::RunReplay ()
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        const std::string filename = GetOption<std::string>("play-replay");
+
+        Replay replay;
+        replay.Load(filename);
+        if (replay.GetTickRate() != TICK_RATE) {
+            throw FileCorruptException(filename);
+        }
+
+        SetTicks(replay.GetStartTicks());
+        GAME.StartNewGame(replay.GetSeed());
+
+        // Input is recorded as it arrives, before the frame it arrived in,
+        // so hold it back until the frame's time is known.
+        std::vector<Replay::Event> input;
+        Replay::Event              ev;
+        unsigned int               frames = 0;
+        Clock::time_point          start  = Clock::now();
+
+        m_done = false;
+        while (!m_done && replay.NextEvent(ev))
+        {
+            if (ev.type != Replay::EVENT_FRAME) {
+                input.push_back(ev);
+                continue;
+            }
+
+            PROFILER.BeginFrame();
+            SetTicks(m_currentTicks + ev.value);
+
+            for (std::vector<Replay::Event>::const_iterator iter = input.begin();
+                 iter != input.end();
+                 ++iter)
+            {
+                switch (iter->type)
+                {
+                case Replay::EVENT_TYPE:
+                    GAME.OnType(static_cast<char>(iter->value));
                     break;
 
-                case SDL_TEXTINPUT:
-                    for (char *c = ev.text.text; *c != '\0'; c++) {
-                        MENU.OnType(*c);
+                case Replay::EVENT_KEYDOWN:
+                    GAME.OnKeyDown(static_cast<SDL_Keycode>(iter->value));
+                    break;
 
-                        if (!MENU.IsActive()) {
-                            GAME.OnType(*c);
-                        }
-                    }
+                case Replay::EVENT_RESUME:
+                    GAME.Resume();
                     break;
 
-                case SDL_QUIT:
-                    m_done = true;
+                case Replay::EVENT_QUIT:
+                    GAME.Quit();
+                    break;
+
+                default:
                     break;
                 }
             }
+            input.clear();
 
-            GAME.Update();
-            MENU.Update();
+            {
+                ProfileScope profile(Profiler::ZONE_GAME_UPDATE);
+                GAME.Update();
+            }
+            frames++;
 
-            glClear(GL_STENCIL_BUFFER_BIT | GL_DEPTH_BUFFER_BIT |
-                    GL_COLOR_BUFFER_BIT);
+            if (!IsHeadless()) {
+                {
+                    ProfileScope profile(Profiler::ZONE_EVENTS);
+                    SDL_Event sdlEv;
+                    while (SDL_PollEvent(&sdlEv)) {
+                        if (sdlEv.type == SDL_QUIT) {
+                            m_done = true;
+                        } else if (sdlEv.type == SDL_KEYDOWN &&
+                                   sdlEv.key.keysym.sym == SDLK_F3) {
+                            PROFILER.ToggleOverlay();
+                        }
+                    }
+                }
 
-            GAME.Draw();
+                DrawFrame(false, 1.0f);
+            }
 
-            // All the menu stuff is done in orthographic projection.
-            glMatrixMode(GL_MODELVIEW);
-            glLoadIdentity();
-            glMatrixMode(GL_PROJECTION);
-            glLoadIdentity();
-            glOrtho(0.0, GetScreenWidth(), GetScreenHeight(), 0.0,
-                    1024.0, -1024.0);
-            MENU.Draw();
+            PROFILER.EndFrame();
+        }
 
-            SDL_GL_SwapWindow(m_window);
+        const double wallTime =
+            std::chrono::duration<double>(Clock::now() - start).count();
 
-            // Prepare for the next frame
-            m_keyStateValid = false;
-        }
+        fprintf(stdout, "%s\n",
+                boost::str(boost::format(
+                    "Replay %1%: score %2%, level %3%, %4% frames in "
+                    "%5% seconds (%6% ms per frame)")
+                    % filename % GAME.GetScore() % GAME.GetLevel() % frames
+                    % wallTime
+                    % (frames ? wallTime * 1000.0 / frames : 0.0)).c_str());
     }
 
-    void App::Shutdown ()
+    // Plays games with a bot as fast as possible, with a fixed frame time
+    // rather than the wall clock, and prints the results. Games are shared
+    // out between threads, each with a simulation context of its own.
+    void App::RunHeadless ()
     {
-        Mix_CloseAudio();
-        SDL_Quit();
-    }
-}
+        typedef std::chrono::steady_clock Clock;
 
-int main (int argc, char *argv[])
-{
-    try {
-        typing::APP.ParseOptions(argc, argv);
-        typing::APP.Init();
-        typing::APP.Run();
-    } catch (std::exception &e) {
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
-                                 "Exception Caught",
-                                 e.what(),
-                                 NULL);
+        const unsigned int games   = GetOption<unsigned int>("sim-games");
+        unsigned int       threads = GetOption<unsigned int>("sim-threads");
+        unsigned int       seed    = GetOption<unsigned int>("sim-seed");
+
+        if (seed == 0) {
+            seed = static_cast<unsigned int>(std::time(0));
+        }
+
+        if (threads == 0) {
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        threads = std::max(std::min(threads, games), 1u);
+
+        // The contexts register media as they are initialised, so they
+        // must all be set up before any of the threads start.
+        std::vector<std::unique_ptr<SimContext> > contexts;
+        for (unsigned int i = 0; i < threads; i++) {
+            contexts.push_back(std::unique_ptr<SimContext>(new SimContext));
+            contexts.back()->Init();
+        }
+
+        SimResultVec results(games);
+        Clock::time_point start = Clock::now();
+
+        if (threads == 1) {
+            SimulateGames(*contexts[0], 0, 1, seed, results);
+        } else {
+            std::vector<std::thread>        workers;
+            std::vector<std::exception_ptr> errors(threads);
+
+            for (unsigned int i = 0; i < threads; i++) {
+                workers.push_back(std::thread([&, i]() {
+                    try {
+                        SimulateGames(*contexts[i], i, threads, seed, results);
+                    } catch (...) {
+                        errors[i] = std::current_exception();
+                    }
+                }));
+            }
+
+            for (unsigned int i = 0; i < threads; i++) {
+                workers[i].join();
+            }
+
+            for (unsigned int i = 0; i < threads; i++) {
+                if (errors[i]) {
+                    std::rethrow_exception(errors[i]);
+                }
+            }
+        }
+
+        const double wallTime =
+            std::chrono::duration<double>(Clock::now() - start).count();
+
+        double simTime    = 0.0;
+        double totalScore = 0.0;
+        for (unsigned int game = 0; game < games; game++) {
+            const SimResult& result = results[game];
+            simTime    += result.time;
+            totalScore += result.score;
+
+            fprintf(stdout, "%s\n",
+                    boost::str(boost::format(
+                        "Game %1% (seed %2%): score %3%, level %4%, "
+                        "%5% seconds%6%")
+                        % (game + 1) % result.seed % result.score
+                        % result.level % result.time
+                        % (result.ended ? "" : ", timed out")).c_str());
+        }
+
+        // The effect pools are sized up front, so show how far each one had
+        // to grow in any of the games.
+        typedef std::map<std::string, PoolStats> PoolStatsMap;
+        PoolStatsMap pools;
+        for (unsigned int i = 0; i < threads; i++) {
+            PoolStatsVec stats;
+            contexts[i]->GetGame().GetEffectPoolStats(stats);
+
+            for (const PoolStats& pool : stats) {
+                PoolStatsMap::iterator iter = pools.find(pool.name);
+                if (iter == pools.end()) {
+                    pools[pool.name] = pool;
+                } else {
+                    iter->second.highWater =
+                        std::max(iter->second.highWater, pool.highWater);
+                    iter->second.capacity =
+                        std::max(iter->second.capacity, pool.capacity);
+                }
+            }
+        }
+
+        for (PoolStatsMap::const_iterator iter = pools.begin(); iter != pools.end(); ++iter)
+        {
+            fprintf(stdout, "%s\n",
+                    boost::str(boost::format(
+                        "Effect pool %1%: %2% high-water, %3% capacity")
+                        % iter->first % iter->second.highWater
+                        % iter->second.capacity).c_str());
+        }
+
+        fprintf(stdout, "%s\n",
+                boost::str(boost::format(
+                    "%1% games on %2% threads, average score %3%, "
+                    "%4% simulated seconds in %5% seconds "
+                    "(%6% simulated seconds per second)")
+                    % games % threads % (games ? totalScore / games : 0.0)
+                    % simTime % wallTime
+                    % (wallTime > 0.0 ? simTime / wallTime : 0.0)).c_str());
     }
 
-    typing::APP.Shutdown();
+    // Plays every stride'th game starting from first in the given context,
+    // filling in the results for those games. The other games' results are
+    // left alone, so that threads can share the results vector.
+    void App::SimulateGames (SimContext&   context,
+                             unsigned int  first,
+                             unsigned int  stride,
+                             unsigned int  seed,
+                             SimResultVec& results)
+    {
+        const float maxTime = GetOption<float>("sim-max-time");
+
+        Bot bot(GetOption<float>("bot-wpm"),
+                GetOption<float>("bot-error-rate"),
+                GetOption<float>("bot-reaction"));
+
+        context.Bind();
+
+        try {
+            for (unsigned int game = first;
+                 game < results.size();
+                 game += stride) {
+                TraceScope trace("sim_game");
+
+                context.SetTime(0.0);
+                GAME.StartNewGame(seed + game);
+                bot.Reset(seed + game);
+
+                // Simulated games run the same fixed ticks as the real game,
+                // counted rather than summed so the clock doesn't drift.
+                unsigned long ticks = 0;
+                while (!GAME.HasGameEnded() && GAME.GetTime() < maxTime) {
+                    ++ticks;
+                    context.SetTime(static_cast<double>(ticks) / TICK_RATE);
+                    bot.Update(GAME.GetTime());
+                    GAME.Update();
+                }
 
-    return 0;
-}
+                SimResult& result = results[game];
+                result.seed  = seed + game;
+                result.score = GAME.GetScore();
+                result.level = GAME.GetLevel();
+                result.time  = GAME.GetTime();
+                result.ended = GAME.HasGameEnded();
+            }
+        } catch (...) {
+            SimContext::Unbind();
+            throw;
+        }
 
+        SimContext::Unbind();
+    }
+
+    void App::Shutdown ()
+    {
+        // The phrase stream's thread logs and traces, so it has to be
+        // stopped before they are shut down.
+        GAME.Shutdown();
+        PROFILER.Shutdown();
+        TRACE.Shutdown();
+
+        if (!IsHeadless()) {
+            Mix_CloseAudio();
+        }
+        SDL_Quit();
+    }
+}
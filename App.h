@@ -3,11 +3,14 @@
 
 #include <memory>
 #include <cstdio>
+#include <vector>
 #include <boost/program_options.hpp>
 #include <SDL2/SDL.h>
 
 namespace typing
 {
+    class SimContext;
+
     class App
     {
     public:
@@ -19,7 +22,11 @@ namespace typing
         static const unsigned int MINOR_VERSION;
         static const std::string  PRE_RELEASE_STRING;
 
-        enum LogLevel { LOG_ERROR, LOG_DEBUG };
+        enum LogLevel { LOG_ERROR, LOG_INFO, LOG_DEBUG };
+
+        // The game is updated at this many ticks a second, however fast
+        // frames are drawn.
+        static const unsigned int TICK_RATE = 120;
 
         // Methods
         void Init();
@@ -27,9 +34,26 @@ namespace typing
         void Shutdown();
         void ParseOptions(int argc, char *argv[]);
 
-        float GetTime ()
+        double GetTime ()
+        {
+            return (m_threadClock ? *m_threadClock : m_currentTime);
+        }
+
+        // GetTicks
+        // Returns the number of game ticks run so far. The time is worked
+        // out from the ticks, so this is what replays record.
+        Uint32 GetTicks ()
+        {
+            return m_currentTicks;
+        }
+
+        // SetThreadClock
+        // Makes GetTime read from clock on the calling thread, so that games
+        // simulated on different threads can keep their own time. Passing
+        // NULL goes back to the application clock.
+        static void SetThreadClock(const double *clock)
         {
-            return m_currentTime;
+            m_threadClock = clock;
         }
 
         template <typename T> T GetOption(const char* option)
@@ -37,6 +61,11 @@ namespace typing
             return m_options[option].as<T>();
         }
 
+        bool HasOption(const char* option)
+        {
+            return (m_options.count(option) != 0);
+        }
+
         int GetScreenWidth()
         {
             return GetOption<int>("width");
@@ -47,6 +76,14 @@ namespace typing
             return GetOption<int>("height");
         }
 
+        // IsHeadless
+        // Returns true when simulating games without a window, GL or audio.
+        bool IsHeadless()
+        {
+            return (m_options.count("headless") &&
+                    GetOption<bool>("headless"));
+        }
+
         void Quit()
         {
             m_done = true;
@@ -62,6 +99,10 @@ namespace typing
 #endif 
                 break;
 
+            case LOG_INFO:
+                fprintf(stdout, "%s\n", str.c_str());
+                break;
+
             case LOG_ERROR:
                 fprintf(stderr, "%s\n", str.c_str());
                 break;
@@ -71,18 +112,50 @@ namespace typing
     private:
         // Ctors/Dtors
         App() :
-           m_keyState(NULL), m_keyStateValid(false), m_currentTime(0)
+           m_window(NULL), m_keyState(NULL), m_keyStateValid(false),
+           m_currentTicks(0), m_currentTime(0)
         {
         }
 
+        // Typedefs
+        struct SimResult
+        {
+            unsigned int seed;
+            unsigned int score;
+            unsigned int level;
+            double       time;
+            bool         ended;
+        };
+        typedef std::vector<SimResult> SimResultVec;
+
+        // Consts/Enums
+        // After a stall, such as the window being dragged, the missed time is
+        // dropped rather than running a long burst of ticks to catch up.
+        static const unsigned int MAX_TICKS_PER_FRAME = 8;
+
+        // Methods
+        void SetTicks(Uint32 ticks);
+        void HandleEvents();
+        void DrawFrame(bool drawMenu, float alpha);
+        void RunReplay();
+        void RunHeadless();
+        void SimulateGames(SimContext&   context,
+                           unsigned int  first,
+                           unsigned int  stride,
+                           unsigned int  seed,
+                           SimResultVec& results);
+
         // Members
         SDL_Window                            *m_window;
         Uint8                                 *m_keyState;
         bool                                   m_keyStateValid;
-        float                                  m_currentTime;
+        Uint32                                 m_currentTicks;
+        double                                 m_currentTime;
         bool                                   m_done;
         boost::program_options::variables_map  m_options;
 
+        static thread_local const double      *m_threadClock;
+
         // Singleton Implementation
         static std::auto_ptr<App> m_singleton;
     };
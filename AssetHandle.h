@@ -0,0 +1,44 @@
+#ifndef _ASSET_HANDLE_H_
+#define _ASSET_HANDLE_H_
+
+namespace typing
+{
+    // A reference to an asset held by one of the managers, given out when
+    // the asset is added. Looking an asset up by handle is an array index
+    // rather than a search by name, so handles are what drawing and sound
+    // code should hold on to. The type parameter only keeps handles for
+    // different kinds of asset apart.
+    template<typename T> struct AssetHandle
+    {
+        AssetHandle()
+            : index(INVALID_INDEX)
+        {
+        }
+
+        explicit AssetHandle(unsigned int i)
+            : index(i)
+        {
+        }
+
+        bool IsValid() const
+        {
+            return index != INVALID_INDEX;
+        }
+
+        bool operator==(const AssetHandle& h) const
+        {
+            return index == h.index;
+        }
+
+        bool operator!=(const AssetHandle& h) const
+        {
+            return !(*this == h);
+        }
+
+        static const unsigned int INVALID_INDEX = 0xFFFFFFFF;
+
+        unsigned int index;
+    };
+}
+
+#endif // _ASSET_HANDLE_H_
@@ -35,9 +35,11 @@ namespace typing
     const ColourRGB   Award::AWARD_SHORTEN_PHRASES_COLOUR(0.0f, 1.0f, 0.0f);
 
 
+    static FontHandle s_awardFont;
+
     void Award::Init()
     {
-        FONTS.Add(AWARD_FONT);
+        s_awardFont = FONTS.Add(AWARD_FONT);
     }
 
     bool Award::Unlink()
@@ -107,6 +109,6 @@ namespace typing
             str = &AWARD_SHORTEN_PHRASES_STRING;
         }
 
-        FONTS.Print(AWARD_FONT, m_origin.GetX(), y, AWARD_FONT_HEIGHT, ColourRGBA(*col, alpha), Font::ALIGN_CENTER, *str);
+        FONTS.Print(s_awardFont, m_origin.GetX(), y, AWARD_FONT_HEIGHT, ColourRGBA(*col, alpha), Font::ALIGN_CENTER, *str);
     }
 }
@@ -22,7 +22,7 @@ namespace typing
     class Award : public Effect
     {
     public:
-        Award(const juzutil::Vector2& origin, AwardType type, float startTime)
+        Award(const juzutil::Vector2& origin, AwardType type, double startTime)
             : m_origin(origin), m_type(type), m_startTime(startTime)
         {
         }
@@ -60,9 +60,8 @@ namespace typing
 
         juzutil::Vector2 m_origin;
         AwardType        m_type;
-        float            m_startTime;
+        double           m_startTime;
     };
-    typedef std::shared_ptr<Award> AwardPtr;
 }
 
 #endif // _AWARD_H_
@@ -37,29 +37,24 @@ namespace typing
         m_state = MEMORYBOSS_MOVING;
     }
 
-    void MemoryBoss::Draw2D()
+    void MemoryBoss::Draw2D(const juzutil::Vector2& screenOrigin)
     {
         if (m_state == MEMORYBOSS_LEARN) {
-            m_phrase.Draw(m_origin,
+            m_phrase.Draw(screenOrigin,
                           Phrase::PHRASE_DRAW_BLOCKED);
         } else if (m_state == MEMORYBOSS_TYPE) {
-            m_phrase.Draw(m_origin,
+            m_phrase.Draw(screenOrigin,
                           Phrase::PHRASE_DRAW_HIDDEN);
         }
     }
 
-    void MemoryBoss::Draw3D()
+    void MemoryBoss::Draw3D(const juzutil::Vector3& origin)
     {
-        glPushMatrix();
-            glTranslatef(m_origin[0], m_origin[1], m_origin[2]);
-
-            glPushMatrix();
-                glTranslatef(0.0f, 100.0f, 0.0f);
-                glScalef(30.0f, 100.0f, 30.0f);
-                DrawPyramid(MEMORYBOSS_COLOUR,
-                            MEMORYBOSS_LINE_COLOUR);
-            glPopMatrix();
-        glPopMatrix();
+        ShapeTransform transform;
+        transform.Translate(origin)
+                 .Translate(0.0f, 100.0f, 0.0f)
+                 .Scale(30.0f, 100.0f, 30.0f);
+        DrawPyramid(transform, MEMORYBOSS_COLOUR, MEMORYBOSS_LINE_COLOUR);
     }
 
     void MemoryBoss::Update()
@@ -75,6 +70,7 @@ namespace typing
                 m_phrase.Reset(GAME.GetComboPhrase(
                                     MEMORYBOSS_WORD_COUNT + GAME.GetCycles(),
                                     MEMORYBOSS_PHRASE_LENGTH));
+                GAME.IndexEntity(this);
                 m_state = MEMORYBOSS_LEARN;
                 m_stateChangeTime = GAME.GetTime();
             }
@@ -91,15 +87,15 @@ namespace typing
             if (GAME.GetTime() - m_stateChangeTime >=
                                                 MEMORYBOSS_TYPE_TIME) {
                 GAME.Damage();
-                LaserPtr laser(new Laser(m_origin,
-                                         GAME.GetPlayerOrigin(),
-                                         ColourRGB::Red()));
-                GAME.AddEffect(laser);
+                GAME.SpawnEffect<Laser>(m_origin,
+                                        GAME.GetPlayerOrigin(),
+                                        ColourRGB::Red());
 
-                GAME.MakeCharAvail(m_phrase.GetStartChar());
+                GAME.MakeCharAvail(this, m_phrase.GetStartChar());
                 m_phrase.Reset(GAME.GetComboPhrase(
                                     MEMORYBOSS_WORD_COUNT + GAME.GetCycles(),
                                     MEMORYBOSS_PHRASE_LENGTH));
+                GAME.IndexEntity(this);
 
                 m_state = MEMORYBOSS_LEARN;
                 m_stateChangeTime = GAME.GetTime();
@@ -117,19 +113,18 @@ namespace typing
             *phraseFinished = m_phrase.Finished();
 
             if (*phraseFinished) {
-                GAME.MakeCharAvail(m_phrase.GetStartChar());
+                GAME.MakeCharAvail(this, m_phrase.GetStartChar());
 
                 if (--m_health > 0) {
                     m_phrase.Reset(GAME.GetComboPhrase(
                                     MEMORYBOSS_WORD_COUNT + GAME.GetCycles(),
                                     MEMORYBOSS_PHRASE_LENGTH));
+                    GAME.IndexEntity(this);
 
                     m_state = MEMORYBOSS_LEARN;
                     m_stateChangeTime = GAME.GetTime();
                 } else {
-                    ExplosionPtr explosion(new Explosion(m_origin,
-                                                         MEMORYBOSS_COLOUR));
-                    GAME.AddEffect(explosion);
+                    GAME.SpawnEffect<Explosion>(m_origin, MEMORYBOSS_COLOUR);
                 }
             }
         }
@@ -157,22 +152,18 @@ namespace typing
         m_moving = !m_origin.Equals(BOSS_DEST_ORIGIN, BOSS_DEST_EPSILON);
     }
 
-    void KnockbackBoss::Draw2D()
+    void KnockbackBoss::Draw2D(const juzutil::Vector2& screenOrigin)
     {
-        m_phrase.Draw(m_origin);
+        m_phrase.Draw(screenOrigin);
     }
 
-    void KnockbackBoss::Draw3D()
+    void KnockbackBoss::Draw3D(const juzutil::Vector3& origin)
     {
-        glPushMatrix();
-            glTranslatef(m_origin[0], m_origin[1], m_origin[2]);
-
-            glPushMatrix();
-                glTranslatef(0.0f, 100.0f, 0.0f);
-                glScalef(30.0f, 100.0f, 30.0f);
-                DrawPyramid(KNOCKBACKBOSS_COLOUR, KNOCKBACKBOSS_LINE_COLOUR);
-            glPopMatrix();
-        glPopMatrix();
+        ShapeTransform transform;
+        transform.Translate(origin)
+                 .Translate(0.0f, 100.0f, 0.0f)
+                 .Scale(30.0f, 100.0f, 30.0f);
+        DrawPyramid(transform, KNOCKBACKBOSS_COLOUR, KNOCKBACKBOSS_LINE_COLOUR);
     }
 
     void KnockbackBoss::Update()
@@ -186,6 +177,7 @@ namespace typing
                 m_phrase.Reset(GAME.GetComboPhrase(
                     KNOCKBACKBOSS_WORD_COUNT + GAME.GetCycles(),
                     KNOCKBACKBOSS_PHRASE_LENGTH));
+                GAME.IndexEntity(this);
                 m_moving = false;
             }
         } else {
@@ -202,21 +194,20 @@ namespace typing
             *phraseFinished = m_phrase.Finished();
 
             if (*phraseFinished) {
-                GAME.MakeCharAvail(m_phrase.GetStartChar());
+                GAME.MakeCharAvail(this, m_phrase.GetStartChar());
                 m_health--;
                 if (m_health > 0) {
                     m_phrase.Reset(GAME.GetComboPhrase(
                         KNOCKBACKBOSS_WORD_COUNT + GAME.GetCycles(),
                         KNOCKBACKBOSS_PHRASE_LENGTH));
+                    GAME.IndexEntity(this);
 
                     // Knock the boss back
                     juzutil::Vector3 dir = m_origin - GAME.GetPlayerOrigin();
                     dir.Normalize();
                     m_origin += dir * KNOCKBACKBOSS_KNOCKBACK_DISTANCE;
                 } else {
-                    ExplosionPtr explosion(new Explosion(
-                                            m_origin, KNOCKBACKBOSS_COLOUR));
-                    GAME.AddEffect(explosion);
+                    GAME.SpawnEffect<Explosion>(m_origin, KNOCKBACKBOSS_COLOUR);
                 }
             }
         }
@@ -224,15 +215,15 @@ namespace typing
 
     void KnockbackBoss::OnCollide()
     {
-        GAME.MakeCharAvail(m_phrase.GetStartChar());
+        GAME.MakeCharAvail(this, m_phrase.GetStartChar());
         GAME.Damage();
-        ExplosionPtr explosion(new Explosion(m_origin, KNOCKBACKBOSS_COLOUR));
-        GAME.AddEffect(explosion);
+        GAME.SpawnEffect<Explosion>(m_origin, KNOCKBACKBOSS_COLOUR);
         // When the boss hits the player, move it back to the start and reset
         // the phrase.
         m_phrase.Reset(GAME.GetComboPhrase(
                                 KNOCKBACKBOSS_WORD_COUNT + GAME.GetCycles(),
                                 KNOCKBACKBOSS_PHRASE_LENGTH));
+        GAME.IndexEntity(this);
         m_origin = BOSS_DEST_ORIGIN;
     }
 
@@ -244,9 +235,9 @@ namespace typing
     const float BackwardsKnockbackBoss::
                                 BACKWARDSKNOCKBACKBOSS_ADVANCE_SPEED = 70.0f; 
 
-    void BackwardsKnockbackBoss::Draw2D()
+    void BackwardsKnockbackBoss::Draw2D(const juzutil::Vector2& screenOrigin)
     {
-        m_phrase.Draw(m_origin,
+        m_phrase.Draw(screenOrigin,
                       Phrase::PHRASE_DRAW_BACKWARDS);
     }
 
@@ -264,10 +255,13 @@ namespace typing
     const std::string CHARGEBOSS_CHARGE_SOUND("sounds/charge.wav");
     const float       CHARGEBOSS_CHARGE_SOUND_LENGTH = 3.0f;
 
+    static SoundHandle s_chargeBossFireSound;
+    static SoundHandle s_chargeBossChargeSound;
+
     void ChargeBoss::Init()
     {
-        SOUNDS.Add(CHARGEBOSS_FIRE_SOUND);
-        SOUNDS.Add(CHARGEBOSS_CHARGE_SOUND);
+        s_chargeBossFireSound   = SOUNDS.Add(CHARGEBOSS_FIRE_SOUND);
+        s_chargeBossChargeSound = SOUNDS.Add(CHARGEBOSS_CHARGE_SOUND);
     }
 
     void ChargeBoss::OnSpawn()
@@ -281,15 +275,15 @@ namespace typing
         m_colour = ColourRGBA::White();
         m_colour[ColourRGBA::COLOUR_ALPHA] = 0.4f;
 
-        m_chargeSound = SOUNDS.Get(CHARGEBOSS_CHARGE_SOUND);
+        m_chargeSound = SOUNDS.Get(s_chargeBossChargeSound);
     }
 
-    void ChargeBoss::Draw2D()
+    void ChargeBoss::Draw2D(const juzutil::Vector2& screenOrigin)
     {
-        m_phrase.Draw(m_origin);
+        m_phrase.Draw(screenOrigin);
     }
 
-    void ChargeBoss::Draw3D()
+    void ChargeBoss::Draw3D(const juzutil::Vector3& origin)
     {
         // This boss starts white and gets ready the closer it gets to
         // charging.
@@ -300,15 +294,11 @@ namespace typing
                                     CHARGEBOSS_BASE_CHARGE_TIME;
         }
 
-        glPushMatrix();
-            glTranslatef(m_origin[0], m_origin[1], m_origin[2]);
-
-            glPushMatrix();
-                glTranslatef(0.0f, 100.0f, 0.0f);
-                glScalef(30.0f, 100.0f, 30.0f);
-                DrawPyramid(m_colour, ColourRGBA::White());
-            glPopMatrix();
-        glPopMatrix();
+        ShapeTransform transform;
+        transform.Translate(origin)
+                 .Translate(0.0f, 100.0f, 0.0f)
+                 .Scale(30.0f, 100.0f, 30.0f);
+        DrawPyramid(transform, m_colour, ColourRGBA::White());
     }
 
     void ChargeBoss::Update()
@@ -323,6 +313,7 @@ namespace typing
                 m_phrase.Reset(GAME.GetComboPhrase(
                                    CHARGEBOSS_WORD_COUNT + GAME.GetCycles(),
                                    PhraseBook::PL_LONG));
+                GAME.IndexEntity(this);
                 CalcNextChargeTime();
             }
         } else {
@@ -335,19 +326,19 @@ namespace typing
 
             if (m_nextChargeFinishTime <= GAME.GetTime()) {
                 GAME.Damage();
-                LaserPtr laser(new Laser(m_origin,
-                                         GAME.GetPlayerOrigin(),
-                                         ColourRGB::Red()));
-                GAME.AddEffect(laser);
+                GAME.SpawnEffect<Laser>(m_origin,
+                                        GAME.GetPlayerOrigin(),
+                                        ColourRGB::Red());
                 CalcNextChargeTime();
 
                 // If we failed to type the phrase in time, get a new phrase.
-                GAME.MakeCharAvail(m_phrase.GetStartChar());
+                GAME.MakeCharAvail(this, m_phrase.GetStartChar());
                 m_phrase.Reset(GAME.GetComboPhrase(
                                  CHARGEBOSS_WORD_COUNT + GAME.GetCycles(),
                                  PhraseBook::PL_LONG));
+                GAME.IndexEntity(this);
 
-                SOUNDS.Play(CHARGEBOSS_FIRE_SOUND);
+                SOUNDS.Play(s_chargeBossFireSound);
                 m_chargeSound.Stop();
                 m_chargeSoundPlaying = false;
             }
@@ -360,16 +351,16 @@ namespace typing
         *phraseFinished = m_phrase.Finished();
 
         if (*phraseFinished) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
             --m_health;
             if (m_health > 0) {
                 m_phrase.Reset(GAME.GetComboPhrase(
                                  CHARGEBOSS_WORD_COUNT + GAME.GetCycles(),
                                  PhraseBook::PL_LONG));
+                GAME.IndexEntity(this);
                 CalcNextChargeTime();
             } else {
-                ExplosionPtr explosion(new Explosion(m_origin, m_colour));
-                GAME.AddEffect(explosion);
+                GAME.SpawnEffect<Explosion>(m_origin, m_colour);
             }
 
             m_chargeSound.Stop();
@@ -397,22 +388,18 @@ namespace typing
         m_moving = !m_origin.Equals(BOSS_DEST_ORIGIN, BOSS_DEST_EPSILON);
     }
 
-    void MissileBoss::Draw2D()
+    void MissileBoss::Draw2D(const juzutil::Vector2& screenOrigin)
     {
-        m_phrase.Draw(m_origin);
+        m_phrase.Draw(screenOrigin);
     }
 
-    void MissileBoss::Draw3D()
+    void MissileBoss::Draw3D(const juzutil::Vector3& origin)
     {
-        glPushMatrix();
-            glTranslatef(m_origin[0], m_origin[1], m_origin[2]);
-
-            glPushMatrix();
-            glTranslatef(0.0f, 100.0f, 0.0f);
-            glScalef(30.0f, 100.0f, 30.0f);
-            DrawPyramid(MISSILEBOSS_COLOUR, MISSILEBOSS_LINE_COLOUR);
-            glPopMatrix();
-        glPopMatrix();
+        ShapeTransform transform;
+        transform.Translate(origin)
+                 .Translate(0.0f, 100.0f, 0.0f)
+                 .Scale(30.0f, 100.0f, 30.0f);
+        DrawPyramid(transform, MISSILEBOSS_COLOUR, MISSILEBOSS_LINE_COLOUR);
     }
 
     void MissileBoss::Update()
@@ -427,13 +414,13 @@ namespace typing
                 m_phrase.Reset(GAME.GetComboPhrase(
                                 MISSILEBOSS_WORD_COUNT + GAME.GetCycles(),
                                 PhraseBook::PL_MEDIUM));
+                GAME.IndexEntity(this);
 
                 m_nextMissileFireTime = GAME.GetTime();
             }
         } else { 
             if (m_nextMissileFireTime <= GAME.GetTime()) {
-                MissilePtr mis(new Missile(GAME.GetPhrase(PhraseBook::PL_SINGLE), m_origin));
-                GAME.AddEntity(mis);
+                GAME.SpawnEntity<Missile>(GAME.GetPhrase(PhraseBook::PL_SINGLE), m_origin);
 
                 if (++m_currentWaveMissilesFired >= MISSILEBOSS_WAVE_MISSILE_COUNT) {
                     m_nextMissileFireTime = GAME.GetTime() + MISSILEBOSS_WAVE_GAP;
@@ -451,16 +438,15 @@ namespace typing
         *phraseFinished = m_phrase.Finished();
 
         if (*phraseFinished) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
             --m_health;
             if (m_health > 0) {
                 m_phrase.Reset(GAME.GetComboPhrase(
                                     MISSILEBOSS_WORD_COUNT + GAME.GetCycles(),
                                     PhraseBook::PL_MEDIUM));
+                GAME.IndexEntity(this);
             } else {
-                ExplosionPtr explosion(new Explosion(m_origin,
-                                                     ColourRGBA::White()));
-                GAME.AddEffect(explosion);
+                GAME.SpawnEffect<Explosion>(m_origin, ColourRGBA::White());
             }
         }
     }
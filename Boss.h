@@ -19,8 +19,8 @@ namespace typing
     public:
         void OnSpawn();
         void Update();
-        void Draw2D();
-        void Draw3D();
+        void Draw2D(const juzutil::Vector2& screenOrigin);
+        void Draw3D(const juzutil::Vector3& origin);
         void OnType(char c, bool *hit, bool *phraseFinished);
 
         const juzutil::Vector3& GetOrigin() const
@@ -43,6 +43,12 @@ namespace typing
             return (GetStartChar() == c);
         }
 
+        // The phrase can only be typed once it has been hidden.
+        char GetNextChar() const
+        {
+            return (m_state == MEMORYBOSS_TYPE ? m_phrase.GetNextChar() : '\0');
+        }
+
         bool IsPhraseSingle() const
         {
             return (m_phrase.Length() == 1);
@@ -77,7 +83,7 @@ namespace typing
         juzutil::Vector3 m_origin;
         Phrase           m_phrase;
         MemoryBossState  m_state;
-        float            m_stateChangeTime;
+        double           m_stateChangeTime;
     };
 
 
@@ -93,8 +99,8 @@ namespace typing
 
         void OnSpawn();
         void Update();
-        virtual void Draw2D();
-        void Draw3D();
+        virtual void Draw2D(const juzutil::Vector2& screenOrigin);
+        void Draw3D(const juzutil::Vector3& origin);
         void OnType(char c, bool *hit, bool *phraseFinished);
         void OnCollide();
 
@@ -124,6 +130,11 @@ namespace typing
             return (GetStartChar() == c);
         }
 
+        char GetNextChar() const
+        {
+            return m_phrase.GetNextChar();
+        }
+
         bool IsPhraseSingle() const
         {
             return (m_phrase.Length() == 1);
@@ -168,7 +179,7 @@ namespace typing
             {
             }
 
-            void Draw2D();
+            void Draw2D(const juzutil::Vector2& screenOrigin);
 
         private:
             static const float BACKWARDSKNOCKBACKBOSS_ADVANCE_SPEED;
@@ -188,8 +199,8 @@ namespace typing
 
         void OnSpawn();
         void Update();
-        void Draw2D();
-        void Draw3D();
+        void Draw2D(const juzutil::Vector2& screenOrigin);
+        void Draw3D(const juzutil::Vector3& origin);
         void OnType(char c, bool *hit, bool *phraseFinished);
 
         const juzutil::Vector3& GetOrigin() const
@@ -217,6 +228,11 @@ namespace typing
             return (GetStartChar() == c);
         }
 
+        char GetNextChar() const
+        {
+            return m_phrase.GetNextChar();
+        }
+
         bool IsPhraseSingle() const
         {
             return (m_phrase.Length() == 1);
@@ -254,7 +270,7 @@ namespace typing
         juzutil::Vector3 m_origin;
         Phrase           m_phrase;
         bool             m_moving;
-        float            m_nextChargeFinishTime;
+        double           m_nextChargeFinishTime;
         ColourRGBA       m_colour;
         bool             m_chargeSoundPlaying;
         Sound            m_chargeSound;
@@ -271,8 +287,8 @@ namespace typing
 
         void OnSpawn();
         void Update();
-        void Draw2D();
-        void Draw3D();
+        void Draw2D(const juzutil::Vector2& screenOrigin);
+        void Draw3D(const juzutil::Vector3& origin);
         void OnType(char c, bool *hit, bool *phraseFinished);
 
         const juzutil::Vector3& GetOrigin() const
@@ -300,6 +316,11 @@ namespace typing
             return (GetStartChar() == c);
         }
 
+        char GetNextChar() const
+        {
+            return m_phrase.GetNextChar();
+        }
+
         bool IsPhraseSingle() const
         {
             return (m_phrase.Length() == 1);
@@ -331,7 +352,7 @@ namespace typing
         unsigned int     m_health;
         juzutil::Vector3 m_origin;
         Phrase           m_phrase;
-        float            m_nextMissileFireTime;
+        double           m_nextMissileFireTime;
         float            m_currentWaveMissilesFired;
         bool             m_moving;
     };
@@ -343,8 +364,7 @@ namespace typing
         void Spawn()
         {
             if (!m_spawned) {
-                m_ent.reset(new T);
-                GAME.AddEntity(m_ent);
+                m_ent = GAME.SpawnEntity<T>();
                 m_spawned = true;
             }
         }
@@ -356,12 +376,15 @@ namespace typing
 
         bool IsFinished() const
         {
-            return (m_spawned && m_ent->Unlink());
+            // The boss is removed from the game once it unlinks, at which
+            // point the handle no longer resolves.
+            const Entity *ent = GAME.GetEntity(m_ent);
+            return (m_spawned && (ent == NULL || ent->Unlink()));
         }
 
         void OnFinished()
         {
-            m_ent.reset();
+            m_ent.Reset();
         }
 
         float MinProgress() const
@@ -370,8 +393,8 @@ namespace typing
         }
 
     private:
-        EntityPtr m_ent;
-        bool      m_spawned;
+        EntityHandle m_ent;
+        bool         m_spawned;
     };
 
     typedef BossEnemyWave<MissileBoss> MissileBossEnemyWave;
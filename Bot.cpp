@@ -0,0 +1,105 @@
+#include <algorithm>
+#include "Bot.h"
+#include "Game.h"
+
+namespace typing
+{
+    // The average number of characters in a word, for converting words per
+    // minute to a typing speed.
+    static const float CHARS_PER_WORD = 5.0f;
+
+    Bot::Bot(float wpm, float errorRate, float reactionTime)
+        : m_keyInterval(60.0f / (std::max(wpm, 1.0f) * CHARS_PER_WORD)),
+          m_errorRate(errorRate), m_reactionTime(reactionTime),
+          m_nextKeyTime(0.0f), m_reacted(false)
+    {
+    }
+
+
+    void Bot::Reset(unsigned int seed)
+    {
+        m_random.Seed(seed);
+        m_nextKeyTime = 0.0f;
+        m_reacted     = false;
+    }
+
+
+    void Bot::Update(double time)
+    {
+        while (time >= m_nextKeyTime) {
+            char c;
+            const Entity *target = GAME.GetTarget();
+
+            if (target) {
+                c = target->GetNextChar();
+            } else {
+                target = ChooseTarget();
+                c = (target ? target->GetStartChar() : '\0');
+
+                if (c != '\0' && !m_reacted) {
+                    // Picking a new target takes a moment.
+                    m_nextKeyTime = std::max(m_nextKeyTime, time) +
+                                                            m_reactionTime;
+                    m_reacted = true;
+                    continue;
+                }
+            }
+
+            if (c == '\0') {
+                // Nothing can be typed yet, check again next update.
+                m_nextKeyTime = time;
+                return;
+            }
+
+            if (m_random.Range(0.0f, 1.0f) < m_errorRate) {
+                c = Mistype(c);
+            }
+
+            GAME.OnType(c);
+
+            m_nextKeyTime += m_keyInterval;
+            m_reacted = false;
+        }
+    }
+
+
+    // Picks the entity closest to the player out of the ones that can be
+    // typed, as that is the one most likely to do damage.
+    const Entity *Bot::ChooseTarget() const
+    {
+        const EntityStore&      entities = GAME.GetEntities();
+        const juzutil::Vector3& player   = GAME.GetPlayerOrigin();
+
+        const Entity *closest = NULL;
+        float closestDist = 0.0f;
+
+        for (unsigned int i = 0; i < entities.Count(); i++)
+        {
+            const Entity *ent = entities[i];
+            if (ent->Unlink() ||
+                ent->GetStartChar() == '\0' ||
+                ent->GetNextChar() == '\0') {
+                continue;
+            }
+
+            const float dist = (ent->GetOrigin() - player).SquareSize();
+            if (!closest || dist < closestDist) {
+                closest     = ent;
+                closestDist = dist;
+            }
+        }
+
+        return closest;
+    }
+
+
+    char Bot::Mistype(char c)
+    {
+        char wrong;
+        do {
+            wrong = static_cast<char>(m_random.Range('a', 'z'));
+        } while (wrong == c);
+
+        return wrong;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef _BOT_H_
+#define _BOT_H_
+
+#include "Random.h"
+
+namespace typing
+{
+    class Entity;
+
+    // Plays the game by typing at it through Game::OnType, for running
+    // simulated games. The bot types at a steady speed, takes a moment to
+    // react each time it picks a new target, and sometimes hits the wrong
+    // key. The bot rolls its mistakes on its own generator, seeded with the
+    // game's seed, so that a game plays out the same way whatever else has
+    // drawn from RAND.
+    class Bot
+    {
+    public:
+        // Ctors/Dtors
+        Bot(float wpm, float errorRate, float reactionTime);
+
+        // Methods
+        void Reset(unsigned int seed);
+        void Update(double time);
+
+    private:
+        // Methods
+        const Entity *ChooseTarget() const;
+        char          Mistype(char c);
+
+        // Members
+        Random m_random;
+        float  m_keyInterval;
+        float  m_errorRate;
+        float  m_reactionTime;
+        double m_nextKeyTime;
+        bool   m_reacted;
+    };
+}
+
+#endif // _BOT_H_
@@ -1,6 +1,7 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_opengl.h>
 #include <math.h>
+#include <algorithm>
 #include "Camera.h"
 #include "App.h"
 
@@ -11,6 +12,111 @@
 
 namespace typing
 {
+    //////////////////////////////////////////////////////////////////////////
+    // View
+    //////////////////////////////////////////////////////////////////////////
+
+    View::View()
+        : m_projection(1.0f), m_modelview(1.0f),
+          m_viewport(0.0f, 0.0f, 0.0f, 0.0f), m_screenHeight(0.0f)
+    {
+        const glm::mat4 identity(1.0f);
+        std::copy(glm::value_ptr(identity),
+                  glm::value_ptr(identity) + 16,
+                  m_combined);
+    }
+
+
+    View::View(const glm::mat4& projection,
+               const glm::mat4& modelview,
+               const glm::vec4& viewport,
+               float            screenHeight)
+        : m_projection(projection), m_modelview(modelview),
+          m_viewport(viewport), m_screenHeight(screenHeight)
+    {
+        const glm::mat4 combined = projection * modelview;
+        std::copy(glm::value_ptr(combined),
+                  glm::value_ptr(combined) + 16,
+                  m_combined);
+    }
+
+
+    const juzutil::Vector2 View::Project(
+                                    const juzutil::Vector3& worldCoords) const
+    {
+        juzutil::Vector2 screenCoords;
+        ProjectAll(&worldCoords, &screenCoords, 1);
+        return screenCoords;
+    }
+
+
+    // Equivalent to glm::project followed by flipping y to screen
+    // coordinates, with the matrix product done up front.
+    void View::ProjectAll(const juzutil::Vector3 *worldCoords,
+                          juzutil::Vector2       *screenCoords,
+                          std::size_t             count) const
+    {
+        const float *m = m_combined;
+        const float halfWidth  = m_viewport[2] * 0.5f;
+        const float halfHeight = m_viewport[3] * 0.5f;
+        const float centreX    = m_viewport[0] + halfWidth;
+        const float centreY    = m_screenHeight - (m_viewport[1] + halfHeight);
+
+        for (std::size_t i = 0; i < count; i++) {
+            const float x = worldCoords[i][0];
+            const float y = worldCoords[i][1];
+            const float z = worldCoords[i][2];
+
+            const float clipX = m[0] * x + m[4] * y + m[8]  * z + m[12];
+            const float clipY = m[1] * x + m[5] * y + m[9]  * z + m[13];
+            const float clipW = m[3] * x + m[7] * y + m[11] * z + m[15];
+            const float invW  = 1.0f / clipW;
+
+            screenCoords[i].Set(centreX + clipX * invW * halfWidth,
+                                centreY - clipY * invW * halfHeight);
+        }
+    }
+
+
+    const juzutil::Vector3 View::UnProject(
+                                    const juzutil::Vector2& screenCoords,
+                                    const float             worldCoordsZ) const
+    {
+        // Unproject to the near and far clip plane and use the two values to
+        // work out how much to adjust the result by to end up at the required
+        // Z value in world coords.
+        glm::vec3 worldCoordsNear =
+            glm::unProject(
+                glm::vec3(screenCoords[0],
+                          m_screenHeight - screenCoords[1],
+                          0.0f),
+                m_modelview,
+                m_projection,
+                m_viewport);
+
+        glm::vec3 worldCoordsFar =
+            glm::unProject(
+                glm::vec3(screenCoords[0],
+                          m_screenHeight - screenCoords[1],
+                          1.0f),
+                m_modelview,
+                m_projection,
+                m_viewport);
+
+        glm::vec3 nearToFar = worldCoordsFar - worldCoordsNear;
+        float ratio = (worldCoordsZ - worldCoordsNear.z) / nearToFar.z;
+        glm::vec3 worldCoords(worldCoordsNear.x + (worldCoordsFar.x - worldCoordsNear.x) * ratio,
+                              worldCoordsNear.y + (worldCoordsFar.y - worldCoordsNear.y) * ratio,
+                              worldCoordsNear.z + (worldCoordsFar.z - worldCoordsNear.z) * ratio);
+
+        return juzutil::Vector3(worldCoords.x, worldCoords.y, worldCoords.z);
+    }
+
+
+    //////////////////////////////////////////////////////////////////////////
+    // Camera
+    //////////////////////////////////////////////////////////////////////////
+
     Camera::Camera(const juzutil::Vector3& origin, const juzutil::Vector3& lookat)
         : m_origin(origin), m_lookat(lookat)
     {
@@ -35,42 +141,40 @@ namespace typing
 
     void Camera::ApplyPerspective()
     {
+        // The viewport is read back once a frame here, rather than every
+        // time something is projected.
+        int viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        UpdateView(glm::vec4(viewport[0], viewport[1],
+                             viewport[2], viewport[3]));
+
         glMatrixMode(GL_PROJECTION);
-        glLoadIdentity();
-        glm::mat4 projection = glm::perspective(
-                                    1.30899694f, 4.0f/3.0f, 0.1f, 10000.0f);
-        glLoadMatrixf(glm::value_ptr(projection));
+        glLoadMatrixf(glm::value_ptr(m_projection));
 
         glMatrixMode(GL_MODELVIEW);
-        glLoadIdentity();
+        glLoadMatrixf(glm::value_ptr(m_modelview));
+    }
+
+
+    void Camera::UpdateView(const glm::vec4& viewport)
+    {
+        m_projection = glm::perspective(
+                                    1.30899694f, 4.0f/3.0f, 0.1f, 10000.0f);
+
         glm::vec3 origin(m_origin[0], m_origin[1], m_origin[2]);
         glm::vec3 center(m_lookat[0], m_lookat[1], m_lookat[2]);
         glm::vec3 up(m_up[0], m_up[1], m_up[2]);
-        glm::mat4 lookat = glm::lookAt(origin, center, up);
-        glLoadMatrixf(glm::value_ptr(lookat));
+        m_modelview = glm::lookAt(origin, center, up);
 
-        glGetFloatv(GL_MODELVIEW_MATRIX, (GLfloat *)&m_modelview);
-        glGetFloatv(GL_PROJECTION_MATRIX, (GLfloat *)&m_projection);
+        m_view = View(m_projection, m_modelview, viewport,
+                      static_cast<float>(APP.GetScreenHeight()));
     }
 
 
     const juzutil::Vector2 Camera::PerspectiveProject(
                                     const juzutil::Vector3& worldCoords) const
     {
-        int view[4];
-        glGetIntegerv(GL_VIEWPORT, view);
-
-        glm::vec3 obj(worldCoords[0], worldCoords[1], worldCoords[2]);
-        glm::vec3 coords = glm::project(obj,
-                                        m_modelview,
-                                        m_projection, 
-                                        glm::vec4(view[0],
-                                                  view[1],
-                                                  view[2],
-                                                  view[3]));
-    
-        return juzutil::Vector2(
-            coords.x, static_cast<float>(APP.GetScreenHeight()) - coords.y);
+        return m_view.Project(worldCoords);
     }
 
 
@@ -78,39 +182,7 @@ namespace typing
                                     const juzutil::Vector2& screenCoords,
                                     const float             worldCoordsZ) const
     {
-        int view[4];
-        glGetIntegerv(GL_VIEWPORT, view);
-
-        // Unproject to the near and far clip plane and use the two values to
-        // work out how much to adjust the result by to end up at the required
-        // Z value in world coords.
-        glm::vec3 worldCoordsNear =
-            glm::unProject(
-                glm::vec3(screenCoords[0],
-                          static_cast<float>(APP.GetScreenHeight()) -
-                                                            screenCoords[1],
-                          0.0f),
-                m_modelview,
-                m_projection,
-                glm::vec4(view[0], view[1], view[2], view[3]));
-
-        glm::vec3 worldCoordsFar =
-            glm::unProject(
-                glm::vec3(screenCoords[0],
-                          static_cast<float>(APP.GetScreenHeight()) -
-                                                            screenCoords[1],
-                          1.0f),
-                m_modelview,
-                m_projection,
-                glm::vec4(view[0], view[1], view[2], view[3]));
-
-        glm::vec3 nearToFar = worldCoordsFar - worldCoordsNear;
-        float ratio = (0.0f - worldCoordsNear.z) / nearToFar.z;
-        glm::vec3 worldCoords(worldCoordsNear.x + (worldCoordsFar.x - worldCoordsNear.x) * ratio,
-                              worldCoordsNear.y + (worldCoordsFar.y - worldCoordsNear.y) * ratio,
-                              worldCoordsNear.z + (worldCoordsFar.z - worldCoordsNear.z) * ratio);
-
-        return juzutil::Vector3(worldCoords.x, worldCoords.y, worldCoords.z);
+        return m_view.UnProject(screenCoords, worldCoordsZ);
     }
 
 
@@ -1,23 +1,62 @@
 #ifndef __CAMERA_H__
 #define __CAMERA_H__
 
+#include <cstddef>
 #include "Vector.h"
 #include <glm/glm.hpp>
 
 namespace typing
 {
+    // A snapshot of the camera matrices and the viewport, taken once a frame
+    // when the perspective projection is applied, so that projecting between
+    // world and screen coordinates doesn't need to query GL.
+    class View
+    {
+    public:
+        View();
+        View(const glm::mat4& projection,
+             const glm::mat4& modelview,
+             const glm::vec4& viewport,
+             float            screenHeight);
+
+        const juzutil::Vector2 Project(
+                                const juzutil::Vector3& worldCoords) const;
+        void                   ProjectAll(
+                                const juzutil::Vector3 *worldCoords,
+                                juzutil::Vector2       *screenCoords,
+                                std::size_t             count) const;
+        const juzutil::Vector3 UnProject(
+                                const juzutil::Vector2& screenCoords,
+                                const float             worldCoordsZ) const;
+
+    private:
+        glm::mat4 m_projection;
+        glm::mat4 m_modelview;
+        glm::vec4 m_viewport;
+        float     m_screenHeight;
+
+        // projection * modelview, stored column major.
+        float     m_combined[16];
+    };
+
     class Camera
     {
     public:
         Camera(const juzutil::Vector3& origin, const juzutil::Vector3& lookat);
         
         void ApplyPerspective();
+        void UpdateView(const glm::vec4& viewport);
         const juzutil::Vector2 PerspectiveProject(
                                 const juzutil::Vector3& worldCoords) const;
         const juzutil::Vector3 UnPerspectiveProject(
                                 const juzutil::Vector2& screenCoords,
                                 const float             worldCoordsZ) const;
 
+        const View& GetView() const
+        {
+            return m_view;
+        }
+
         void ApplyOrtho() const;
 
         const juzutil::Vector3& GetUp() const
@@ -38,6 +77,7 @@ namespace typing
         juzutil::Vector3 m_up;
         glm::mat4        m_projection;
         glm::mat4        m_modelview;
+        View             m_view;
     };
 }
 
@@ -0,0 +1,98 @@
+#ifndef _CHAR_SET_H_
+#define _CHAR_SET_H_
+
+#include <stdint.h>
+#include <array>
+
+namespace typing
+{
+    // A set of chars held densely in an array, with each char's position
+    // in the array kept alongside, so that adding, removing, testing and
+    // picking the nth char are all constant time and never allocate.
+    // Removing a char moves the last char into its place, so the order of
+    // the chars depends on what has been added and removed.
+    class CharSet
+    {
+    public:
+        // Ctors/Dtors
+        CharSet()
+            : m_count(0)
+        {
+            m_index.fill(static_cast<uint16_t>(NOT_PRESENT));
+        }
+
+        // Methods
+        bool Contains(char c) const
+        {
+            return m_index[Slot(c)] != NOT_PRESENT;
+        }
+
+        void Insert(char c)
+        {
+            if (!Contains(c)) {
+                m_index[Slot(c)] = static_cast<uint16_t>(m_count);
+                m_chars[m_count++] = c;
+            }
+        }
+
+        void Insert(const CharSet& chars)
+        {
+            for (unsigned int i = 0; i < chars.Size(); ++i) {
+                Insert(chars[i]);
+            }
+        }
+
+        void Erase(char c)
+        {
+            if (Contains(c)) {
+                const uint16_t index = m_index[Slot(c)];
+                const char     last  = m_chars[--m_count];
+
+                m_chars[index]      = last;
+                m_index[Slot(last)] = index;
+                m_index[Slot(c)]    = NOT_PRESENT;
+            }
+        }
+
+        void Clear()
+        {
+            for (unsigned int i = 0; i < m_count; ++i) {
+                m_index[Slot(m_chars[i])] = NOT_PRESENT;
+            }
+            m_count = 0;
+        }
+
+        unsigned int Size() const
+        {
+            return m_count;
+        }
+
+        bool Empty() const
+        {
+            return m_count == 0;
+        }
+
+        // Returns the nth char in the set, which must be less than Size.
+        char operator[](unsigned int n) const
+        {
+            return m_chars[n];
+        }
+
+    private:
+        // Consts/Enums
+        enum { CHAR_COUNT = 256, NOT_PRESENT = 0xFFFF };
+
+        // Methods
+        static unsigned int Slot(char c)
+        {
+            return static_cast<unsigned char>(c);
+        }
+
+        // Members
+        std::array<char, CHAR_COUNT>     m_chars;
+        std::array<uint16_t, CHAR_COUNT> m_index;
+        unsigned int                     m_count;
+    };
+}
+
+#endif // _CHAR_SET_H_
@@ -23,7 +23,6 @@ namespace typing
         {
         }
     };
-    typedef std::shared_ptr<Effect> EffectPtr;
 }
 
 #endif // _EFFECT_H_
@@ -0,0 +1,65 @@
+#include "EffectStore.h"
+
+namespace typing
+{
+    EffectStore::EffectStore()
+    {
+    }
+
+
+    EffectStore::~EffectStore()
+    {
+        Clear();
+    }
+
+
+    void EffectStore::Update()
+    {
+        // Effects spawned while updating are added to the end, and are
+        // updated this frame as well.
+        for (LiveVec::size_type i = 0; i < m_live.size(); i++)
+        {
+            m_live[i].effect->Update();
+        }
+
+        // Return the finished effects to their pools, keeping the order of
+        // the rest so that they are still drawn in the order they spawned.
+        LiveVec::iterator out = m_live.begin();
+        for (LiveVec::iterator iter = m_live.begin(); iter != m_live.end(); ++iter)
+        {
+            if (iter->effect->Unlink()) {
+                iter->pool->Destroy(iter->effect);
+            } else {
+                *out++ = *iter;
+            }
+        }
+
+        m_live.erase(out, m_live.end());
+    }
+
+
+    void EffectStore::Draw()
+    {
+        for (LiveVec::iterator iter = m_live.begin(); iter != m_live.end(); ++iter)
+        {
+            iter->effect->Draw();
+        }
+    }
+
+
+    void EffectStore::Clear()
+    {
+        for (LiveVec::iterator iter = m_live.begin(); iter != m_live.end(); ++iter)
+        {
+            iter->pool->Destroy(iter->effect);
+        }
+
+        m_live.clear();
+    }
+
+
+    void EffectStore::GetPoolStats(PoolStatsVec& stats) const
+    {
+        m_pools.GetStats(stats);
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef _EFFECT_STORE_H_
+#define _EFFECT_STORE_H_
+
+#include <utility>
+#include <vector>
+#include "Effect.h"
+#include "TypedPool.h"
+
+namespace typing
+{
+    // Owns the effects for one layer of the game. Each type of effect is
+    // kept in its own pool, and finished effects go back to their pool to be
+    // reused, so the bursts of effects when lots of enemies die at once
+    // don't allocate.
+    class EffectStore
+    {
+    public:
+        // Ctors/Dtors
+        EffectStore();
+        ~EffectStore();
+
+        // Methods
+        template<typename T, typename... Args> T *Create(Args&&... args)
+        {
+            Pools::Pool<T>& pool = m_pools.Get<T>();
+            T *effect = pool.Create(std::forward<Args>(args)...);
+
+            LiveEffect live = { effect, &pool };
+            m_live.push_back(live);
+            return effect;
+        }
+
+        // Reserve
+        // Grows the pool for a type of effect to hold at least count effects.
+        template<typename T> void Reserve(unsigned int count)
+        {
+            m_pools.Get<T>().Reserve(count);
+        }
+
+        void Update();
+        void Draw();
+        void Clear();
+        void GetPoolStats(PoolStatsVec& stats) const;
+
+        unsigned int Count() const
+        {
+            return static_cast<unsigned int>(m_live.size());
+        }
+
+    private:
+        // Ctors/Dtors
+        EffectStore(const EffectStore& store);
+
+        // Typedefs
+        typedef TypedPools<Effect> Pools;
+
+        struct LiveEffect
+        {
+            Effect          *effect;
+            Pools::PoolBase *pool;
+        };
+
+        typedef std::vector<LiveEffect> LiveVec;
+
+        // Members
+        Pools   m_pools;
+        LiveVec m_live;
+    };
+}
+
+#endif // _EFFECT_STORE_H_
@@ -23,19 +23,18 @@ namespace typing
     const ColourRGBA  BasicEnemy::BASICENEMY_COLOUR(1.0f, 0.85f, 0.0f, 0.4f);
     const ColourRGBA  BasicEnemy::BASICENEMY_OUTLINECOLOUR(1.0f, 0.9f, 0.8f, 1.0f);
 
-    void BasicEnemy::Draw2D()
+    void BasicEnemy::Draw2D(const juzutil::Vector2& screenOrigin)
     {
-        m_phrase.Draw(m_origin);
+        m_phrase.Draw(screenOrigin);
     }
 
-    void BasicEnemy::Draw3D()
+    void BasicEnemy::Draw3D(const juzutil::Vector3& origin)
     {
-        glPushMatrix();
-            glTranslatef(m_origin[0], m_origin[1], m_origin[2]);
-            glRotatef(m_angle, 0.0f, 0.0f, 1.0f);
-            glScalef(10.0f, 40.0f, 10.0f);
-            DrawPyramid(BASICENEMY_COLOUR, BASICENEMY_OUTLINECOLOUR);
-        glPopMatrix();
+        ShapeTransform transform;
+        transform.Translate(origin)
+                 .Rotate(m_angle, 0.0f, 0.0f, 1.0f)
+                 .Scale(10.0f, 40.0f, 10.0f);
+        DrawPyramid(transform, BASICENEMY_COLOUR, BASICENEMY_OUTLINECOLOUR);
     }
 
     void BasicEnemy::OnSpawn()
@@ -53,7 +52,7 @@ namespace typing
 
     void BasicEnemy::OnCollide()
     {
-        GAME.MakeCharAvail(m_phrase.GetStartChar());
+        GAME.MakeCharAvail(this, m_phrase.GetStartChar());
         GAME.Damage();
         m_unlink = true;
     }
@@ -64,8 +63,8 @@ namespace typing
         *phraseFinished = m_phrase.Finished();
 
         if (*phraseFinished) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
-            GAME.AddEffect(ExplosionPtr(new Explosion(m_origin, BASICENEMY_COLOUR)));
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
+            GAME.SpawnEffect<Explosion>(m_origin, BASICENEMY_COLOUR);
             m_unlink = true;
         }
     }
@@ -73,9 +72,8 @@ namespace typing
     void BasicEnemy::OnPlayerDie()
     {
         if (!m_unlink) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
-            GAME.AddEffect(ExplosionPtr(
-                                new Explosion(m_origin, BASICENEMY_COLOUR)));
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
+            GAME.SpawnEffect<Explosion>(m_origin, BASICENEMY_COLOUR);
             m_unlink = true;
         }
     }
@@ -91,22 +89,19 @@ namespace typing
     const float       AccelEnemy::ACCELENEMY_ACCEL = 2.0f;
     const float       ACCELENEMY_MAX_SPEED = 600.0f;
 
-    void AccelEnemy::Draw2D()
+    void AccelEnemy::Draw2D(const juzutil::Vector2& screenOrigin)
     {
-        m_phrase.Draw(m_origin);
+        m_phrase.Draw(screenOrigin);
     }
 
-    void AccelEnemy::Draw3D()
+    void AccelEnemy::Draw3D(const juzutil::Vector3& origin)
     {
-        glPushMatrix();
-            glTranslatef(m_origin[0], m_origin[1], m_origin[2]);
-            glRotatef(m_angle, 0.0f, 0.0f, 1.0f);
-            glPushMatrix();
-                glRotatef(45.0f, 0.0f, 1.0f, 0.0f);
-                glScalef(7.5f, 40.0f, 7.5f);
-                DrawPyramid(ACCELENEMY_COLOUR, ACCELENEMY_OUTLINECOLOUR);
-            glPopMatrix();
-        glPopMatrix();
+        ShapeTransform transform;
+        transform.Translate(origin)
+                 .Rotate(m_angle, 0.0f, 0.0f, 1.0f)
+                 .Rotate(45.0f, 0.0f, 1.0f, 0.0f)
+                 .Scale(7.5f, 40.0f, 7.5f);
+        DrawPyramid(transform, ACCELENEMY_COLOUR, ACCELENEMY_OUTLINECOLOUR);
     }
 
     void AccelEnemy::OnSpawn()
@@ -124,7 +119,7 @@ namespace typing
 
     void AccelEnemy::OnCollide()
     {
-        GAME.MakeCharAvail(m_phrase.GetStartChar());
+        GAME.MakeCharAvail(this, m_phrase.GetStartChar());
         GAME.Damage();
         m_unlink = true;
     }
@@ -141,8 +136,8 @@ namespace typing
         }
 
         if (*phraseFinished) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
-            GAME.AddEffect(ExplosionPtr(new Explosion(m_origin, ACCELENEMY_COLOUR)));
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
+            GAME.SpawnEffect<Explosion>(m_origin, ACCELENEMY_COLOUR);
             m_unlink = true;
         }
     }
@@ -150,9 +145,8 @@ namespace typing
     void AccelEnemy::OnPlayerDie()
     {
         if (!m_unlink) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
-            GAME.AddEffect(ExplosionPtr(
-                                new Explosion(m_origin, ACCELENEMY_COLOUR)));
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
+            GAME.SpawnEffect<Explosion>(m_origin, ACCELENEMY_COLOUR);
             m_unlink = true;
         }
     }
@@ -167,24 +161,25 @@ namespace typing
     const ColourRGBA Missile::MISSILE_OUTLINECOLOUR(1.0f, 0.8f, 0.8f, 1.0f);
     const std::string MISSILE_LAUNCH_SOUND("sounds/missile.wav");
 
+    static SoundHandle s_missileLaunchSound;
+
     void Missile::Init()
     {
-        SOUNDS.Add(MISSILE_LAUNCH_SOUND);
+        s_missileLaunchSound = SOUNDS.Add(MISSILE_LAUNCH_SOUND);
     }
 
-    void Missile::Draw2D()
+    void Missile::Draw2D(const juzutil::Vector2& screenOrigin)
     {
-        m_phrase.Draw(m_origin);
+        m_phrase.Draw(screenOrigin);
     }
 
-    void Missile::Draw3D()
+    void Missile::Draw3D(const juzutil::Vector3& origin)
     {
-        glPushMatrix();
-            glTranslatef(m_origin[0], m_origin[1], m_origin[2]);
-            glRotatef(m_angle, 0.0f, 0.0f, 1.0f);
-            glScalef(3.0f, 16.0f, 3.0f);
-            DrawPyramid(MISSILE_COLOUR, MISSILE_OUTLINECOLOUR);
-        glPopMatrix();
+        ShapeTransform transform;
+        transform.Translate(origin)
+                 .Rotate(m_angle, 0.0f, 0.0f, 1.0f)
+                 .Scale(3.0f, 16.0f, 3.0f);
+        DrawPyramid(transform, MISSILE_COLOUR, MISSILE_OUTLINECOLOUR);
     }
 
     void Missile::OnSpawn()
@@ -192,7 +187,7 @@ namespace typing
         m_dir = GAME.GetPlayerOrigin() - m_origin;
         m_dir.Normalize();
         m_angle = (atan2(m_dir[0], -m_dir[1]) / static_cast<float>(M_PI) * 180.0f);
-        SOUNDS.Play(MISSILE_LAUNCH_SOUND);
+        SOUNDS.Play(s_missileLaunchSound);
     }
 
     void Missile::Update()
@@ -202,7 +197,7 @@ namespace typing
 
     void Missile::OnCollide()
     {
-        GAME.MakeCharAvail(m_phrase.GetStartChar());
+        GAME.MakeCharAvail(this, m_phrase.GetStartChar());
         GAME.Damage();
         m_unlink = true;
     }
@@ -213,8 +208,8 @@ namespace typing
         *phraseFinished = m_phrase.Finished();
 
         if (*phraseFinished) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
-            GAME.AddEffect(ExplosionPtr(new Explosion(m_origin, MISSILE_COLOUR)));
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
+            GAME.SpawnEffect<Explosion>(m_origin, MISSILE_COLOUR);
             m_unlink = true;
         }
     }
@@ -222,9 +217,8 @@ namespace typing
     void Missile::OnPlayerDie()
     {
         if (!m_unlink) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
-            GAME.AddEffect(ExplosionPtr(
-                                    new Explosion(m_origin, MISSILE_COLOUR)));
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
+            GAME.SpawnEffect<Explosion>(m_origin, MISSILE_COLOUR);
             m_unlink = true;
         }
     }
@@ -239,30 +233,28 @@ namespace typing
     const ColourRGBA       MissileEnemy::MISSILEENEMY_COLOUR(1.0f, 0.20f, 0.0f, 0.4f);
     const ColourRGBA       MissileEnemy::MISSILEENEMY_OUTLINECOLOUR(1.0f, 0.9f, 0.8f, 1.0f);
 
-    void MissileEnemy::Draw2D()
+    void MissileEnemy::Draw2D(const juzutil::Vector2& screenOrigin)
     {
-        m_phrase.Draw(m_origin);
+        m_phrase.Draw(screenOrigin);
     }
 
-    void MissileEnemy::Draw3D()
+    void MissileEnemy::Draw3D(const juzutil::Vector3& origin)
     {
-        const juzutil::Vector3 dirToPlayer = GAME.GetPlayerOrigin() - m_origin;
+        const juzutil::Vector3 dirToPlayer = GAME.GetPlayerOrigin() - origin;
         const float turretAngle = (atan2(dirToPlayer[0], -dirToPlayer[1]) / static_cast<float>(M_PI) * 180.0f);
 
-        glPushMatrix();
-            glTranslatef(m_origin[0], m_origin[1], m_origin[2]);
-            glPushMatrix();
-                glRotatef(turretAngle, 0.0f, 0.0f, 1.0f);
-                glScalef(8.0f, 30.0f, 8.f);
-                DrawPyramid(MISSILEENEMY_COLOUR, MISSILEENEMY_OUTLINECOLOUR);
-            glPopMatrix();
+        ShapeTransform transform;
+        transform.Translate(origin);
+
+        ShapeTransform turretTransform(transform);
+        turretTransform.Rotate(turretAngle, 0.0f, 0.0f, 1.0f)
+                       .Scale(8.0f, 30.0f, 8.f);
+        DrawPyramid(turretTransform, MISSILEENEMY_COLOUR, MISSILEENEMY_OUTLINECOLOUR);
 
-            glPushMatrix();
-                glTranslatef(0.0f, 0.0f, -8.0f);
-                glScalef(30.0f, 20.0f, 10.0f);
-                DrawCube(MISSILEENEMY_COLOUR, MISSILEENEMY_OUTLINECOLOUR);
-            glPopMatrix();
-        glPopMatrix();
+        ShapeTransform bodyTransform(transform);
+        bodyTransform.Translate(0.0f, 0.0f, -8.0f)
+                     .Scale(30.0f, 20.0f, 10.0f);
+        DrawCube(bodyTransform, MISSILEENEMY_COLOUR, MISSILEENEMY_OUTLINECOLOUR);
     }
 
     void MissileEnemy::OnSpawn()
@@ -280,14 +272,14 @@ namespace typing
         // right, rather than the bottom or top.
         if ((m_dir[0] > 0 && m_origin[0] > -m_startOrigin[0]) ||
             (m_dir[0] < 0 && m_origin[0] < -m_startOrigin[0])) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
             m_unlink = true;
         }
 
         if (GAME.GetTime() - m_lastFireTime > MISSILEENEMY_FIREPAUSE)
         {
-            GAME.AddEntity(MissilePtr(
-                new Missile(GAME.GetPhrase(PhraseBook::PL_SINGLE), m_origin)));
+            GAME.SpawnEntity<Missile>(GAME.GetPhrase(PhraseBook::PL_SINGLE),
+                                      m_origin);
             m_lastFireTime = GAME.GetTime();
         }
     }
@@ -298,9 +290,8 @@ namespace typing
         *phraseFinished = m_phrase.Finished();
 
         if (*phraseFinished) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
-            GAME.AddEffect(ExplosionPtr(new Explosion(m_origin,
-                                                      MISSILEENEMY_COLOUR)));
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
+            GAME.SpawnEffect<Explosion>(m_origin, MISSILEENEMY_COLOUR);
             m_unlink = true;
         }
     }
@@ -308,9 +299,8 @@ namespace typing
     void MissileEnemy::OnPlayerDie()
     {
         if (!m_unlink) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
-            GAME.AddEffect(ExplosionPtr(
-                                new Explosion(m_origin, MISSILEENEMY_COLOUR)));
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
+            GAME.SpawnEffect<Explosion>(m_origin, MISSILEENEMY_COLOUR);
             m_unlink = true;
         }
     }
@@ -327,12 +317,12 @@ namespace typing
     const float        BombEnemy::BOMB_BLINK_TIME       = 3.0f;
     const float        BombEnemy::BOMB_BLINK_SPEED      = 8.0f;
 
-    void BombEnemy::Draw2D()
+    void BombEnemy::Draw2D(const juzutil::Vector2& screenOrigin)
     {
-        m_phrase.Draw(m_origin);
+        m_phrase.Draw(screenOrigin);
     }
 
-    void BombEnemy::Draw3D()
+    void BombEnemy::Draw3D(const juzutil::Vector3& origin)
     {
         ColourRGBA outlineColour(BOMB_OUTLINECOLOUR);
         const float blinkTime = (GAME.GetTime() - m_spawnTime) -
@@ -344,14 +334,13 @@ namespace typing
                              static_cast<float>(M_PI) * BOMB_BLINK_SPEED));
         }
 
-        glPushMatrix();
-            glTranslatef(m_origin[0], m_origin[1], m_origin[2]);
-            glRotatef(m_angles[0], 0.0f, 0.0f, 1.0f);
-            glRotatef(m_angles[1], 0.0f, 1.0f, 0.0f);
-            glRotatef(m_angles[2], 1.0f, 0.0f, 0.0f);
-            glScalef(10.0f, 10.0f, 10.0f);
-            DrawDodecahedron(BOMB_COLOUR, outlineColour);
-        glPopMatrix();
+        ShapeTransform transform;
+        transform.Translate(origin)
+                 .Rotate(m_angles[0], 0.0f, 0.0f, 1.0f)
+                 .Rotate(m_angles[1], 0.0f, 1.0f, 0.0f)
+                 .Rotate(m_angles[2], 1.0f, 0.0f, 0.0f)
+                 .Scale(10.0f);
+        DrawDodecahedron(transform, BOMB_COLOUR, outlineColour);
     }
 
     void BombEnemy::OnSpawn()
@@ -380,12 +369,12 @@ namespace typing
         *phraseFinished = m_phrase.Finished();
 
         if (!*hit) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
             Detonate();
             *phraseFinished = true;
         } else if (*phraseFinished) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
-            GAME.AddEffect(ExplosionPtr(new Explosion(m_origin, BOMB_COLOUR)));
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
+            GAME.SpawnEffect<Explosion>(m_origin, BOMB_COLOUR);
             m_unlink = true;
         }
     }
@@ -393,8 +382,8 @@ namespace typing
     void BombEnemy::OnPlayerDie()
     {
         if (!m_unlink) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
-            GAME.AddEffect(ExplosionPtr(new Explosion(m_origin, BOMB_COLOUR)));
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
+            GAME.SpawnEffect<Explosion>(m_origin, BOMB_COLOUR);
             m_unlink = true;
         }
     }
@@ -403,11 +392,11 @@ namespace typing
     {
         GAME.Damage();
 
-        ExplosionPtr explosion(new Explosion(m_origin, BOMB_COLOUR));
-        GAME.AddEffect(explosion);
+        GAME.SpawnEffect<Explosion>(m_origin, BOMB_COLOUR);
 
-        LaserPtr laser(new Laser(m_origin, GAME.GetPlayerOrigin(), BOMB_COLOUR.ToRGB()));
-        GAME.AddEffect(laser);
+        GAME.SpawnEffect<Laser>(m_origin,
+                                GAME.GetPlayerOrigin(),
+                                BOMB_COLOUR.ToRGB());
 
         m_unlink = true;
     }
@@ -424,19 +413,18 @@ namespace typing
     const float        SeekerEnemy::SEEKER_SEEK_MOVE_SPEED = 120.0f;
     const float        SeekerEnemy::SEEKER_ATTACK_MOVE_SPEED = 300.0f;
 
-    void SeekerEnemy::Draw2D()
+    void SeekerEnemy::Draw2D(const juzutil::Vector2& screenOrigin)
     {
-        m_phrase.Draw(m_origin);
+        m_phrase.Draw(screenOrigin);
     }
 
-    void SeekerEnemy::Draw3D()
+    void SeekerEnemy::Draw3D(const juzutil::Vector3& origin)
     {
-        glPushMatrix();
-            glTranslatef(m_origin[0], m_origin[1], m_origin[2]);
-            glRotatef(m_angle, 0.0f, 0.0f, 1.0f);
-            glScalef(10.0f, 40.0f, 10.0f);
-            DrawPyramid(SEEKER_COLOUR, SEEKER_OUTLINECOLOUR);
-        glPopMatrix();
+        ShapeTransform transform;
+        transform.Translate(origin)
+                 .Rotate(m_angle, 0.0f, 0.0f, 1.0f)
+                 .Scale(10.0f, 40.0f, 10.0f);
+        DrawPyramid(transform, SEEKER_COLOUR, SEEKER_OUTLINECOLOUR);
     }
 
     void SeekerEnemy::OnSpawn()
@@ -490,8 +478,8 @@ namespace typing
         *phraseFinished = m_phrase.Finished();
 
         if (*phraseFinished) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
-            GAME.AddEffect(ExplosionPtr(new Explosion(m_origin, SEEKER_COLOUR)));
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
+            GAME.SpawnEffect<Explosion>(m_origin, SEEKER_COLOUR);
             m_unlink = true;
         } else if (m_seeking) {
             StartAttack();
@@ -501,16 +489,15 @@ namespace typing
     void SeekerEnemy::OnPlayerDie()
     {
         if (!m_unlink) {
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
-            GAME.AddEffect(ExplosionPtr(new Explosion(m_origin,
-                                                      SEEKER_COLOUR)));
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
+            GAME.SpawnEffect<Explosion>(m_origin, SEEKER_COLOUR);
             m_unlink = true;
         }
     }
 
     void SeekerEnemy::OnCollide()
     {
-        GAME.MakeCharAvail(m_phrase.GetStartChar());
+        GAME.MakeCharAvail(this, m_phrase.GetStartChar());
         GAME.Damage();
         m_unlink = true;
     }
@@ -18,14 +18,14 @@ namespace typing
     class BasicEnemy : public Entity
     {
     public:
-        BasicEnemy(const std::string& phrase, const juzutil::Vector3& origin, float speed)
+        BasicEnemy(PhraseView phrase, const juzutil::Vector3& origin, float speed)
             : m_phrase(phrase), m_origin(origin), m_speed(speed), m_unlink(false)
         {
         }
 
         void Update();
-        void Draw2D();
-        void Draw3D();
+        void Draw2D(const juzutil::Vector2& screenOrigin);
+        void Draw3D(const juzutil::Vector3& origin);
         void OnSpawn();
         void OnCollide();
         void OnType(char c, bool *hit, bool *phraseFinished);
@@ -56,6 +56,11 @@ namespace typing
             return (GetStartChar() == c);
         }
 
+        char GetNextChar() const
+        {
+            return m_phrase.GetNextChar();
+        }
+
         bool IsPhraseSingle() const
         {
             return (m_phrase.Length() == 1);
@@ -89,8 +94,6 @@ namespace typing
         juzutil::Vector3 m_dir;
         float            m_angle;
     };
-    typedef std::shared_ptr<BasicEnemy> BasicEnemyPtr;
-    typedef std::vector<BasicEnemyPtr> BasicEnemyVec;
 
 
     //////////////////////////////////////////////////////////////////////////
@@ -100,14 +103,14 @@ namespace typing
     class AccelEnemy : public Entity
     {
     public:
-        AccelEnemy(const std::string& phrase, const juzutil::Vector3& origin, float startSpeed)
+        AccelEnemy(PhraseView phrase, const juzutil::Vector3& origin, float startSpeed)
             : m_phrase(phrase), m_origin(origin), m_speed(startSpeed), m_unlink(false)
         {
         }
 
         void Update();
-        void Draw2D();
-        void Draw3D();
+        void Draw2D(const juzutil::Vector2& screenOrigin);
+        void Draw3D(const juzutil::Vector3& origin);
         void OnSpawn();
         void OnCollide();
         void OnType(char c, bool *hit, bool *phraseFinished);
@@ -138,6 +141,11 @@ namespace typing
             return (GetStartChar() == c);
         }
 
+        char GetNextChar() const
+        {
+            return m_phrase.GetNextChar();
+        }
+
         bool IsPhraseSingle() const
         {
             return (m_phrase.Length() == 1);
@@ -172,8 +180,6 @@ namespace typing
         juzutil::Vector3 m_dir;
         float            m_angle;
     };
-    typedef std::shared_ptr<AccelEnemy> AccelEnemyPtr;
-    typedef std::vector<AccelEnemyPtr> AccelEnemyVec;
 
 
     //////////////////////////////////////////////////////////////////////////
@@ -183,7 +189,7 @@ namespace typing
     class Missile : public Entity
     {
     public:
-        Missile(const std::string& phrase, const juzutil::Vector3& origin)
+        Missile(PhraseView phrase, const juzutil::Vector3& origin)
             : m_phrase(phrase), m_origin(origin), m_unlink(false)
         {
         }
@@ -191,8 +197,8 @@ namespace typing
         static void Init();
 
         void Update();
-        void Draw2D();
-        void Draw3D();
+        void Draw2D(const juzutil::Vector2& screenOrigin);
+        void Draw3D(const juzutil::Vector3& origin);
         void OnSpawn();
         void OnCollide();
         void OnType(char c, bool *hit, bool *phraseFinished);
@@ -223,6 +229,11 @@ namespace typing
             return (GetStartChar() == c);
         }
 
+        char GetNextChar() const
+        {
+            return m_phrase.GetNextChar();
+        }
+
         bool IsPhraseSingle() const
         {
             return (m_phrase.Length() == 1);
@@ -257,7 +268,6 @@ namespace typing
         float            m_angle;
         
     };
-    typedef std::shared_ptr<Missile> MissilePtr;
 
 
     //////////////////////////////////////////////////////////////////////////
@@ -267,14 +277,14 @@ namespace typing
     class MissileEnemy : public Entity
     {
     public:
-        MissileEnemy(const std::string& phrase, const juzutil::Vector3& origin, const juzutil::Vector3& dir)
+        MissileEnemy(PhraseView phrase, const juzutil::Vector3& origin, const juzutil::Vector3& dir)
             : m_phrase(phrase), m_origin(origin), m_startOrigin(origin), m_dir(dir), m_unlink(false)
         {
         }
 
         void Update();
-        void Draw2D();
-        void Draw3D();
+        void Draw2D(const juzutil::Vector2& screenOrigin);
+        void Draw3D(const juzutil::Vector3& origin);
         void OnSpawn();
         void OnFinished();
         void OnType(char c, bool *hit, bool *phraseFinished);
@@ -300,6 +310,11 @@ namespace typing
             return (GetStartChar() == c);
         }
 
+        char GetNextChar() const
+        {
+            return m_phrase.GetNextChar();
+        }
+
         bool IsPhraseSingle() const
         {
             return (m_phrase.Length() == 1);
@@ -335,10 +350,8 @@ namespace typing
         juzutil::Vector3 m_dir;
         bool             m_unlink;
         float            m_angle;
-        float            m_lastFireTime;
+        double           m_lastFireTime;
     };
-    typedef std::shared_ptr<MissileEnemy> MissileEnemyPtr;
-    typedef std::vector<MissileEnemyPtr> MissileEnemyVec;
 
 
     //////////////////////////////////////////////////////////////////////////
@@ -348,14 +361,14 @@ namespace typing
     class BombEnemy : public Entity
     {
     public:
-        BombEnemy(const std::string& phrase, const juzutil::Vector3& origin)
+        BombEnemy(PhraseView phrase, const juzutil::Vector3& origin)
             : m_phrase(phrase), m_origin(origin), m_unlink(false)
         {
         }
 
         void Update();
-        void Draw2D();
-        void Draw3D();
+        void Draw2D(const juzutil::Vector2& screenOrigin);
+        void Draw3D(const juzutil::Vector3& origin);
         void OnSpawn();
         void OnType(char c, bool *hit, bool *phraseFinished);
         void OnPlayerDie();
@@ -380,6 +393,11 @@ namespace typing
             return (GetStartChar() == c);
         }
 
+        char GetNextChar() const
+        {
+            return m_phrase.GetNextChar();
+        }
+
         float GetTypingSpeed() const
         {
             return (m_phrase.GetTypingSpeed());
@@ -417,12 +435,10 @@ namespace typing
         Phrase           m_phrase;
         juzutil::Vector3 m_origin;
         bool             m_unlink;
-        float            m_spawnTime;
+        double           m_spawnTime;
         juzutil::Vector3 m_angles;
         juzutil::Vector3 m_angleSpeed;
     };
-    typedef std::shared_ptr<BombEnemy> BombEnemyPtr;
-    typedef std::vector<BombEnemyPtr> BombEnemyVec;
 
 
     //////////////////////////////////////////////////////////////////////////
@@ -432,14 +448,14 @@ namespace typing
     class SeekerEnemy : public Entity
     {
     public:
-        SeekerEnemy(const std::string& phrase, const juzutil::Vector3& origin)
+        SeekerEnemy(PhraseView phrase, const juzutil::Vector3& origin)
             : m_phrase(phrase), m_origin(origin), m_unlink(false)
         {
         }
 
         void Update();
-        void Draw2D();
-        void Draw3D();
+        void Draw2D(const juzutil::Vector2& screenOrigin);
+        void Draw3D(const juzutil::Vector3& origin);
         void OnSpawn();
         void OnType(char c, bool *hit, bool *phraseFinished);
         void OnCollide();
@@ -470,6 +486,11 @@ namespace typing
             return (GetStartChar() == c);
         }
 
+        char GetNextChar() const
+        {
+            return m_phrase.GetNextChar();
+        }
+
         float GetTypingSpeed() const
         {
             return (m_phrase.GetTypingSpeed());
@@ -508,14 +529,12 @@ namespace typing
         juzutil::Vector3 m_origin;
         juzutil::Vector3 m_dir;
         bool             m_unlink;
-        float            m_spawnTime;
+        double           m_spawnTime;
         float            m_angle;
         float            m_destAngle;
         bool             m_seeking;
         bool             m_turning;
     };
-    typedef std::shared_ptr<SeekerEnemy> SeekerEnemyPtr;
-    typedef std::vector<SeekerEnemyPtr> SeekerEnemyVec;
 }
 
 #endif // _ENEMY_H_
@@ -14,6 +14,15 @@ namespace typing
     // Max X coordinate for enemies that spawn at the top.
     const float SPAWN_TOP_MAX_X = 1100.0f;
 
+    // Returns true while an enemy spawned by a wave is still in the game.
+    // Enemies are removed from the game once they unlink, after which their
+    // handles no longer resolve.
+    static bool IsEnemyLinked(const EntityHandle& handle)
+    {
+        const Entity *ent = GAME.GetEntity(handle);
+        return (ent != NULL && !ent->Unlink());
+    }
+
 
     //////////////////////////////////////////////////////////////////////////
     // BasicEnemyWave
@@ -53,12 +62,11 @@ namespace typing
             float x = RAND.Range(SPAWN_TOP_MIN_X, SPAWN_TOP_MAX_X) *
                 (m_enemies.size() % 2 == 0 ? 1.0f : -1.0f);
 
-            BasicEnemyPtr enemy(
-                new BasicEnemy(GAME.GetPhrase(PhraseBook::PL_MEDIUM),
-                               juzutil::Vector3(x, SPAWN_TOP_Y, 0.0f),
-                               m_enemySpeed));
-            m_enemies.push_back(enemy);
-            GAME.AddEntity(enemy);
+            m_enemies.push_back(
+                GAME.SpawnEntity<BasicEnemy>(
+                                GAME.GetPhrase(PhraseBook::PL_MEDIUM),
+                                juzutil::Vector3(x, SPAWN_TOP_Y, 0.0f),
+                                m_enemySpeed));
 
             m_nextSpawnTime = GAME.GetTime() + SPAWN_GAP;
         }
@@ -70,7 +78,7 @@ namespace typing
                 std::count_if(
                     m_enemies.begin(),
                     m_enemies.end(),
-                    [](BasicEnemyPtr e) { return !e->Unlink(); }) == 0 );
+                    IsEnemyLinked) == 0 );
     }
 
 
@@ -112,12 +120,11 @@ namespace typing
             float x = RAND.Range(SPAWN_TOP_MIN_X, SPAWN_TOP_MAX_X) *
                 (m_enemies.size() % 2 == 0 ? 1.0f : -1.0f);
 
-            AccelEnemyPtr enemy(
-                new AccelEnemy(GAME.GetPhrase(PhraseBook::PL_LONG),
-                               juzutil::Vector3(x, SPAWN_TOP_Y, 0.0f),
-                               m_enemySpeed));
-            m_enemies.push_back(enemy);
-            GAME.AddEntity(enemy);
+            m_enemies.push_back(
+                GAME.SpawnEntity<AccelEnemy>(
+                                GAME.GetPhrase(PhraseBook::PL_LONG),
+                                juzutil::Vector3(x, SPAWN_TOP_Y, 0.0f),
+                                m_enemySpeed));
 
             m_nextSpawnTime = GAME.GetTime() + SPAWN_GAP;
         }
@@ -129,7 +136,7 @@ namespace typing
                 std::count_if(
                     m_enemies.begin(),
                     m_enemies.end(),
-                    [](AccelEnemyPtr e) { return !e->Unlink(); }) == 0 );
+                    IsEnemyLinked) == 0 );
     }
 
 
@@ -182,20 +189,18 @@ namespace typing
             // Project the y-coordinate of the spawn position to screen coords,
             // then unproject this y-coordinate at the edge of the screen to
             // find the world coords of the screen edge at that y-coordinate.
+            const View& view = GAME.GetView();
             juzutil::Vector2 screenCoords =
-                            GAME.GetCam().PerspectiveProject(
-                                        juzutil::Vector3(0.0f, y, 0.0f));
+                            view.Project(juzutil::Vector3(0.0f, y, 0.0f));
             screenCoords[0] = x;
-            juzutil::Vector3 start =
-                        GAME.GetCam().UnPerspectiveProject(screenCoords, 0.0f);
+            juzutil::Vector3 start = view.UnProject(screenCoords, 0.0f);
 
-            MissileEnemyPtr enemy(
-                new MissileEnemy(GAME.GetComboPhrase(2 + GAME.GetCycles(),
-                                                     PhraseBook::PL_SHORT),
-                                 start,
-                                 dir));
-            m_enemies.push_back(enemy);
-            GAME.AddEntity(enemy);
+            m_enemies.push_back(
+                GAME.SpawnEntity<MissileEnemy>(
+                                GAME.GetComboPhrase(2 + GAME.GetCycles(),
+                                                    PhraseBook::PL_SHORT),
+                                start,
+                                dir));
 
             m_nextSpawnTime = GAME.GetTime() + SPAWN_GAP;
         }
@@ -207,7 +212,7 @@ namespace typing
                 std::count_if(
                     m_enemies.begin(),
                     m_enemies.end(),
-                    [](MissileEnemyPtr e) { return !e->Unlink(); }) == 0 );
+                    IsEnemyLinked) == 0 );
     }
 
 
@@ -244,11 +249,10 @@ namespace typing
                                             SPAWN_AREA.GetMax().GetX()),
                                  RAND.Range(SPAWN_AREA.GetMin().GetY(),
                                             SPAWN_AREA.GetMax().GetY()));
-            BombEnemyPtr bombEnemy(
-                new BombEnemy(GAME.GetPhrase(PhraseBook::PL_LONG),
-                              juzutil::Vector3(org)));
-            m_enemies.push_back(bombEnemy);
-            GAME.AddEntity(bombEnemy);
+            m_enemies.push_back(
+                GAME.SpawnEntity<BombEnemy>(
+                                GAME.GetPhrase(PhraseBook::PL_LONG),
+                                juzutil::Vector3(org)));
             
             m_nextSpawnTime = GAME.GetTime() + SPAWN_GAP;
         }
@@ -260,7 +264,7 @@ namespace typing
                 std::count_if(
                     m_enemies.begin(),
                     m_enemies.end(),
-                    [](BombEnemyPtr e) { return !e->Unlink(); }) == 0 );
+                    IsEnemyLinked) == 0 );
     }
 
 
@@ -294,11 +298,10 @@ namespace typing
             float x = RAND.Range(SPAWN_TOP_MIN_X, SPAWN_TOP_MAX_X) *
                 (m_enemies.size() % 2 == 0 ? 1.0f : -1.0f);
 
-            SeekerEnemyPtr enemy(
-                new SeekerEnemy(GAME.GetPhrase(PhraseBook::PL_LONG),
+            m_enemies.push_back(
+                GAME.SpawnEntity<SeekerEnemy>(
+                                GAME.GetPhrase(PhraseBook::PL_LONG),
                                 juzutil::Vector3(x, SPAWN_TOP_Y, 0.0f)));
-            m_enemies.push_back(enemy);
-            GAME.AddEntity(enemy);
 
             m_nextSpawnTime = GAME.GetTime() + SPAWN_GAP;
         }
@@ -310,6 +313,6 @@ namespace typing
                 std::count_if(
                     m_enemies.begin(),
                     m_enemies.end(),
-                    [](SeekerEnemyPtr e) { return !e->Unlink(); }) == 0 );
+                    IsEnemyLinked) == 0 );
     }
 }
@@ -112,10 +112,10 @@ namespace typing
         bool IsFinished() const;
 
     private:
-        BasicEnemyVec m_enemies;
-        unsigned int  m_enemyCount;
-        float         m_enemySpeed;
-        float         m_nextSpawnTime;
+        EntityHandleVec m_enemies;
+        unsigned int    m_enemyCount;
+        float           m_enemySpeed;
+        double          m_nextSpawnTime;
     };
 
 
@@ -130,10 +130,10 @@ namespace typing
         bool IsFinished() const;
 
     private:
-        AccelEnemyVec m_enemies;
-        unsigned int  m_enemyCount;
-        float         m_enemySpeed;
-        float         m_nextSpawnTime;
+        EntityHandleVec m_enemies;
+        unsigned int    m_enemyCount;
+        float           m_enemySpeed;
+        double          m_nextSpawnTime;
     };
 
 
@@ -148,9 +148,9 @@ namespace typing
         bool IsFinished() const;
 
     private:
-        MissileEnemyVec m_enemies;
+        EntityHandleVec m_enemies;
         unsigned int    m_enemyCount;
-        float           m_nextSpawnTime;
+        double          m_nextSpawnTime;
     };
 
 
@@ -169,9 +169,9 @@ namespace typing
         bool IsFinished() const;
 
     private:
-        BombEnemyVec m_enemies;
-        unsigned int m_enemyCount;
-        float        m_nextSpawnTime;
+        EntityHandleVec m_enemies;
+        unsigned int    m_enemyCount;
+        double          m_nextSpawnTime;
     };
 
 
@@ -192,9 +192,9 @@ namespace typing
         static const float        SEEKERENEMYWAVE_SPAWN_Y;
         static const float        SEEKERENEMYWAVE_MAX_SPAWN_X;
 
-        SeekerEnemyVec  m_enemies;
+        EntityHandleVec m_enemies;
         unsigned int    m_enemyCount;
-        float           m_nextSpawnTime;
+        double          m_nextSpawnTime;
     };
 }
 
@@ -1,21 +1,65 @@
 #ifndef _ENTITY_H_
 #define _ENTITY_H_
 
-#include <memory>
+#include <vector>
 #include "Vector.h"
 #include "BBox.h"
 
 namespace typing
 {
     class BBox;
+    class EntityStore;
+
+    // Refers to an entity owned by the game's EntityStore. The generation
+    // is bumped each time the slot is reused, so a handle to an entity that
+    // has been removed no longer resolves.
+    struct EntityHandle
+    {
+        EntityHandle()
+            : index(INVALID_INDEX), generation(0)
+        {
+        }
+
+        EntityHandle(unsigned int i, unsigned int g)
+            : index(i), generation(g)
+        {
+        }
+
+        void Reset()
+        {
+            index = INVALID_INDEX;
+            generation = 0;
+        }
+
+        bool operator==(const EntityHandle& h) const
+        {
+            return (index == h.index && generation == h.generation);
+        }
+
+        bool operator!=(const EntityHandle& h) const
+        {
+            return !(*this == h);
+        }
+
+        static const unsigned int INVALID_INDEX = 0xFFFFFFFF;
+
+        unsigned int index;
+        unsigned int generation;
+    };
+    typedef std::vector<EntityHandle> EntityHandleVec;
 
     class Entity
     {
     public:
+        virtual ~Entity()
+        {
+        }
+
         virtual const juzutil::Vector3& GetOrigin()                 const = 0;
         virtual bool                    IsSolid()                   const = 0;
         virtual char                    GetStartChar()              const = 0;
         virtual bool                    StartsWith(const char c)    const = 0;
+        virtual char                    GetNextChar()               const = 0;
         virtual bool                    IsPhraseSingle()            const = 0;
         virtual float                   GetTypingSpeed()            const = 0;
         virtual bool                    Unlink()                    const = 0;
@@ -45,14 +89,18 @@ namespace typing
         // Called once a frame to render the 2D aspects of the entity's appearance.
         // This is mainly used for drawing the phrase associated with an entity.
         // Orthographic projection will already have been set up before this is
-        // called.
-        virtual void Draw2D()
+        // called, and screenOrigin is the entity's origin projected into screen
+        // coordinates for this frame.
+        virtual void Draw2D(const juzutil::Vector2& screenOrigin)
         {
         }
 
         // Draw3D
         // Called once a frame to render the 3D aspects of the entity's appearance.
-        virtual void Draw3D()
+        // The game updates at a fixed rate rather than once a frame, so origin
+        // is where the entity should be drawn this frame, part way between its
+        // origin before and after the last update.
+        virtual void Draw3D(const juzutil::Vector3& origin)
         {
         }
 
@@ -84,9 +132,32 @@ namespace typing
         {
             return 0;
         }
+
+        EntityHandle GetHandle() const
+        {
+            return m_handle;
+        }
+
+        // SavePrevOrigin
+        // Called by the game before each update, to remember where the
+        // entity was drawn from.
+        void SavePrevOrigin()
+        {
+            m_prevOrigin = GetOrigin();
+        }
+
+        const juzutil::Vector3& GetPrevOrigin() const
+        {
+            return m_prevOrigin;
+        }
+
+    private:
+        friend class EntityStore;
+
+        // Members
+        EntityHandle     m_handle;
+        juzutil::Vector3 m_prevOrigin;
     };
-    typedef std::shared_ptr<Entity> EntityPtr;
-    typedef std::weak_ptr<Entity>   EntityWeakPtr;
 }
 
 #endif // _ENTITY_H_
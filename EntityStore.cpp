@@ -0,0 +1,77 @@
+#include "EntityStore.h"
+
+namespace typing
+{
+    EntityStore::EntityStore()
+    {
+    }
+
+
+    EntityStore::~EntityStore()
+    {
+        Clear();
+    }
+
+
+    Entity *EntityStore::Get(const EntityHandle& handle) const
+    {
+        if (handle.index >= m_slots.size()) {
+            return NULL;
+        }
+
+        const Slot& slot = m_slots[handle.index];
+        if (slot.generation != handle.generation) {
+            return NULL;
+        }
+
+        return slot.ent;
+    }
+
+
+    void EntityStore::Clear()
+    {
+        for (EntityVec::iterator iter = m_live.begin(); iter != m_live.end(); ++iter)
+        {
+            Remove(*iter);
+        }
+
+        m_live.clear();
+    }
+
+
+    void EntityStore::Insert(Entity *ent, Pools::PoolBase *pool)
+    {
+        unsigned int index;
+        if (m_freeSlots.empty()) {
+            Slot slot = { NULL, NULL, 0 };
+            index = static_cast<unsigned int>(m_slots.size());
+            m_slots.push_back(slot);
+        } else {
+            index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+
+        Slot& slot = m_slots[index];
+        slot.ent  = ent;
+        slot.pool = pool;
+
+        ent->m_handle = EntityHandle(index, slot.generation);
+        m_live.push_back(ent);
+    }
+
+
+    void EntityStore::Remove(Entity *ent)
+    {
+        const unsigned int index = ent->m_handle.index;
+        Slot& slot = m_slots[index];
+
+        // Bump the generation so that any handles to the entity stop
+        // resolving, before the slot is reused.
+        slot.generation++;
+        slot.pool->Destroy(ent);
+        slot.ent  = NULL;
+        slot.pool = NULL;
+
+        m_freeSlots.push_back(index);
+    }
+}
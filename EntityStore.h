@@ -0,0 +1,95 @@
+#ifndef _ENTITY_STORE_H_
+#define _ENTITY_STORE_H_
+
+#include <utility>
+#include <vector>
+#include "Entity.h"
+#include "TypedPool.h"
+
+namespace typing
+{
+    // Owns every entity in the game. Each type of entity is kept in its own
+    // pool, so entities are packed together with others of the same type
+    // and spawning doesn't allocate once the pools have grown. Entities are
+    // referred to from outside the store by handle, which stops resolving
+    // once the entity has been removed.
+    class EntityStore
+    {
+    public:
+        // Ctors/Dtors
+        EntityStore();
+        ~EntityStore();
+
+        // Methods
+        template<typename T, typename... Args> T *Create(Args&&... args)
+        {
+            Pools::Pool<T>& pool = m_pools.Get<T>();
+            T *ent = pool.Create(std::forward<Args>(args)...);
+            Insert(ent, &pool);
+            return ent;
+        }
+
+        Entity *Get(const EntityHandle& handle) const;
+        void    Clear();
+
+        // Compact
+        // Removes every entity that wants to be unlinked. The remaining
+        // entities keep their order.
+        void Compact()
+        {
+            EntityVec::iterator out = m_live.begin();
+            for (EntityVec::iterator iter = m_live.begin(); iter != m_live.end(); ++iter)
+            {
+                if ((*iter)->Unlink()) {
+                    Remove(*iter);
+                } else {
+                    *out++ = *iter;
+                }
+            }
+
+            m_live.erase(out, m_live.end());
+        }
+
+        // Entities are indexed in the order they were spawned. Entities
+        // created while iterating are added to the end.
+        unsigned int Count() const
+        {
+            return static_cast<unsigned int>(m_live.size());
+        }
+
+        Entity *operator[](unsigned int index) const
+        {
+            return m_live[index];
+        }
+
+    private:
+        // Ctors/Dtors
+        EntityStore(const EntityStore& store);
+
+        // Typedefs
+        typedef TypedPools<Entity> Pools;
+
+        struct Slot
+        {
+            Entity          *ent;
+            Pools::PoolBase *pool;
+            unsigned int     generation;
+        };
+
+        typedef std::vector<Slot>         SlotVec;
+        typedef std::vector<unsigned int> IndexVec;
+        typedef std::vector<Entity *>     EntityVec;
+
+        // Methods
+        void Insert(Entity *ent, Pools::PoolBase *pool);
+        void Remove(Entity *ent);
+
+        // Members
+        Pools     m_pools;
+        SlotVec   m_slots;
+        IndexVec  m_freeSlots;
+        EntityVec m_live;
+    };
+}
+
+#endif // _ENTITY_STORE_H_
@@ -5,8 +5,9 @@
 #include "TextureManager.h"
 #include "SoundManager.h"
 #include "Utils.h"
-#include "Shape.h"
-#include "Random.h"
+#include "ParticleSystem.h"
+#include "Profiler.h"
+#include "RenderState.h"
 
 namespace typing
 {
@@ -22,28 +23,19 @@ namespace typing
     const float       Explosion::FLARE_START_ALPHA  = 1.0f;
     const float       Explosion::FLARE_ALPHA_FADE   = 7.0f;
 
+    static SoundHandle   s_explosionSound;
+    static TextureHandle s_flareTexture;
+
     void Explosion::Init()
     {
-        SOUNDS.Add(EXPLOSION_SOUND);
-        TEXTURES.Add(FLARE_TEXTURE);
+        s_explosionSound = SOUNDS.Add(EXPLOSION_SOUND);
+        s_flareTexture   = TEXTURES.Add(FLARE_TEXTURE);
     }
 
 
     Explosion::Explosion(const juzutil::Vector3& origin, const ColourRGBA& colour)
-        : m_origin(origin), m_colour(colour), m_age(0.0f), m_fadeSpeed(colour.GetAlpha() / LIFETIME)
+        : m_origin(origin), m_colour(colour), m_age(0.0f)
     {
-        for(unsigned int i = 0; i < FRAGMENTS; ++i)
-        {
-            m_fragments[i].m_origin = origin;
-            m_fragments[i].m_dir[0] = RAND.Range(-0.5f, 0.5f);
-            m_fragments[i].m_dir[1] = RAND.Range(-0.5f, 0.5f);
-            m_fragments[i].m_dir[2] = RAND.Range(-0.5f, 0.5f);
-            m_fragments[i].m_dir.Normalize();
-
-            m_fragments[i].m_speed = START_SPEED;
-            m_fragments[i].m_accel = ACCEL;
-            m_fragments[i].m_alpha = START_ALPHA;
-        }
     }
 
     bool Explosion::Unlink()
@@ -59,27 +51,12 @@ namespace typing
     void Explosion::Update()
     {
         m_age += GAME.GetFrameTime();
-
-        for(unsigned int i = 0; i < FRAGMENTS; ++i)
-        {
-            m_fragments[i].m_origin += m_fragments[i].m_dir * m_fragments[i].m_speed * GAME.GetFrameTime();
-            m_fragments[i].m_speed  += m_fragments[i].m_accel * GAME.GetFrameTime();
-            m_fragments[i].m_alpha  -= m_fadeSpeed * GAME.GetFrameTime();
-        }
     }
 
 
     void Explosion::Draw()
     {
-        for(unsigned int i = 0; i < FRAGMENTS; ++i)
-        {
-            glPushMatrix();
-                glTranslatef(m_fragments[i].m_origin[0], m_fragments[i].m_origin[1], m_fragments[i].m_origin[2]);
-                glScalef(FRAGMENT_SIZE, FRAGMENT_SIZE, FRAGMENT_SIZE);
-                DrawCube(ColourRGBA(m_colour.ToRGB(), m_fragments[i].m_alpha));
-            glPopMatrix();
-        }
-
+        const Camera& cam = GAME.GetCam();
         const float flareSize = FLARE_START_SIZE + m_age * FLARE_EXPAND_SPEED;
         const float alpha = FLARE_START_ALPHA - m_age * FLARE_ALPHA_FADE;
 
@@ -87,23 +64,25 @@ namespace typing
             glTranslatef(m_origin[0], m_origin[1], m_origin[2]);
             glScalef(flareSize, flareSize, flareSize);
 
-            TEXTURES.Bind(FLARE_TEXTURE);
-            glColor4f(1.0f, 1.0f, 1.0f, alpha);
+            RENDERSTATE.Enable(GL_TEXTURE_2D);
+            TEXTURES.Bind(s_flareTexture);
+            RENDERSTATE.Colour(1.0f, 1.0f, 1.0f, alpha);
 
+            PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
             glBegin(GL_QUADS);
-                juzutil::Vector3 vertex = (-GAME.GetCam().GetRight() - GAME.GetCam().GetUp()) / 2.0f;
+                juzutil::Vector3 vertex = (-cam.GetRight() - cam.GetUp()) / 2.0f;
                 glTexCoord2f(0.0f, 0.0f);
                 glVertex3f(vertex[0], vertex[1], vertex[2]);
 
-                vertex += GAME.GetCam().GetRight();
+                vertex += cam.GetRight();
                 glTexCoord2f(0.0f, 1.0f);
                 glVertex3f(vertex[0], vertex[1], vertex[2]);
 
-                vertex += GAME.GetCam().GetUp();
+                vertex += cam.GetUp();
                 glTexCoord2f(1.0f, 1.0f);
                 glVertex3f(vertex[0], vertex[1], vertex[2]);
 
-                vertex -= GAME.GetCam().GetRight();
+                vertex -= cam.GetRight();
                 glTexCoord2f(1.0f, 0.0f);
                 glVertex3f(vertex[0], vertex[1], vertex[2]);
             glEnd();
@@ -113,6 +92,16 @@ namespace typing
 
     void Explosion::OnSpawn()
     {
-        SOUNDS.Play(EXPLOSION_SOUND);
+        SOUNDS.Play(s_explosionSound);
+
+        ParticleBurst burst;
+        burst.colour    = m_colour.ToRGB();
+        burst.size      = FRAGMENT_SIZE;
+        burst.speed     = START_SPEED;
+        burst.accel     = ACCEL;
+        burst.alpha     = START_ALPHA;
+        burst.fadeSpeed = m_colour.GetAlpha() / LIFETIME;
+        burst.lifetime  = LIFETIME;
+        GAME.GetParticles().Burst(m_origin, burst, FRAGMENTS);
     }
 }
@@ -9,15 +9,8 @@
 
 namespace typing
 {
-    struct ExplosionFragment
-    {
-        juzutil::Vector3 m_origin;
-        juzutil::Vector3 m_dir;
-        float            m_speed;
-        float            m_accel;
-        float            m_alpha;
-    };
-
+    // The fragments of an explosion are handed to the game's particle system
+    // when it spawns, the explosion itself just draws the flare.
     class Explosion : public Effect
     {
     public:
@@ -48,11 +41,8 @@ namespace typing
         // Members
         juzutil::Vector3  m_origin;
         ColourRGBA        m_colour;
-        ExplosionFragment m_fragments[FRAGMENTS];
         float             m_age;
-        float             m_fadeSpeed;
     };
-    typedef std::shared_ptr<Explosion> ExplosionPtr;
 }
 
 #endif // _EXPLOSION_H_
@@ -1,10 +1,13 @@
 #include <stdio.h>
+#include <algorithm>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_opengl.h>
 #include <boost/algorithm/string/find.hpp>
 #include "FontManager.h"
 #include "Exceptions.h"
 #include "TextureManager.h"
+#include "Profiler.h"
+#include "RenderState.h"
 
 namespace typing
 {
@@ -69,7 +72,18 @@ namespace typing
             throw FileCorruptException(fileName + ": Invalid font file (char height)");
         }
 
-        m_charMap.clear();
+        std::fill(m_glyphs, m_glyphs + GLYPH_COUNT, Glyph());
+        std::fill(m_advances, m_advances + GLYPH_COUNT, 0.0f);
+        std::fill(m_hasGlyph, m_hasGlyph + GLYPH_COUNT, false);
+
+        const float imageWidth  = static_cast<float>(m_imageWidth);
+        const float imageHeight = static_cast<float>(m_imageHeight);
+        const float charHeight  = static_cast<float>(m_charHeight);
+
+        // How far down the image the glyphs reach, to find room for the
+        // solid block below them.
+        unsigned int glyphsBottom = 0;
+
         char c;
         while(fread(&c, 1, 1, fontFile) == 1)
         {
@@ -80,7 +94,31 @@ namespace typing
                 throw FileCorruptException(fileName + ": Invalid font file (char height)");
             }
 
-            m_charMap.insert(CharMap::value_type(c, cInfo));
+            // The first entry for a char wins.
+            const unsigned char index = static_cast<unsigned char>(c);
+            if (m_hasGlyph[index])
+            {
+                continue;
+            }
+
+            Glyph& glyph = m_glyphs[index];
+            glyph.left   = static_cast<float>(cInfo.x) / imageWidth;
+            glyph.right  = static_cast<float>(cInfo.x + cInfo.width) / imageWidth;
+            glyph.top    = 1.0f - static_cast<float>(cInfo.y) / imageHeight;
+            glyph.bottom = glyph.top - charHeight / imageHeight;
+
+            m_advances[index] = static_cast<float>(cInfo.width) / charHeight;
+            m_hasGlyph[index] = true;
+
+            glyphsBottom = std::max(glyphsBottom, cInfo.y + m_charHeight);
+        }
+
+        fclose(fontFile);
+
+        if (glyphsBottom + SOLID_GAP + SOLID_SIZE > m_imageHeight ||
+            SOLID_SIZE > m_imageWidth)
+        {
+            throw FileCorruptException(fileName + ": No room in the texture for the solid block");
         }
 
         std::string dir;
@@ -91,82 +129,149 @@ namespace typing
         }
 
         m_texture = dir + textureName;
-        TEXTURES.Add(m_texture);
+        m_textureHandle = TEXTURES.Add(m_texture);
+
+        // The image is stored bottom up, so the block goes at the start of
+        // it, in the bottom left corner.
+        TEXTURES.FillSolid(m_textureHandle, 0, 0, SOLID_SIZE, SOLID_SIZE);
+        m_solidU = (SOLID_SIZE / 2.0f) / imageWidth;
+        m_solidV = (SOLID_SIZE / 2.0f) / imageHeight;
     }
 
     float Font::GetLineWidth(float h, const std::string& text) const
     {
-        float textWidth = 0.0f;
+        return GetLineWidth(h, text.data(), text.length());
+    }
 
-        for(std::string::const_iterator iter = text.begin(); iter != text.end(); ++iter)
+    float Font::GetLineWidth(float h, const char *text, std::string::size_type length) const
+    {
+        // Missing chars advance by 0, so there's no branch per char. Four
+        // running sums keep the adds independent of each other, rather than
+        // each waiting on the last.
+        const unsigned char *chars = reinterpret_cast<const unsigned char *>(text);
+        float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+
+        std::string::size_type i = 0;
+        for(; i + 4 <= length; i += 4)
         {
-            CharMap::const_iterator cInfoIter = m_charMap.find(*iter);
-            if (cInfoIter == m_charMap.end())
-            {
-                // We didn't find the char in the char map, miss it out and go onto the next letter.
-                continue;
-            }
+            sum0 += m_advances[chars[i]];
+            sum1 += m_advances[chars[i + 1]];
+            sum2 += m_advances[chars[i + 2]];
+            sum3 += m_advances[chars[i + 3]];
+        }
 
-            const CharInfo& cInfo = cInfoIter->second;
-            textWidth += h * static_cast<float>(cInfo.width) / static_cast<float>(m_charHeight);
+        for(; i < length; ++i)
+        {
+            sum0 += m_advances[chars[i]];
         }
 
-        return textWidth;
+        return h * ((sum0 + sum1) + (sum2 + sum3));
+    }
+
+    float Font::GetCharWidth(float h, char c) const
+    {
+        return h * m_advances[static_cast<unsigned char>(c)];
     }
 
     void Font::Print(float x, float y, float h, ColourRGBA col, Align align, const std::string& text) const
     {
-        const float th = static_cast<float>(m_charHeight) / static_cast<float>(m_imageHeight);
+        Print(x, y, h, col, align, text.data(), text.length());
+    }
 
+    void Font::Print(float x, float y, float h, ColourRGBA col, Align align, const char *text, std::string::size_type length) const
+    {
         if(align == ALIGN_CENTER)
         {
-            x -= GetLineWidth(h, text) / 2.0f;
+            x -= GetLineWidth(h, text, length) / 2.0f;
         }
         else if(align == ALIGN_RIGHT)
         {
-            x -= GetLineWidth(h, text);
+            x -= GetLineWidth(h, text, length);
         }
 
-        TEXTURES.Bind(m_texture);
-        glColor4f(col.GetRed(), col.GetGreen(), col.GetBlue(), col.GetAlpha());
-
-        for(std::string::const_iterator iter = text.begin(); iter != text.end(); ++iter)
+        for(const char *iter = text; iter != text + length; ++iter)
         {
-            CharMap::const_iterator cInfoIter = m_charMap.find(*iter);
-            if (cInfoIter == m_charMap.end())
+            const unsigned char index = static_cast<unsigned char>(*iter);
+            if (!m_hasGlyph[index])
             {
-                // We didn't find the char in the char map, miss it out and go onto the next letter.
+                // The font doesn't have this char, miss it out and go onto the next letter.
                 continue;
             }
 
-            const CharInfo& cInfo = cInfoIter->second;
-            const float tl        = static_cast<float>(cInfo.x) / static_cast<float>(m_imageWidth);
-            const float tt        = static_cast<float>(cInfo.y) / static_cast<float>(m_imageHeight);
-            const float tw        = static_cast<float>(cInfo.width) / static_cast<float>(m_imageWidth);
-            const float w         = h * static_cast<float>(cInfo.width) / static_cast<float>(m_charHeight);
-
-            glBegin(GL_QUADS);
-            glTexCoord2f(tl, 1.0f - tt - th); // bottom left
-            glVertex2f(x, y + h);
+            const Glyph& glyph = m_glyphs[index];
+            const float  w     = h * m_advances[index];
 
-            glTexCoord2f(tl + tw, 1.0f - tt - th); // bottom right
-            glVertex2f(x + w, y + h);
+            // The quad isn't drawn until the next Flush, so it will be drawn
+            // with whatever transform is current at that point.
+            AddGlyphVertex(x, y + h, glyph.left, glyph.bottom, col);      // bottom left
+            AddGlyphVertex(x + w, y + h, glyph.right, glyph.bottom, col); // bottom right
+            AddGlyphVertex(x + w, y, glyph.right, glyph.top, col);        // top right
+            AddGlyphVertex(x, y, glyph.left, glyph.top, col);             // top left
+            x += w;
+        }
+    }
 
-            glTexCoord2f(tl + tw, 1.0f - tt); // top right
-            glVertex2f(x + w, y);
+    void Font::PrintRect(float x, float y, float w, float h, const ColourRGBA& col) const
+    {
+        AddGlyphVertex(x, y + h, m_solidU, m_solidV, col);
+        AddGlyphVertex(x + w, y + h, m_solidU, m_solidV, col);
+        AddGlyphVertex(x + w, y, m_solidU, m_solidV, col);
+        AddGlyphVertex(x, y, m_solidU, m_solidV, col);
+    }
 
-            glTexCoord2f(tl, 1.0f - tt); // top left
-            glVertex2f(x, y);
-            glEnd();
-            x += w;
+    void Font::MirrorBatch(std::string::size_type from, float x) const
+    {
+        for (GlyphVertexVector::size_type i = from; i < m_glyphVerts.size(); ++i)
+        {
+            m_glyphVerts[i].x = 2.0f * x - m_glyphVerts[i].x;
         }
     }
 
-    bool Font::HasChar(char c)
+    void Font::AddGlyphVertex(float x, float y, float u, float v, const ColourRGBA& col) const
     {
-        return m_charMap.find(c) != m_charMap.end();
+        GlyphVertex vert;
+        vert.x = x;
+        vert.y = y;
+        vert.u = u;
+        vert.v = v;
+        vert.r = col.GetRed();
+        vert.g = col.GetGreen();
+        vert.b = col.GetBlue();
+        vert.a = col.GetAlpha();
+
+        m_glyphVerts.push_back(vert);
     }
 
+    void Font::Flush() const
+    {
+        if (m_glyphVerts.empty())
+        {
+            return;
+        }
+
+        RENDERSTATE.Enable(GL_TEXTURE_2D);
+        TEXTURES.Bind(m_textureHandle);
+
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+
+        const GlyphVertex& first = m_glyphVerts.front();
+        glVertexPointer(2, GL_FLOAT, sizeof(GlyphVertex), &first.x);
+        glTexCoordPointer(2, GL_FLOAT, sizeof(GlyphVertex), &first.u);
+        glColorPointer(4, GL_FLOAT, sizeof(GlyphVertex), &first.r);
+
+        PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
+        glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(m_glyphVerts.size()));
+
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        RENDERSTATE.InvalidateColour();
+
+        // Keep the capacity around, the next frame will need about the same.
+        m_glyphVerts.clear();
+    }
 
     //////////////////////////////////////////////////////////////////////////
     // FontManager
@@ -179,18 +284,25 @@ namespace typing
     }
 
 
-    void FontManager::Add(const std::string& fontName)
+    FontHandle FontManager::Add(const std::string& fontName)
     {
-        if (m_fontMap.find(fontName) == m_fontMap.end())
+        FontMap::const_iterator iter = m_fontMap.find(fontName);
+        if (iter != m_fontMap.end())
         {
-            FontPtr font(new Font());
-            font->Load(fontName);
-            m_fontMap[fontName] = font;
+            return iter->second;
         }
+
+        FontPtr font(new Font());
+        font->Load(fontName);
+
+        const FontHandle handle(static_cast<unsigned int>(m_fonts.size()));
+        m_fonts.push_back(font);
+        m_fontMap[fontName] = handle;
+        return handle;
     }
 
 
-    const Font& FontManager::Get(const std::string& fontName) const
+    FontHandle FontManager::GetHandle(const std::string& fontName) const
     {
         FontMap::const_iterator iter = m_fontMap.find(fontName);
         if (iter == m_fontMap.end())
@@ -199,11 +311,17 @@ namespace typing
         }
         else
         {
-            return *(iter->second);
+            return iter->second;
         }
     }
 
 
+    const Font& FontManager::Get(const std::string& fontName) const
+    {
+        return Get(GetHandle(fontName));
+    }
+
+
     float FontManager::GetLineWidth(const std::string& fontName, float h, const std::string& text) const
     {
         return Get(fontName).GetLineWidth(h, text);
@@ -214,4 +332,15 @@ namespace typing
     {
         Get(fontName).Print(x, y, h, col, align, text);
     }
+
+
+    // Fonts are flushed in name order, so that where text in different
+    // fonts overlaps, the same font is always on top.
+    void FontManager::Flush() const
+    {
+        for (FontMap::const_iterator iter = m_fontMap.begin(); iter != m_fontMap.end(); ++iter)
+        {
+            Get(iter->second).Flush();
+        }
+    }
 }
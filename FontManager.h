@@ -4,10 +4,15 @@
 #include <string>
 #include <map>
 #include <memory>
+#include <vector>
 #include "Colour.h"
+#include "AssetHandle.h"
 
 namespace typing
 {
+    class Texture;
+    typedef AssetHandle<Texture> TextureHandle;
+
     struct CharInfo
     {
         unsigned int x;
@@ -20,7 +25,7 @@ namespace typing
     public:
         // Ctors/Dtors
         Font()
-            : m_texture(""), m_imageWidth(0), m_imageHeight(0), m_charHeight(0), m_charMap()
+            : m_texture(""), m_imageWidth(0), m_imageHeight(0), m_charHeight(0), m_glyphs(), m_advances(), m_hasGlyph(), m_solidU(0.0f), m_solidV(0.0f), m_glyphVerts()
         {
         }
 
@@ -30,21 +35,91 @@ namespace typing
         // Methods
         void  Load(const std::string& fileName);
         float GetLineWidth(float h, const std::string& text) const;
+        float GetLineWidth(float h, const char *text, std::string::size_type length) const;
+        float GetCharWidth(float h, char c) const;
+
+        // Print only queues the glyphs, they are drawn in a single batch by
+        // the next call to Flush.
         void  Print(float x, float y, float h, ColourRGBA col, Align align, const std::string& text) const;
-        bool  HasChar(char c);
+        void  Print(float x, float y, float h, ColourRGBA col, Align align, const char *text, std::string::size_type length) const;
+        void  Flush() const;
+
+        // Queues a quad in a single colour along with the glyphs, drawn from
+        // a block of solid texels that Load adds to the font texture. Shapes
+        // drawn around text this way keep their order with it, without
+        // needing a flush in between.
+        void  PrintRect(float x, float y, float w, float h, const ColourRGBA& col) const;
+
+        // GetBatchSize/MirrorBatch
+        // The quads queued since GetBatchSize was called can be mirrored
+        // left to right about x, for drawing text backwards without
+        // flushing around a change of transform.
+        std::string::size_type GetBatchSize() const
+        {
+            return m_glyphVerts.size();
+        }
+
+        void  MirrorBatch(std::string::size_type from, float x) const;
+
+        bool HasChar(char c) const
+        {
+            return m_hasGlyph[static_cast<unsigned char>(c)];
+        }
 
     private:
+        // Enums
+        // The solid block is kept clear of the glyphs by a gap, so that the
+        // smaller mipmaps don't blend the two together.
+        enum { GLYPH_COUNT = 256, SOLID_SIZE = 8, SOLID_GAP = 8 };
+
+        // Where a glyph is in the font texture, worked out once when the
+        // font is loaded so that Print doesn't have to.
+        struct Glyph
+        {
+            float left, right;
+            float top, bottom;
+        };
+
+        // Interleaved vertex format for the glyph batch.
+        struct GlyphVertex
+        {
+            float x, y;
+            float u, v;
+            float r, g, b, a;
+        };
+
+        // Methods
+        void AddGlyphVertex(float x, float y, float u, float v, const ColourRGBA& col) const;
+
         // Typedefs
-        typedef std::map<char, CharInfo> CharMap;
+        typedef std::vector<GlyphVertex> GlyphVertexVector;
 
         // Members
-        std::string  m_texture;
+        std::string   m_texture;
+        TextureHandle m_textureHandle;
         unsigned int m_imageWidth;
         unsigned int m_imageHeight;
         unsigned int m_charHeight;
-        CharMap      m_charMap;
+
+        // Glyphs are looked up directly by char. Advances are kept apart
+        // from the texture coords, as a fraction of the char height, so the
+        // line width loop only touches a small table. Chars the font doesn't
+        // have advance by 0.
+        Glyph        m_glyphs[GLYPH_COUNT];
+        float        m_advances[GLYPH_COUNT];
+        bool         m_hasGlyph[GLYPH_COUNT];
+
+        // The texture coords of the middle of the solid block.
+        float        m_solidU;
+        float        m_solidV;
+
+        // Glyph quads queued by Print, waiting to be drawn by Flush. This is
+        // a draw-time cache rather than part of the font's state, hence
+        // mutable.
+        mutable GlyphVertexVector m_glyphVerts;
     };
     typedef std::shared_ptr<Font> FontPtr;
+    typedef AssetHandle<Font>     FontHandle;
 
     class FontManager
     {
@@ -53,10 +128,27 @@ namespace typing
         static FontManager& GetFontManager();
 
         // Methods
-        void        Add(const std::string& fontName);
+        FontHandle  Add(const std::string& fontName);
+        FontHandle  GetHandle(const std::string& fontName) const;
         const Font& Get(const std::string& fontName) const;
         float       GetLineWidth(const std::string& fontName, float h, const std::string& text) const;
         void        Print(const std::string& fontName, float x, float y, float h, ColourRGBA col, Font::Align align, const std::string& text) const;
+        void        Flush() const;
+
+        const Font& Get(FontHandle font) const
+        {
+            return *m_fonts[font.index];
+        }
+
+        float GetLineWidth(FontHandle font, float h, const std::string& text) const
+        {
+            return Get(font).GetLineWidth(h, text);
+        }
+
+        void Print(FontHandle font, float x, float y, float h, ColourRGBA col, Font::Align align, const std::string& text) const
+        {
+            Get(font).Print(x, y, h, col, align, text);
+        }
 
     private:
         // Ctors/Dtors
@@ -65,10 +157,12 @@ namespace typing
         }
 
         // Typedefs
-        typedef std::map <std::string, FontPtr> FontMap;
+        typedef std::map <std::string, FontHandle> FontMap;
+        typedef std::vector<FontPtr>               FontVec;
 
         // Members
         FontMap m_fontMap;
+        FontVec m_fonts;
 
         // Singleton implementation
         static std::auto_ptr<FontManager> m_singleton;
@@ -1,5 +1,5 @@
+#include <algorithm>
 #include <ctime>
-#include <functional>
 #include <random>
 #include <string>
 #include <boost/format.hpp>
@@ -24,6 +24,10 @@
 #include "Exceptions.h"
 #include "Boss.h"
 #include "Random.h"
+#include "Shape.h"
+#include "Profiler.h"
+#include "RenderState.h"
+#include "Trace.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -62,9 +66,24 @@ namespace typing
     // powerup.
     static const float SHORTEN_PHRASES_TIME = 20.0f;
 
+    // The hardest phrases handed out on the first level, as a fraction of
+    // the way from the easiest phrase in the corpus to the hardest, and how
+    // much further each level goes.
+    static const float START_PHRASE_DIFFICULTY     = 0.6f;
+    static const float PHRASE_DIFFICULTY_PER_LEVEL = 0.1f;
+
     // The maximum streak that counts towards the score multiplier.
     static const unsigned int MAX_COMBO = 4;
 
+    // The number of each type of effect to make room for up front. These are
+    // guesses rather than measurements. The pools grow past them if they need
+    // to, and the high-water marks are logged at the end of each game and
+    // printed after headless runs, so they can be sized from real games.
+    static const unsigned int EXPLOSION_POOL_SIZE      = 64;
+    static const unsigned int LASER_POOL_SIZE          = 32;
+    static const unsigned int AWARD_POOL_SIZE          = 16;
+    static const unsigned int POWERUP_EFFECT_POOL_SIZE = 4;
+
     const float       Game::FINAL_DEATH_PAUSE = 2.0f;
     const float       Game::MIN_POWERUP_SPAWN_TIME = 30.0f;
     const float       Game::MAX_POWERUP_SPAWN_TIME = 180.0f;
@@ -74,30 +93,70 @@ namespace typing
     const std::string Game::TARGET_SOUND("sounds/target.wav");
     const std::string Game::GAME_MUSIC("music/music.ogg");
 
+    thread_local Game *Game::m_threadGame = NULL;
+
     std::auto_ptr<Game> Game::m_singleton(new Game);
     Game& Game::GetGame ()
     {
-        return *(m_singleton.get());
+        return (m_threadGame ? *m_threadGame : *(m_singleton.get()));
     }
 
     Game::Game()
         : m_camera(juzutil::Vector3(0.0f, -200.0f, 500.0f),
                    juzutil::Vector3(0.0f, 200.0f, 0.0f)),
-          m_active(false)
+          m_active(false), m_music(NULL), m_backgroundList(0),
+          m_immediateBackground(false)
     {
     }
 
+    // The phrases are loaded in the background, so that the menu can come
+    // up straight away. Starting a game waits for them if they aren't ready.
     void Game::Init ()
     {
-        FONTS.Add(HUD_FONT);
-        FONTS.Add(ENDGAME_FONT);
-        SOUNDS.Add(MISS_SOUND);
-        SOUNDS.Add(TARGET_SOUND);
+        InitInstance();
+        if (APP.HasOption("phrase-stream")) {
+            m_phrases.StartStream(
+                FONTS.Get(Phrase::PHRASE_FONT),
+                APP.GetOption<std::string>("phrase-stream"),
+                APP.GetOption<unsigned int>("phrase-reservoir"),
+                APP.GetOption<float>("phrase-refresh"));
+        } else {
+            m_phrases.StartLoad(FONTS.Get(Phrase::PHRASE_FONT));
+        }
+    }
+
+
+    // Initialises a game which shares the phrases already loaded by another,
+    // for running several simulated games at once. Media is shared through
+    // the managers, so this must be called from the main thread.
+    void Game::Init (const Game& shared)
+    {
+        InitInstance();
+        m_phrases.Share(shared.m_phrases);
+    }
+
+
+    // Stops anything the game has running in the background, so that it
+    // doesn't outlive the rest of the app.
+    void Game::Shutdown ()
+    {
+        m_phrases.StopStream();
+    }
+
 
-        // Load the music
-        m_music = Mix_LoadMUS(GAME_MUSIC.c_str());
-        if (!m_music) {
-            throw FileNotFoundException(GAME_MUSIC);
+    void Game::InitInstance ()
+    {
+        m_hudFont     = FONTS.Add(HUD_FONT);
+        m_endGameFont = FONTS.Add(ENDGAME_FONT);
+        m_missSound   = SOUNDS.Add(MISS_SOUND);
+        m_targetSound = SOUNDS.Add(TARGET_SOUND);
+
+        // Load the music, there is no audio when running headless.
+        if (!APP.IsHeadless()) {
+            m_music = Mix_LoadMUS(GAME_MUSIC.c_str());
+            if (!m_music) {
+                throw FileNotFoundException(GAME_MUSIC);
+            }
         }
 
         // Initialise entities needed by the game.
@@ -111,7 +170,26 @@ namespace typing
         Missile::Init();
         ChargeBoss::Init();
 
-        m_phrases.Init(FONTS.Get(Phrase::PHRASE_FONT));
+        m_effects.Reserve<Explosion>(EXPLOSION_POOL_SIZE);
+        m_effects.Reserve<Laser>(LASER_POOL_SIZE);
+        m_effects.Reserve<PowerupActivateEffect>(POWERUP_EFFECT_POOL_SIZE);
+        m_effects2d.Reserve<Award>(AWARD_POOL_SIZE);
+
+        m_immediateBackground = APP.GetOption<bool>("immediate-background");
+        // Headless games are timed by the simulation rather than by ticks,
+        // so only games played for real can be recorded.
+        if (APP.HasOption("record-replay") && !APP.IsHeadless()) {
+            m_replayFile = APP.GetOption<std::string>("record-replay");
+        }
+        if (!APP.IsHeadless()) {
+            BuildBackground();
+        }
+
+        // Set up the view from the window size, so that waves created before
+        // the first frame is drawn can still project to the screen.
+        m_camera.UpdateView(glm::vec4(0.0f, 0.0f,
+                                      static_cast<float>(APP.GetScreenWidth()),
+                                      static_cast<float>(APP.GetScreenHeight())));
 
         // Initialise the wave creator, setting the minimum level that each
         // wave can be used at.
@@ -134,15 +212,29 @@ namespace typing
 
 
     void Game::StartNewGame ()
+    {
+        StartNewGame(static_cast<unsigned int>(std::time(0)));
+    }
+
+
+    void Game::StartNewGame (unsigned int seed)
     {
         const int MUSIC_FADE_IN_TIME = 2000;
 
+        // Only the latest game is kept, so save the last one before it is
+        // replaced.
+        StopRecording();
+
+        m_phrases.WaitForLoad();
         m_phrases.MakeAllCharsAvail();
         m_phrases.UseNormalPhrases();
 
-        m_entities.clear();
-        m_effects.clear();
-        m_effects2d.clear();
+        m_entities.Clear();
+        std::fill(m_startCharEnts, m_startCharEnts + START_CHAR_COUNT,
+                  EntityHandle());
+        m_effects.Clear();
+        m_effects2d.Clear();
+        m_particles.Clear();
         m_activeWaves.clear();
 
         Pause(false);
@@ -153,6 +245,7 @@ namespace typing
 
         m_level         = 0; 
         m_nextLevelTime = LEVEL_TIME;
+        UpdatePhraseDifficulty();
         m_gameEndTime   = 0.0f;
         m_score         = 0;
         m_streakValid   = false;
@@ -169,9 +262,13 @@ namespace typing
         m_usedLives   = 0;
         m_maxStreak   = 0;
         
-        RAND.Seed(static_cast<unsigned int>(std::time(0)));
+        RAND.Seed(seed);
+
+        if (!m_replayFile.empty()) {
+            m_replay.Record(seed, APP.GetTicks(), App::TICK_RATE);
+        }
 
-        m_targetEnt.reset();
+        m_targetEnt.Reset();
 
         m_nextWaveTime      = GAME_START_WAVE_PAUSE;
         m_bossWavePending   = false;
@@ -182,7 +279,9 @@ namespace typing
         m_nextPowerupTime = RAND.Range(MIN_POWERUP_SPAWN_TIME,
                                        MAX_POWERUP_SPAWN_TIME);
 
-        Mix_FadeInMusic(m_music, -1, MUSIC_FADE_IN_TIME);
+        if (m_music) {
+            Mix_FadeInMusic(m_music, -1, MUSIC_FADE_IN_TIME);
+        }
 
         APP.Log(App::LOG_DEBUG, "Starting new game");
     }
@@ -190,10 +289,14 @@ namespace typing
 
     void Game::SpawnEnemies()
     {
+        TraceScope trace("Game::SpawnEnemies");
+
         // Work out whether we have waited long enough to start a new wave.
         // Don't spawn anything if a boss wave is pending or in progress.
         if (GetTime() >= m_nextWaveTime &&
             !m_bossWavePending && !m_bossWaveActive) {
+            TRACE.Instant("wave_start");
+
             EnemyWavePtr wave = m_waveCreator.CreateWave(m_level);
             wave->Start();
             m_activeWaves.push_back(wave);
@@ -212,6 +315,7 @@ namespace typing
         if (m_bossWavePending && !m_bossWaveActive &&
             m_activeWaves.size() == 0) {
             m_bossWaveStartTime = GetTime();
+            TRACE.Instant("boss_spawn");
 
             EnemyWavePtr wave = m_bossWaveCreator.CreateWave();
             wave->Start();
@@ -240,6 +344,8 @@ namespace typing
                 if (m_bossWaveActive) {
                     m_bossWaveActive = false;
                     m_level++;
+                    UpdatePhraseDifficulty();
+                    TRACE.Instant("level_up");
                     m_nextLevelTime = GetTime() + LEVEL_TIME;
                 }
             } else {
@@ -272,9 +378,9 @@ namespace typing
         if (GetTime() >= m_nextPowerupTime) {
             // Skip the powerup if a boss is active. Sorry!
             if (!m_bossWaveActive) {
-                AddEntity(m_powerups.Create(
+                m_powerups.Create(
                     juzutil::Vector2(RAND.Range(MIN_X, MAX_X),
-                                     RAND.Range(MIN_Y, MAX_Y))));
+                                     RAND.Range(MIN_Y, MAX_Y)));
             }
             m_nextPowerupTime =
                 GetTime() +
@@ -290,58 +396,47 @@ namespace typing
             return;
         }
 
+        m_replay.AddFrame(APP.GetTicks());
+
         // If the game is paused or has ended
         if (IsPaused() || HasGameEnded())
         {
             m_timer.Update();
+
+            // Nothing else can happen once the game has ended, so the
+            // replay is complete.
+            if (HasGameEnded()) {
+                StopRecording();
+            }
             return;
         }
 
-        // The game is active, update the entities.
-        for (EntityList::iterator iter = m_entities.begin(); iter != m_entities.end(); ++iter)
+        // The game is active, update the entities. Entities spawned during
+        // the update are added to the end of the store, and are updated this
+        // frame as well.
+        for (unsigned int i = 0; i < m_entities.Count(); i++)
         {
-            (*iter)->Update();
+            Entity *ent = m_entities[i];
+            ent->SavePrevOrigin();
+            ent->Update();
 
             // Check if the entity hit the player
-            if ((*iter)->IsSolid()) {
-                if ((*iter)->GetBounds().Intersects(m_player.GetBounds()))
+            if (ent->IsSolid()) {
+                if (ent->GetBounds().Intersects(m_player.GetBounds()))
                 {
-                    (*iter)->OnCollide();
-                }
-            }
-
-            // If the entity is finished, remove it from the list
-            if ((*iter)->Unlink())
-            {
-                // Check if the entity we've just unlinked was the current target
-                if ((*iter) == m_targetEnt.lock()) {
-                    m_targetEnt.reset();
-                }
-
-                iter = m_entities.erase(iter);
-
-                // If we've erased the last element in the list, we need to stop here.
-                if (iter == m_entities.end())
-                {
-                    break;
+                    ent->OnCollide();
                 }
             }
         }
 
-        for (EffectList::iterator iter = m_effects.begin(); iter != m_effects.end(); ++iter)
-        {
-            (*iter)->Update();
+        // Remove the finished entities now that every entity has updated.
+        // Handles to them, including the current target, stop resolving.
+        m_entities.Compact();
 
-            if ((*iter)->Unlink())
-            {
-                iter = m_effects.erase(iter);
+        m_effects.Update();
+        m_effects2d.Update();
 
-                if (iter == m_effects.end())
-                {
-                    break;
-                }
-            }
-        }
+        m_particles.Update(GetFrameTime());
 
         if (!m_bossWaveActive && GetTime() > m_nextLevelTime) {
             // Ready to go up to the next level, but need to spawn a boss
@@ -387,19 +482,20 @@ namespace typing
         m_phrases.DrawChars(HUD_FONT, debug_y, debug_height);
         debug_y += debug_height;
         FONTS.Print(
-            HUD_FONT, 0.0f, debug_y, debug_height,
+            m_hudFont, 0.0f, debug_y, debug_height,
             ColourRGBA::White(), Font::ALIGN_LEFT,
             (boost::format("Level: %1%") % m_level).str());
         debug_y += debug_height;
         FONTS.Print(
-            HUD_FONT, 0.0f, debug_y, debug_height,
+            m_hudFont, 0.0f, debug_y, debug_height,
             ColourRGBA::White(), Font::ALIGN_LEFT,
             (boost::format("Pup: %1%") % (m_nextPowerupTime - GetTime())).str());
 #endif
 
-        glDisable(GL_TEXTURE_2D);
+        RENDERSTATE.Disable(GL_TEXTURE_2D);
 
-        glColor4f(1.0f, 1.0f, 1.0f, 0.2f);
+        RENDERSTATE.Colour(1.0f, 1.0f, 1.0f, 0.2f);
+        PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
         glBegin(GL_TRIANGLES);
             glVertex2f(0.0f,                   ORTHO_HEIGHT);
             glVertex2f(HUD_SIZE,               ORTHO_HEIGHT - HUD_SIZE);
@@ -418,19 +514,20 @@ namespace typing
             glVertex2f(ORTHO_WIDTH,            ORTHO_HEIGHT);
         glEnd();
 
-        glLineWidth(1.0f);
-        glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+        RENDERSTATE.LineWidth(1.0f);
+        RENDERSTATE.Colour(1.0f, 1.0f, 1.0f, 1.0f);
+        PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
         glBegin(GL_LINE_LOOP);
             glVertex2f(0.0f,                   ORTHO_HEIGHT);
             glVertex2f(HUD_SIZE,               ORTHO_HEIGHT - HUD_SIZE);
             glVertex2f(ORTHO_WIDTH - HUD_SIZE, ORTHO_HEIGHT - HUD_SIZE);
             glVertex2f(ORTHO_WIDTH,            ORTHO_HEIGHT);
         glEnd();
-        glLineWidth(1.0f);
 
         if (m_usedLives && (GetTime() - m_damageTime) < DAMAGE_FLASH_TIME) {
-            glColor4f(1.0f, 1.0f, 1.0f,
-                      1.0f - ((GetTime() - m_damageTime) / DAMAGE_FLASH_TIME));
+            RENDERSTATE.Colour(1.0f, 1.0f, 1.0f,
+                               1.0f - ((GetTime() - m_damageTime) / DAMAGE_FLASH_TIME));
+            PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
             glBegin(GL_QUADS);
                 glVertex2f(0.0f, ORTHO_HEIGHT);
                 glVertex2f(ORTHO_WIDTH, ORTHO_HEIGHT);
@@ -439,27 +536,25 @@ namespace typing
             glEnd();
         }
 
-        glEnable(GL_TEXTURE_2D);
-
-        FONTS.Print(HUD_FONT, HUD_LIVES_X,
+        FONTS.Print(m_hudFont, HUD_LIVES_X,
                     ORTHO_HEIGHT - HUD_NUMBER_HEIGHT - HUD_TEXT_HEIGHT,
                     HUD_TEXT_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
                     "LIVES");
-        FONTS.Print(HUD_FONT, HUD_LIVES_X, ORTHO_HEIGHT - HUD_NUMBER_HEIGHT,
+        FONTS.Print(m_hudFont, HUD_LIVES_X, ORTHO_HEIGHT - HUD_NUMBER_HEIGHT,
                     HUD_NUMBER_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
                     std::to_string(m_player.Lives()));
-        FONTS.Print(HUD_FONT, HUD_SCORE_X,
+        FONTS.Print(m_hudFont, HUD_SCORE_X,
                     ORTHO_HEIGHT - HUD_NUMBER_HEIGHT - HUD_TEXT_HEIGHT,
                     HUD_TEXT_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
                     "SCORE");
-        FONTS.Print(HUD_FONT, HUD_SCORE_X, ORTHO_HEIGHT - HUD_NUMBER_HEIGHT,
+        FONTS.Print(m_hudFont, HUD_SCORE_X, ORTHO_HEIGHT - HUD_NUMBER_HEIGHT,
                     HUD_NUMBER_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
                     std::to_string(m_score));
-        FONTS.Print(HUD_FONT, HUD_STREAK_X,
+        FONTS.Print(m_hudFont, HUD_STREAK_X,
                     ORTHO_HEIGHT - HUD_NUMBER_HEIGHT - HUD_TEXT_HEIGHT,
                     HUD_TEXT_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
                     "STREAK");
-        FONTS.Print(HUD_FONT, HUD_STREAK_X, ORTHO_HEIGHT - HUD_NUMBER_HEIGHT,
+        FONTS.Print(m_hudFont, HUD_STREAK_X, ORTHO_HEIGHT - HUD_NUMBER_HEIGHT,
                     HUD_NUMBER_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
                     std::to_string(m_streak));
 
@@ -472,16 +567,51 @@ namespace typing
                                  HUD_WARNING_BLINK_SPEED));
             ColourRGBA warningColour(ColourRGB::Red(), warningAlpha);
 
-            FONTS.Print(HUD_FONT, ORTHO_WIDTH / 2.0f, 0, HUD_WARNING_HEIGHT,
+            FONTS.Print(m_hudFont, ORTHO_WIDTH / 2.0f, 0, HUD_WARNING_HEIGHT,
                 warningColour, Font::ALIGN_CENTER, "WARNING");
-            FONTS.Print(HUD_FONT, ORTHO_WIDTH / 2.0f, HUD_WARNING_HEIGHT,
+            FONTS.Print(m_hudFont, ORTHO_WIDTH / 2.0f, HUD_WARNING_HEIGHT,
                         HUD_BOSS_APPROACH_HEIGHT,
                         warningColour, Font::ALIGN_CENTER, "BOSS APPROACHING");
         }
     }
 
 
+    void Game::BuildBackground()
+    {
+        if (m_backgroundList != 0) {
+            return;
+        }
+
+        m_backgroundList = glGenLists(1);
+        if (m_backgroundList == 0) {
+            // No display lists available, fall back to drawing the
+            // background in immediate mode every frame.
+            m_immediateBackground = true;
+            return;
+        }
+
+        glNewList(m_backgroundList, GL_COMPILE);
+        DrawBackgroundImmediate();
+        glEndList();
+    }
+
+
     void Game::DrawBackground()
+    {
+        if (m_immediateBackground) {
+            DrawBackgroundImmediate();
+        } else {
+            PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
+            glCallList(m_backgroundList);
+        }
+
+        // The background is drawn with plain GL calls, as it has to be
+        // compiled into the display list.
+        RENDERSTATE.Invalidate();
+    }
+
+
+    void Game::DrawBackgroundImmediate()
     {
         const float BACKGROUND_RING_WIDTH   = 150.0f;
         const float BACKGROUND_RING_COUNT   = 30.0f;
@@ -509,6 +639,7 @@ namespace typing
             const float green = 0.2f / (1.0f + i * 0.3f);
             glColor3f(red, green, 0.0f);
 
+            PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
             glBegin(GL_QUADS);
             glVertex3f(innerDist, 0.0f, innerZ);
             glVertex3f(outerDist, 0.0f, outerZ);
@@ -572,6 +703,7 @@ namespace typing
             glEnd();
 
             glColor3f(0.1f, 0.1f, 0.1f);
+            PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
             glBegin(GL_LINES);
             glVertex3f(innerDist * BACKGROUND_COS_THETA, innerDist * BACKGROUND_SIN_THETA, innerZ);
             glVertex3f(innerDist, 0.0f, innerZ);
@@ -677,92 +809,145 @@ namespace typing
         const float x = ORTHO_WIDTH / 2.0f;
         float y = (ORTHO_HEIGHT / 2.0f) - (SCORE_HEIGHT / 2.0f) - (GAME_OVER_HEIGHT + ITEM_SPACING);
 
-        FONTS.Print(ENDGAME_FONT, x, y, GAME_OVER_HEIGHT, ColourRGBA::Red(), Font::ALIGN_CENTER,
+        FONTS.Print(m_endGameFont, x, y, GAME_OVER_HEIGHT, ColourRGBA::Red(), Font::ALIGN_CENTER,
             "Game Over!");
         y+= GAME_OVER_HEIGHT + ITEM_SPACING;
-        FONTS.Print(ENDGAME_FONT, x, y, SCORE_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
+        FONTS.Print(m_endGameFont, x, y, SCORE_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
             (boost::format("Score - %1%") % m_score).str());
 
         if (m_timer.GetTime() - END_GAME_SCREEN_PAUSE > m_gameEndTime)
         {
             y = ORTHO_HEIGHT - CONTINUE_HEIGHT;
-            FONTS.Print(ENDGAME_FONT, x, y, CONTINUE_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
+            FONTS.Print(m_endGameFont, x, y, CONTINUE_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
                         "Press any key to continue...");
         }
     }
 
 
-    void Game::Draw ()
+    // alpha is how far the frame is between the last two updates, and
+    // entities are drawn that far between where they were and where they
+    // are now.
+    void Game::Draw (float alpha)
     {
         if (IsActive())
         {
+            // Nothing moves while the game is paused or over.
+            if (IsPaused() || HasGameEnded()) {
+                alpha = 1.0f;
+            }
+
+            m_drawOrigins.resize(m_entities.Count());
+            for (unsigned int i = 0; i < m_entities.Count(); i++)
+            {
+                const Entity           *ent  = m_entities[i];
+                const juzutil::Vector3& prev = ent->GetPrevOrigin();
+                m_drawOrigins[i] = prev + (ent->GetOrigin() - prev) * alpha;
+            }
+
+            PROFILER.SetCount(Profiler::COUNTER_ENTITIES, m_entities.Count());
+            PROFILER.SetCount(Profiler::COUNTER_EFFECTS,
+                              m_effects.Count() + m_effects2d.Count());
+
             // Set up the 3D camera for drawing the world
             m_camera.ApplyPerspective();
 
-            DrawBackground();
-
-            m_player.Draw();
+            {
+                ProfileScope profile(Profiler::ZONE_DRAW_BACKGROUND);
+                DrawBackground();
+            }
 
-            if (IsAlive())
             {
-                // If we have a current target, draw a targetting line from the
-                // player to the target.
-                EntityPtr ent = m_targetEnt.lock();
-                if (ent)
-                {
-                    glDisable(GL_TEXTURE_2D);
-                    glColor4f(1.0f, 1.0f, 1.0f, 0.2f);
+                ProfileScope profile(Profiler::ZONE_DRAW_ENTITIES);
 
-                    const juzutil::Vector3& playerOrg = m_player.GetOrigin();
-                    const juzutil::Vector3& targetOrg = ent->GetOrigin();
+                m_player.Draw();
 
-                    glBegin(GL_LINES);
-                    glVertex3f(playerOrg[0], playerOrg[1], playerOrg[2]);
-                    glVertex3f(targetOrg[0], targetOrg[1], targetOrg[2]);
-                    glEnd();
+                if (IsAlive())
+                {
+                    // If we have a current target, draw a targetting line from the
+                    // player to the target.
+                    const Entity *ent = GetEntity(m_targetEnt);
+                    if (ent)
+                    {
+                        const juzutil::Vector3& playerOrg = m_player.GetOrigin();
+                        const juzutil::Vector3  targetOrg =
+                            ent->GetPrevOrigin() +
+                            (ent->GetOrigin() - ent->GetPrevOrigin()) * alpha;
+
+                        RENDERSTATE.Disable(GL_TEXTURE_2D);
+                        RENDERSTATE.Colour(1.0f, 1.0f, 1.0f, 0.2f);
+
+                        PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
+                        glBegin(GL_LINES);
+                        glVertex3f(playerOrg[0], playerOrg[1], playerOrg[2]);
+                        glVertex3f(targetOrg[0], targetOrg[1], targetOrg[2]);
+                        glEnd();
+                    }
+                }
 
-                    glEnable(GL_TEXTURE_2D);
+                for (unsigned int i = 0; i < m_entities.Count(); i++)
+                {
+                    m_entities[i]->Draw3D(m_drawOrigins[i]);
                 }
+
+                // Draw the player and entity shapes before the particles and
+                // effects, so that explosions stay on top.
+                FlushShapes();
             }
 
-            for_each(m_entities.begin(),
-                     m_entities.end(),
-                     std::mem_fn(&Entity::Draw3D));
-            for_each(m_effects.begin(),
-                     m_effects.end(),
-                     std::mem_fn(&Effect::Draw));
-
-            // Use an orthographic projection for drawing the phrases as we
-            // want the text to appear the same size no matter where it is
-            // being drawn.
-            glMatrixMode(GL_PROJECTION);
-            glLoadIdentity();
-            glOrtho(0.0,
-                    APP.GetScreenWidth(),
-                    APP.GetScreenHeight(),
-                    0.0, -1, 1);
-            glMatrixMode(GL_MODELVIEW);
-            glLoadIdentity();
-
-            for_each(m_entities.begin(),
-                     m_entities.end(),
-                     std::mem_fn(&Entity::Draw2D));
-            for_each(m_effects2d.begin(),
-                     m_effects2d.end(),
-                     std::mem_fn(&Effect::Draw));
+            {
+                ProfileScope profile(Profiler::ZONE_DRAW_EFFECTS);
+                m_particles.Draw(alpha);
+                m_effects.Draw();
+            }
 
+            {
+                ProfileScope profile(Profiler::ZONE_DRAW_PHRASES);
+
+                // Use an orthographic projection for drawing the phrases as we
+                // want the text to appear the same size no matter where it is
+                // being drawn.
+                glMatrixMode(GL_PROJECTION);
+                glLoadIdentity();
+                glOrtho(0.0,
+                        APP.GetScreenWidth(),
+                        APP.GetScreenHeight(),
+                        0.0, -1, 1);
+                glMatrixMode(GL_MODELVIEW);
+                glLoadIdentity();
+
+                m_drawCoords.resize(m_drawOrigins.size());
+                if (!m_drawOrigins.empty())
+                {
+                    GetView().ProjectAll(&m_drawOrigins[0],
+                                         &m_drawCoords[0],
+                                         m_drawOrigins.size());
+                }
+
+                for (unsigned int i = 0; i < m_entities.Count(); i++)
+                {
+                    m_entities[i]->Draw2D(m_drawCoords[i]);
+                }
+                m_effects2d.Draw();
+
+                // Draw the phrase and award text before the HUD goes on top.
+                FONTS.Flush();
+            }
+
+            ProfileScope profile(Profiler::ZONE_DRAW_HUD);
             if (!HasGameEnded()) {
                 DrawHud();
             } else {
                 DrawEndScreen();
             }
+
+            FONTS.Flush();
         }
     }
 
     // When we've finished a phrase, decides what award to give to the player,
     // and adds it to the list to be displayed on screen.
     // The speeds are measured in chars typed per second
-    void Game::PhraseFinished(EntityPtr &ent)
+    void Game::PhraseFinished(Entity *ent)
     {
         const float  EXCELLENT_SPEED      = 0.1f;
         const float  EXCELLENT_MULTIPLIER = 2.0f;
@@ -788,10 +973,9 @@ namespace typing
             multiplier = std::max(1U, std::min(m_streak, MAX_COMBO));
         }
 
-        LaserPtr laser(new Laser(GetPlayerOrigin(),
-                                 ent->GetOrigin(),
-                                 ColourRGB::White()));
-        AddEffect(laser);
+        SpawnEffect<Laser>(GetPlayerOrigin(),
+                           ent->GetOrigin(),
+                           ColourRGB::White());
         m_player.Fire();
 
         // Don't give an award if this was only a single-char entity.
@@ -823,7 +1007,7 @@ namespace typing
 
             // Display the award on screen.
             if (!ent->SuppressAwardDisplay()) {
-                juzutil::Vector2 screenOrg = m_camera.PerspectiveProject(
+                juzutil::Vector2 screenOrg = GetView().Project(
                                                             ent->GetOrigin());
 
                 screenOrg[1] += AWARD_OFFSET;
@@ -833,8 +1017,7 @@ namespace typing
                     screenOrg[1] += AWARD_OFFSET;
                 }
 
-                AwardPtr award(new Award(screenOrg, type, GetTime()));
-                AddEffect2d(award);
+                SpawnEffect2d<Award>(screenOrg, type, GetTime());
             }
         }
 
@@ -844,6 +1027,8 @@ namespace typing
 
     void Game::OnKeyDown (SDL_Keycode keycode)
     {
+        m_replay.AddKeyDown(keycode);
+
         if (HasGameEnded()) {
             // If we are dead, and we have paused for long enough,
             // go back to the main menu on any keypress.
@@ -864,39 +1049,64 @@ namespace typing
     }
 
 
-    void Game::OnType (char c)
+    // Finds an entity whose phrase starts with c, through the start
+    // character table. The table can miss an entity that shares its start
+    // character with another, so if it has nothing the entities are
+    // searched, and whatever is found is put back in the table.
+    Entity *Game::FindStartCharEntity (char c)
     {
-        using namespace std::placeholders;
+        EntityHandle& slot = m_startCharEnts[static_cast<unsigned char>(c)];
+
+        Entity *ent = m_entities.Get(slot);
+        if (ent != NULL && ent->StartsWith(c)) {
+            return ent;
+        }
 
+        for (unsigned int i = 0; i < m_entities.Count(); i++)
+        {
+            ent = m_entities[i];
+            if (ent->StartsWith(c)) {
+                slot = ent->GetHandle();
+                return ent;
+            }
+        }
+
+        slot.Reset();
+        return NULL;
+    }
+
+
+    void Game::OnType (char c)
+    {
         bool miss = false;
 
         if (!IsActive()) {
             return;
         }
 
+        m_replay.AddType(c);
+
         if (IsAlive() && !HasGameEnded() && !IsPaused()) {            
-            EntityPtr ent = m_targetEnt.lock();
+            Entity *ent = GetEntity(m_targetEnt);
             if (!ent) {
-                // There is no target entity, look for a entity starting
+                // There is no target entity, look up the entity starting
                 // with the letter the player has typed.
-                EntityList::iterator target =
-                    find_if(m_entities.begin(), m_entities.end(),
-                            std::bind(&Entity::StartsWith, _1, c));
+                Entity *target = FindStartCharEntity(c);
 
-                if (target == m_entities.end()) {
+                if (target == NULL) {
                     // We didn't find any targets starting with the letter the
                     // player typed, this is a miss.
                     miss = true;
                 } else {
                     // We've got a new target.
-                    m_targetEnt  = *target;
-                    ent          = m_targetEnt.lock();
+                    ent          = target;
+                    m_targetEnt  = ent->GetHandle();
 
                     // Don't want to play the target sound if this entity's
                     // phrase is a single letter, as we are killing it
                     // immediately.
                     if (!ent->IsPhraseSingle()) {
-                        SOUNDS.Play(TARGET_SOUND);
+                        SOUNDS.Play(m_targetSound);
                     }
 
                     m_streakValid = true;
@@ -917,7 +1127,7 @@ namespace typing
                         PhraseFinished(ent);
                     }
 
-                    m_targetEnt.reset();
+                    m_targetEnt.Reset();
                 }
             }
 
@@ -925,7 +1135,7 @@ namespace typing
                 m_misses++;
                 m_streakValid = false;
                 m_streak      = 0;
-                SOUNDS.Play(MISS_SOUND);
+                SOUNDS.Play(m_missSound);
             } else {
                 m_hits++;
             }
@@ -934,30 +1144,81 @@ namespace typing
 
     void Game::Damage()
     {
+        TraceScope trace("Game::Damage");
+
         if (m_player.Lives() > 0) {
+            TRACE.Instant("player_damage");
+
             m_player.Damage();
             m_usedLives++;
             m_damageTime = GetTime();
 
-            for_each(m_entities.begin(),
-                     m_entities.end(),
-                     std::mem_fn(&Entity::OnPlayerDie));
+            for (unsigned int i = 0; i < m_entities.Count(); i++)
+            {
+                m_entities[i]->OnPlayerDie();
+            }
 
             if (m_player.Lives() == 0) {
-                ExplosionPtr explosion(
-                    new Explosion(GetPlayerOrigin(), ColourRGBA::Red()));
-                AddEffect(explosion);
+                SpawnEffect<Explosion>(GetPlayerOrigin(), ColourRGBA::Red());
                 EndGame(FINAL_DEATH_PAUSE);
             }
         }
     }
 
 
+    // Resume and Quit are how the pause menu controls the game, and are
+    // recorded so that a replay can do the same.
+    void Game::Resume()
+    {
+        m_replay.AddResume();
+        Pause(false);
+    }
+
+
+    void Game::Quit()
+    {
+        m_replay.AddQuit();
+        Pause(false);
+        EndGame();
+    }
+
+
+    void Game::StopRecording()
+    {
+        if (m_replay.IsRecording()) {
+            m_replay.Save(m_replayFile);
+        }
+    }
+
+
     void Game::EndGame(float pause)
     {
         const float MUSIC_FADE_OUT_TIME = 2.0f;
         m_gameEndTime = GetTime() + pause;
-        Mix_FadeOutMusic(static_cast<int>((pause + MUSIC_FADE_OUT_TIME) * 1000));
+        if (m_music) {
+            Mix_FadeOutMusic(static_cast<int>((pause + MUSIC_FADE_OUT_TIME) * 1000));
+        }
+
+        // Headless runs print the pools once, after all of the games.
+        if (!APP.IsHeadless()) {
+            LogEffectPoolStats();
+        }
+    }
+
+
+    void Game::LogEffectPoolStats() const
+    {
+        PoolStatsVec stats;
+        GetEffectPoolStats(stats);
+
+        for (PoolStatsVec::const_iterator iter = stats.begin(); iter != stats.end(); ++iter)
+        {
+            APP.Log(App::LOG_INFO,
+                    boost::str(boost::format(
+                        "Effect pool %1%: %2% live, %3% high-water, %4% capacity")
+                        % iter->name % iter->live % iter->highWater
+                        % iter->capacity));
+        }
     }
 
 
@@ -966,4 +1227,16 @@ namespace typing
         m_shortenPhrasesTime = GetTime();
         m_phrases.UseShortPhrases();
     }
+
+
+    // Lets harder phrases in as the levels go up. The easiest phrases are
+    // always allowed, so later levels are a mix rather than all hard.
+    void Game::UpdatePhraseDifficulty()
+    {
+        m_phrases.SetDifficulty(
+            0.0f,
+            std::min(START_PHRASE_DIFFICULTY +
+                         PHRASE_DIFFICULTY_PER_LEVEL * m_level,
+                     1.0f));
+    }
 }
@@ -2,11 +2,12 @@
 #define _GAME_H_
 
 #include <memory>
-#include <list>
 #include <string>
+#include <utility>
 #include <vector>
 #include <SDL2/SDL_mixer.h>
 #include "Entity.h"
+#include "EntityStore.h"
 #include "Timer.h"
 #include "Player.h"
 #include "Vector.h"
@@ -15,9 +16,13 @@
 #include "EnemyWave.h"
 #include "Powerup.h"
 #include "Effect.h"
+#include "EffectStore.h"
 #include "Camera.h"
 #include "Utils.h"
 #include "SoundManager.h"
+#include "FontManager.h"
+#include "ParticleSystem.h"
+#include "Replay.h"
 
 namespace typing
 {
@@ -26,31 +31,95 @@ namespace typing
     public:
         // Methods
         void Init();
+        void Init(const Game& shared);
+        void Shutdown();
         void Update();
-        void Draw();
+        void Draw(float alpha);
         void OnKeyDown(SDL_Keycode keycode);
         void OnType(char c);
         void StartNewGame();
+        void StartNewGame(unsigned int seed);
+        void Resume();
+        void Quit();
+        void StopRecording();
         void Damage();
         void EndGame(float pause = 0);
         void StartShortenPhrases();
 
-        void AddEntity(const EntityPtr& ent)
+        // SpawnEntity
+        // Creates an entity in the entity store and adds it to the game.
+        template<typename T, typename... Args>
+        EntityHandle SpawnEntity(Args&&... args)
         {
+            T *ent = m_entities.Create<T>(std::forward<Args>(args)...);
             ent->OnSpawn();
-            m_entities.push_back(ent);
+            ent->SavePrevOrigin();
+            IndexEntity(ent);
+            return ent->GetHandle();
         }
 
-        void AddEffect(const EffectPtr& effect)
+        // GetEntity
+        // Returns the entity referred to by a handle, or NULL if the entity
+        // has been removed from the game.
+        Entity *GetEntity(const EntityHandle& handle) const
         {
-            effect->OnSpawn();
-            m_effects.push_back(effect);
+            return m_entities.Get(handle);
         }
 
-        void AddEffect2d(const EffectPtr& effect)
+        const EntityStore& GetEntities() const
         {
-            effect->OnSpawn();
-            m_effects2d.push_back(effect);
+            return m_entities;
+        }
+
+        // GetTarget
+        // Returns the entity the player is currently typing, if any.
+        const Entity *GetTarget() const
+        {
+            return GetEntity(m_targetEnt);
+        }
+
+        bool HasGameEnded() const
+        {
+            return (m_gameEndTime != 0.0f && GetTime() >= m_gameEndTime);
+        }
+
+        // IndexEntity
+        // Records the entity against the start character of its phrase, so
+        // that it can be found when that character is typed. Must be called
+        // again whenever an entity resets its phrase. Start characters are
+        // not always unique, so OnType falls back to searching the entities
+        // when the table has nothing for a character.
+        void IndexEntity(Entity *ent)
+        {
+            const char c = ent->GetStartChar();
+            if (c != '\0') {
+                m_startCharEnts[static_cast<unsigned char>(c)] = ent->GetHandle();
+            }
+        }
+
+        // SpawnEffect
+        // Creates an effect drawn in the world, after the entities.
+        template<typename T, typename... Args>
+        void SpawnEffect(Args&&... args)
+        {
+            m_effects.Create<T>(std::forward<Args>(args)...)->OnSpawn();
+        }
+
+        // SpawnEffect2d
+        // Creates an effect drawn on the screen, over the entity phrases.
+        template<typename T, typename... Args>
+        void SpawnEffect2d(Args&&... args)
+        {
+            m_effects2d.Create<T>(std::forward<Args>(args)...)->OnSpawn();
+        }
+
+        // GetEffectPoolStats
+        // Gets the usage of the pool for each type of effect, for sizing
+        // the pools.
+        void GetEffectPoolStats(PoolStatsVec& stats) const
+        {
+            m_effects.GetPoolStats(stats);
+            m_effects2d.GetPoolStats(stats);
         }
 
         void Pause(bool pause)
@@ -79,7 +148,7 @@ namespace typing
             return m_player.GetOrigin();
         }
 
-        float GetTime() const
+        double GetTime() const
         {
             return m_timer.GetTime();
         }
@@ -94,7 +163,7 @@ namespace typing
             return m_level;
         }
 
-        const std::string& GetPhrase(PhraseBook::PhraseLength len)
+        PhraseView GetPhrase(PhraseBook::PhraseLength len)
         {
             return m_phrases.GetPhrase(len);
         }
@@ -105,9 +174,19 @@ namespace typing
             return m_phrases.GetComboPhrase(words, len);
         }
 
-        void MakeCharAvail(char c)
+        // MakeCharAvail
+        // Called by an entity when it has finished with the start character
+        // of its phrase. The character's slot is only cleared if it still
+        // belongs to that entity, as the fallback "default" phrase can give
+        // several entities the same start character.
+        void MakeCharAvail(const Entity *ent, char c)
         {
             m_phrases.MakeCharAvail(c);
+
+            EntityHandle& slot = m_startCharEnts[static_cast<unsigned char>(c)];
+            if (slot == ent->GetHandle()) {
+                slot.Reset();
+            }
         }
 
         unsigned int GetScore() const
@@ -120,11 +199,21 @@ namespace typing
             return m_maxStreak;
         }
 
-        const Camera GetCam() const
+        const Camera& GetCam() const
         {
             return m_camera;
         }
 
+        const View& GetView() const
+        {
+            return m_camera.GetView();
+        }
+
+        ParticleSystem& GetParticles()
+        {
+            return m_particles;
+        }
+
         void AddExtraLife()
         {
             m_player.ExtraLife();
@@ -135,10 +224,23 @@ namespace typing
             return m_bossWaveCreator.Cycles();
         }
 
+        // SetThreadGame
+        // Makes GAME refer to game on the calling thread, so that several
+        // games can be simulated at once. Passing NULL goes back to the
+        // singleton.
+        static void SetThreadGame(Game *game)
+        {
+            m_threadGame = game;
+        }
+
         // Singleton implementation
         static Game& GetGame();
 
     private:
+        // Friends
+        // Simulation contexts create extra games of their own.
+        friend class SimContext;
+
         // Constants/Enums
         static const unsigned int GAME_START_LIVES        = 3;
         static const unsigned int END_GAME_SCREEN_PAUSE   = 1;
@@ -158,37 +260,53 @@ namespace typing
         Game(const Game& g);
 
 
+        // Consts/Enums
+        static const unsigned int START_CHAR_COUNT = 256;
+
+
         // Typedefs
-        typedef std::list<EntityPtr>      EntityList;
-        typedef std::list<EffectPtr>      EffectList;
         typedef std::vector<EnemyWavePtr> WaveVec;
 
 
         // Methods
+        void                   InitInstance();
         void                   SpawnEnemies();
         void                   SpawnPowerups();
         void                   DrawHud();
+        void                   BuildBackground();
         void                   DrawBackground();
+        void                   DrawBackgroundImmediate();
         void                   DrawEndScreen();
-        void                   PhraseFinished(EntityPtr &ent);
+        void                   PhraseFinished(Entity *ent);
+        Entity                *FindStartCharEntity(char c);
+        void                   LogEffectPoolStats() const;
+        void                   UpdatePhraseDifficulty();
 
         bool IsAlive() const
         {
             return (m_player.Lives() > 0);
         }
 
-        bool HasGameEnded() const
-        {
-            return (m_gameEndTime != 0.0f && GetTime() >= m_gameEndTime);
-        }
 
         // Members
         Camera                       m_camera;
-        EntityList                   m_entities;
-        EntityWeakPtr                m_targetEnt;
+        EntityStore                  m_entities;
+
+        // Scratch space for projecting the entity origins to the screen in
+        // one pass before the 2D draw, kept between frames.
+        std::vector<juzutil::Vector3> m_drawOrigins;
+        std::vector<juzutil::Vector2> m_drawCoords;
+        EntityHandle                 m_targetEnt;
+
+        // The entity using each start character, if any. PhraseBook makes
+        // sure that active start characters are unique, so this lets a new
+        // target be found without searching the entity list. Entries for
+        // entities that have since been removed stop resolving.
+        EntityHandle                 m_startCharEnts[START_CHAR_COUNT];
         Player                       m_player;
-        EffectList                   m_effects;
-        EffectList                   m_effects2d;
+        EffectStore                  m_effects;
+        EffectStore                  m_effects2d;
+        ParticleSystem               m_particles;
         bool                         m_streakValid;
         bool                         m_active;
         bool                         m_paused;
@@ -196,26 +314,38 @@ namespace typing
         Timer                        m_timer;
         unsigned int                 m_score;
         unsigned int                 m_streak;
-        float                        m_gameEndTime;
+        double                       m_gameEndTime;
         PhraseBook                   m_phrases;
         Mix_Music                   *m_music;
+        FontHandle                   m_hudFont;
+        FontHandle                   m_endGameFont;
+        SoundHandle                  m_missSound;
+        SoundHandle                  m_targetSound;
         PowerupFactory               m_powerups;
-        float                        m_nextPowerupTime;
+        Replay                       m_replay;
+        std::string                  m_replayFile;
+        double                       m_nextPowerupTime;
         unsigned int                 m_level;
-        float                        m_nextLevelTime;
-        float                        m_damageTime;
-        float                        m_shortenPhrasesTime;
+        double                       m_nextLevelTime;
+        double                       m_damageTime;
+        double                       m_shortenPhrasesTime;
+
+        // The background never changes, so it is compiled into a display
+        // list at start up. The immediate mode path is kept so the two can
+        // be compared.
+        unsigned int                 m_backgroundList;
+        bool                         m_immediateBackground;
 
         // Enemy spawn variables
         RandomEnemyWaveFactory       m_waveCreator;
         WaveVec                      m_activeWaves;
-        float                        m_nextWaveTime;
+        double                       m_nextWaveTime;
 
         CyclicEnemyWaveFactory       m_bossWaveCreator;
         WaveVec                      m_bossWaves;
         WaveVec::size_type           m_nextBossWaveIndex;
         bool                         m_bossWavePending;
-        float                        m_bossWaveStartTime;
+        double                       m_bossWaveStartTime;
         bool                         m_bossWaveActive;
 
         // Stats
@@ -229,6 +359,8 @@ namespace typing
         unsigned int                 m_usedLives;
         unsigned int                 m_maxStreak;
 
+        static thread_local Game    *m_threadGame;
+
         // Singleton implementation
         static std::auto_ptr<Game> m_singleton;
     };
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include "HighScores.h"
 #include "Exceptions.h"
+#include "Trace.h"
 
 namespace typing
 {
@@ -115,6 +116,8 @@ namespace typing
 
     void HighScores::Save() const
     {
+        TraceScope trace("HighScores::Save");
+
         FILE *file = fopen(SCORE_FILE.c_str(), "wb");
         if (!file)
         {
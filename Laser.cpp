@@ -3,6 +3,7 @@
 #include "TextureManager.h"
 #include "SoundManager.h"
 #include "Utils.h"
+#include "RenderState.h"
 
 namespace typing
 {
@@ -11,9 +12,11 @@ namespace typing
     const float       Laser::LINE_FADE_TIME  = 0.5f;
     const float       Laser::LIFETIME = LINE_DRAW_TIME + LINE_FADE_TIME;
 
+    static SoundHandle s_laserSound;
+
     void Laser::Init()
     {
-        SOUNDS.Add(LASER_SOUND);
+        s_laserSound = SOUNDS.Add(LASER_SOUND);
     }
 
     void Laser::Draw()
@@ -27,9 +30,9 @@ namespace typing
 
         DrawLine(ColourRGBA(m_col, alpha), m_start, m_end);
 
-        glLineWidth(4.0f);
+        RENDERSTATE.LineWidth(4.0f);
         DrawLine(ColourRGBA(m_col, alpha / 2.0f), m_start, m_end);
-        glLineWidth(1.0f);
+        RENDERSTATE.LineWidth(1.0f);
     }
 
     void Laser::Update()
@@ -44,6 +47,6 @@ namespace typing
 
     void Laser::OnSpawn()
     {
-        SOUNDS.Play(LASER_SOUND);
+        SOUNDS.Play(s_laserSound);
     }
 }
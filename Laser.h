@@ -39,7 +39,6 @@ namespace typing
         juzutil::Vector3 m_end;
         ColourRGB        m_col;
     };
-    typedef std::shared_ptr<Laser> LaserPtr;
 }
 
 #endif // _LASER_H_
@@ -0,0 +1,26 @@
+#include <exception>
+#include <SDL2/SDL.h>
+#include "App.h"
+
+int main (int argc, char *argv[])
+{
+    try {
+        typing::APP.ParseOptions(argc, argv);
+        typing::APP.Init();
+        typing::APP.Run();
+    } catch (std::exception &e) {
+        if (typing::APP.IsHeadless()) {
+            typing::APP.Log(typing::App::LOG_ERROR, e.what());
+        } else {
+            SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR,
+                                     "Exception Caught",
+                                     e.what(),
+                                     NULL);
+        }
+    }
+
+    typing::APP.Shutdown();
+
+    return 0;
+}
+
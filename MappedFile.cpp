@@ -0,0 +1,92 @@
+#include <stdio.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "MappedFile.h"
+
+namespace typing
+{
+    MappedFile::MappedFile()
+        : m_data(NULL), m_size(0), m_mapped(false)
+    {
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    // Returns false if the file can't be opened, leaving the view empty.
+    bool MappedFile::Open(const std::string& fileName)
+    {
+        Close();
+
+#ifndef _WIN32
+        const int fd = open(fileName.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            return false;
+        }
+
+        if (info.st_size > 0) {
+            void *data = mmap(NULL, static_cast<size_t>(info.st_size),
+                              PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                m_data   = static_cast<const char*>(data);
+                m_size   = static_cast<size_t>(info.st_size);
+                m_mapped = true;
+            }
+        }
+
+        close(fd);
+        if (m_mapped || info.st_size == 0) {
+            return true;
+        }
+#endif
+
+        // Mapping isn't available, so read the file instead.
+        FILE *file = fopen(fileName.c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+
+        char   buffer[4096];
+        size_t read;
+        while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            m_buffer.insert(m_buffer.end(), buffer, buffer + read);
+        }
+
+        const bool failed = (ferror(file) != 0);
+        fclose(file);
+        if (failed) {
+            m_buffer.clear();
+            return false;
+        }
+
+        m_data = m_buffer.empty() ? NULL : &m_buffer[0];
+        m_size = m_buffer.size();
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+#ifndef _WIN32
+        if (m_mapped) {
+            munmap(const_cast<char*>(m_data), m_size);
+        }
+#endif
+
+        std::vector<char>().swap(m_buffer);
+        m_data   = NULL;
+        m_size   = 0;
+        m_mapped = false;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <string>
+#include <vector>
+
+namespace typing
+{
+    // A read-only view of a whole file. Where the platform allows, the file
+    // is mapped into memory rather than read, so opening it costs nothing
+    // up front and its pages are shared with any other process using it.
+    class MappedFile
+    {
+    public:
+        // Ctors/Dtors
+        MappedFile();
+        ~MappedFile();
+
+        // Methods
+        bool Open(const std::string& fileName);
+        void Close();
+
+        const char* GetData() const
+        {
+            return m_data;
+        }
+
+        size_t GetSize() const
+        {
+            return m_size;
+        }
+
+    private:
+        // Ctors/Dtors
+        MappedFile(const MappedFile&);
+        MappedFile& operator=(const MappedFile&);
+
+        // Members
+        const char*       m_data;
+        size_t            m_size;
+        bool              m_mapped;
+        std::vector<char> m_buffer;
+    };
+}
+
+#endif // _MAPPED_FILE_H_
@@ -15,10 +15,13 @@ namespace typing
     const float       HighScoresMenu::BACK_BUTTON_HEIGHT = 32.0f;
     const float       HighScoresMenu::BACK_BUTTON_PAD    = 2.0f;
 
+    static FontHandle    s_font;
+    static TextureHandle s_background;
+
     void HighScoresMenu::Init()
     {
-        TEXTURES.Add(BACKGROUND);
-        FONTS.Add(FONT);
+        s_background = TEXTURES.Add(BACKGROUND);
+        s_font       = FONTS.Add(FONT);
 
         MenuItem::Init();
 
@@ -56,12 +59,12 @@ namespace typing
         const float STREAK_X               = APP.GetScreenWidth() - 150.0f;
 
         // Background
-        DrawTexturedRect(BACKGROUND, 0.0f, 0.0f, APP.GetScreenWidth(), APP.GetScreenHeight());
+        DrawTexturedRect(s_background, 0.0f, 0.0f, APP.GetScreenWidth(), APP.GetScreenHeight());
 
         // Title "High Scores"
         DrawRect(ColourRGBA(0.0f, 0.0f, 0.0f, 0.5f), BACKGROUND_MARGIN, 0.0f,
             BACKGROUND_WIDTH, TITLE_HEIGHT + TITLE_BACKGROUND_PAD * 2.0f);
-        FONTS.Print(FONT, APP.GetScreenWidth() / 2.0f, TITLE_BACKGROUND_PAD, TITLE_HEIGHT, ColourRGBA::White(),
+        FONTS.Print(s_font, APP.GetScreenWidth() / 2.0f, TITLE_BACKGROUND_PAD, TITLE_HEIGHT, ColourRGBA::White(),
             Font::ALIGN_CENTER, "High Scores");
 
         float y = TITLE_HEIGHT + TITLE_BACKGROUND_PAD * 2.0f + SECTION_SPACING;
@@ -69,11 +72,11 @@ namespace typing
         // Score table headings
         DrawRect(ColourRGBA(0.0f, 0.0f, 0.0f, 0.5f), BACKGROUND_MARGIN, y,
             BACKGROUND_WIDTH, HEADING_HEIGHT + HEADING_BACKGROUND_PAD * 2.0f);
-        FONTS.Print(FONT, NAME_X, y + HEADING_BACKGROUND_PAD, HEADING_HEIGHT, ColourRGBA::White(),
+        FONTS.Print(s_font, NAME_X, y + HEADING_BACKGROUND_PAD, HEADING_HEIGHT, ColourRGBA::White(),
             Font::ALIGN_LEFT, "Player");
-        FONTS.Print(FONT, SCORE_X, y + HEADING_BACKGROUND_PAD, HEADING_HEIGHT, ColourRGBA::White(),
+        FONTS.Print(s_font, SCORE_X, y + HEADING_BACKGROUND_PAD, HEADING_HEIGHT, ColourRGBA::White(),
             Font::ALIGN_LEFT, "Score");
-        FONTS.Print(FONT, STREAK_X, y + HEADING_BACKGROUND_PAD, HEADING_HEIGHT, ColourRGBA::White(),
+        FONTS.Print(s_font, STREAK_X, y + HEADING_BACKGROUND_PAD, HEADING_HEIGHT, ColourRGBA::White(),
             Font::ALIGN_LEFT, "Streak");
 
         y += HEADING_HEIGHT + HEADING_BACKGROUND_PAD * 2.0f + SECTION_SPACING;
@@ -96,11 +99,11 @@ namespace typing
         {
             ColourRGBA col(1.0f, 1.0f, blue, 1.0f);
 
-            FONTS.Print(FONT, NAME_X, y, ENTRY_HEIGHT, col, Font::ALIGN_LEFT,
+            FONTS.Print(s_font, NAME_X, y, ENTRY_HEIGHT, col, Font::ALIGN_LEFT,
                         (*iter)->name);
-            FONTS.Print(FONT, SCORE_X, y, ENTRY_HEIGHT, col, Font::ALIGN_LEFT,
+            FONTS.Print(s_font, SCORE_X, y, ENTRY_HEIGHT, col, Font::ALIGN_LEFT,
                         std::to_string((*iter)->score));
-            FONTS.Print(FONT, STREAK_X, y, ENTRY_HEIGHT, col, Font::ALIGN_LEFT,
+            FONTS.Print(s_font, STREAK_X, y, ENTRY_HEIGHT, col, Font::ALIGN_LEFT,
                         std::to_string((*iter)->streak));
 
             y += ENTRY_HEIGHT + entryPad;
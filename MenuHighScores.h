@@ -24,7 +24,7 @@ namespace typing
         static const float        BACK_BUTTON_PAD;
         static const unsigned int MENUITEM_BACK = 0;
 
-        float m_startTime;
+        double m_startTime;
     };
 }
 
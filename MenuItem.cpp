@@ -10,9 +10,11 @@ namespace typing
     const float       MenuItem::BORDER_GAP_Y       = -2.0f;
     const float       MenuItem::BORDER_LINE_LENGTH = 5.0f;
 
+    static FontHandle s_font;
+
     void MenuItem::Init()
     {
-        FONTS.Add(FONT);
+        s_font = FONTS.Add(FONT);
     }
 
     void MenuItem::Draw()
@@ -22,7 +24,7 @@ namespace typing
         {
             col = ColourRGBA::Red();
 
-            float width = FONTS.GetLineWidth(FONT, m_height, m_text);
+            float width = FONTS.GetLineWidth(s_font, m_height, m_text);
             float x     = m_origin.GetX() - BORDER_GAP_X - width / 2.0f;
             float y     = m_origin.GetY() - BORDER_GAP_Y;
             DrawLine(ColourRGBA::White(), x, y, x, y + BORDER_LINE_LENGTH);
@@ -42,6 +44,6 @@ namespace typing
             col = ColourRGBA::White();
         }
 
-        FONTS.Print(FONT, m_origin.GetX(), m_origin.GetY(), m_height, col, Font::ALIGN_CENTER, m_text);
+        FONTS.Print(s_font, m_origin.GetX(), m_origin.GetY(), m_height, col, Font::ALIGN_CENTER, m_text);
     }
 }
@@ -20,13 +20,16 @@ namespace typing
     const float       QuitConfirmMenu::ITEM_SPACING = 2.0f;
     const float       QuitConfirmMenu::TITLE_HEIGHT = 48.0f;
 
+    static FontHandle    s_quitConfirmFont;
+    static TextureHandle s_quitConfirmBackground;
+
     void QuitConfirmMenu::Init()
     {
         const float TITLE_STARTY =
             APP.GetScreenHeight() - 2.0f * TITLE_HEIGHT - 7.0f * ITEM_SPACING;
 
-        TEXTURES.Add(BACKGROUND);
-        FONTS.Add(FONT);
+        s_quitConfirmBackground = TEXTURES.Add(BACKGROUND);
+        s_quitConfirmFont       = FONTS.Add(FONT);
         MenuItem::Init();
 
         // Add menu items
@@ -50,12 +53,12 @@ namespace typing
         const float TITLE_STARTY =
             APP.GetScreenHeight() - 2.0f * TITLE_HEIGHT - 7.0f * ITEM_SPACING;
 
-        DrawTexturedRect(BACKGROUND, 0.0f, 0.0f, APP.GetScreenWidth(), APP.GetScreenHeight());
+        DrawTexturedRect(s_quitConfirmBackground, 0.0f, 0.0f, APP.GetScreenWidth(), APP.GetScreenHeight());
 
         DrawRect(ColourRGBA(0.0f, 0.0f, 0.0f, 0.5f), 0.0f, TITLE_STARTY - ITEM_SPACING,
             APP.GetScreenWidth(), APP.GetScreenHeight() - TITLE_STARTY + ITEM_SPACING);
 
-        FONTS.Print(FONT, m_titleOrigin.GetX(), m_titleOrigin.GetY(), TITLE_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER, "RSI Already?");
+        FONTS.Print(s_quitConfirmFont, m_titleOrigin.GetX(), m_titleOrigin.GetY(), TITLE_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER, "RSI Already?");
 
         // Draw the menu items
         MenuScreen::Draw();
@@ -93,10 +96,13 @@ namespace typing
     const float       MainMenu::ITEM_HEIGHT  = 32.0f;
     const float       MainMenu::ITEM_SPACING = 2.0f;
 
+    static FontHandle    s_mainVersionFont;
+    static TextureHandle s_mainBackground;
+
     void MainMenu::Init()
     {
-        FONTS.Add(VERSION_FONT);
-        TEXTURES.Add(BACKGROUND);
+        s_mainVersionFont = FONTS.Add(VERSION_FONT);
+        s_mainBackground  = TEXTURES.Add(BACKGROUND);
 
         MenuItem::Init();
 
@@ -131,7 +137,7 @@ namespace typing
         const float y =
             APP.GetScreenHeight() - 3.0f * ITEM_HEIGHT - 7.0f * ITEM_SPACING;
 
-        DrawTexturedRect(BACKGROUND, 0.0f, 0.0f, APP.GetScreenWidth(),
+        DrawTexturedRect(s_mainBackground, 0.0f, 0.0f, APP.GetScreenWidth(),
                         APP.GetScreenHeight());
 
         DrawRect(ColourRGBA(0.0f, 0.0f, 0.0f, 0.5f), 0.0f, y - ITEM_SPACING,
@@ -139,7 +145,7 @@ namespace typing
 
         // Draw the version number
         using namespace boost;
-        FONTS.Print(VERSION_FONT,
+        FONTS.Print(s_mainVersionFont,
                     APP.GetScreenWidth(),
                     APP.GetScreenHeight() - 12.0f,
                     12.0f,
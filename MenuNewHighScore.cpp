@@ -5,6 +5,7 @@
 #include "MenuMain.h"
 #include "FontManager.h"
 #include "SoundManager.h"
+#include "TextureManager.h"
 #include "App.h"
 #include "HighScores.h"
 #include "Game.h"
@@ -18,10 +19,15 @@ namespace typing
     const std::string NewHighScoreMenu::ERROR_SOUND("sounds/miss.wav");
     const float       NewHighScoreMenu::CURSOR_FLASH_SPEED = 0.3f;
 
+    static FontHandle    s_font;
+    static TextureHandle s_background;
+    static SoundHandle   s_errorSound;
+
     void NewHighScoreMenu::Init()
     {
-        FONTS.Add(FONT);
-        SOUNDS.Add(ERROR_SOUND);
+        s_font       = FONTS.Add(FONT);
+        s_background = TEXTURES.Add(BACKGROUND);
+        s_errorSound = SOUNDS.Add(ERROR_SOUND);
         m_name.clear();
     }
 
@@ -38,38 +44,38 @@ namespace typing
         const float NAME_HEIGHT            = 64.0f;
         const float NAME_PAD               = 10.0f;
 
-        DrawTexturedRect(BACKGROUND, 0.0f, 0.0f, APP.GetScreenWidth(), APP.GetScreenHeight());
+        DrawTexturedRect(s_background, 0.0f, 0.0f, APP.GetScreenWidth(), APP.GetScreenHeight());
 
         DrawRect(ColourRGBA(0.0f, 0.0f, 0.0f, 0.5f), BACKGROUND_MARGIN, 0.0f, APP.GetScreenWidth() - BACKGROUND_MARGIN * 2.0f,
                  APP.GetScreenHeight());
 
         const float x = APP.GetScreenWidth() / 2.0f;
         float y       = CONGRATS_PAD;
-        FONTS.Print(FONT, x, y, CONGRATS_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
+        FONTS.Print(s_font, x, y, CONGRATS_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
                     "Congratulations!");
 
         y += CONGRATS_HEIGHT + SCORE_PAD;
-        FONTS.Print(FONT, x, y, SCORE_HEIGHT, ColourRGBA::Yellow(), Font::ALIGN_CENTER,
+        FONTS.Print(s_font, x, y, SCORE_HEIGHT, ColourRGBA::Yellow(), Font::ALIGN_CENTER,
                     std::to_string(GAME.GetScore()));
 
         y += SCORE_HEIGHT + TEXT_PAD;
-        FONTS.Print(FONT, x, y, TEXT_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
+        FONTS.Print(s_font, x, y, TEXT_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
             "is a new high score!");
 
         y += ENTER_PAD + TEXT_PAD;
-        FONTS.Print(FONT, x, y, TEXT_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
+        FONTS.Print(s_font, x, y, TEXT_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
                     "Enter your name and");
         y += TEXT_HEIGHT + TEXT_PAD;
-        FONTS.Print(FONT, x, y, TEXT_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
+        FONTS.Print(s_font, x, y, TEXT_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER,
                     "press return to continue.");
 
         y += TEXT_HEIGHT + NAME_PAD;
-        FONTS.Print(FONT, x, y, NAME_HEIGHT, ColourRGBA::Yellow(), Font::ALIGN_CENTER, m_name);
+        FONTS.Print(s_font, x, y, NAME_HEIGHT, ColourRGBA::Yellow(), Font::ALIGN_CENTER, m_name);
 
         if (m_name.length() < MAX_NAME_LENGTH && static_cast<int>(floor(APP.GetTime() / CURSOR_FLASH_SPEED)) % 2 == 0)
         {
-            const float cursorX = FONTS.GetLineWidth(FONT, NAME_HEIGHT, m_name) / 2.0f + x;
-            FONTS.Print(FONT, cursorX, y, NAME_HEIGHT, ColourRGBA::Yellow(), Font::ALIGN_LEFT, "_");
+            const float cursorX = FONTS.GetLineWidth(s_font, NAME_HEIGHT, m_name) / 2.0f + x;
+            FONTS.Print(s_font, cursorX, y, NAME_HEIGHT, ColourRGBA::Yellow(), Font::ALIGN_LEFT, "_");
         }
     }
 
@@ -95,7 +101,7 @@ namespace typing
             }
             else
             {
-                SOUNDS.Play(ERROR_SOUND);
+                SOUNDS.Play(s_errorSound);
                 return ACTION_NONE;
             }
         }
@@ -108,7 +114,7 @@ namespace typing
         if (c != ' ' && m_name.length() < MAX_NAME_LENGTH) {
             m_name += c;
         } else {
-            SOUNDS.Play(ERROR_SOUND);
+            SOUNDS.Play(s_errorSound);
         }
     }
 }
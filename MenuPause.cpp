@@ -17,9 +17,11 @@ namespace typing
     const float       EndGameConfirmMenu::TITLE_HEIGHT = 48.0f;
     const float       EndGameConfirmMenu::TITLE_OFFSET = 16.0f;
 
+    static FontHandle s_endGameConfirmFont;
+
     void EndGameConfirmMenu::Init()
     {
-        FONTS.Add(FONT);
+        s_endGameConfirmFont = FONTS.Add(FONT);
         MenuItem::Init();
 
         // Add menu items
@@ -40,7 +42,7 @@ namespace typing
         DrawRect(ColourRGBA(0.0f, 0.0f, 0.0f, 0.5f), 0.0f, 0.0f,
             APP.GetScreenWidth(), APP.GetScreenHeight());
 
-        FONTS.Print(FONT, m_titleOrigin.GetX(), m_titleOrigin.GetY(), TITLE_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER, "Are you sure?");
+        FONTS.Print(s_endGameConfirmFont, m_titleOrigin.GetX(), m_titleOrigin.GetY(), TITLE_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER, "Are you sure?");
 
         // Draw the menu items
         MenuScreen::Draw();
@@ -51,8 +53,7 @@ namespace typing
         switch(id)
         {
         case MENUITEM_YES:
-            GAME.Pause(false);
-            GAME.EndGame();
+            GAME.Quit();
             return ACTION_GAME;
 
         case MENUITEM_NO:
@@ -80,9 +81,11 @@ namespace typing
     const float       PauseMenu::TITLE_HEIGHT = 48.0f;
     const float       PauseMenu::TITLE_OFFSET = 16.0f;
 
+    static FontHandle s_pauseFont;
+
     void PauseMenu::Init()
     {
-        FONTS.Add(FONT);
+        s_pauseFont = FONTS.Add(FONT);
         MenuItem::Init();
 
         // Add menu items
@@ -103,7 +106,7 @@ namespace typing
         DrawRect(ColourRGBA(0.0f, 0.0f, 0.0f, 0.5f), 0.0f, 0.0f,
             APP.GetScreenWidth(), APP.GetScreenHeight());
 
-        FONTS.Print(FONT, m_titleOrigin.GetX(), m_titleOrigin.GetY(), TITLE_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER, "Game Paused");
+        FONTS.Print(s_pauseFont, m_titleOrigin.GetX(), m_titleOrigin.GetY(), TITLE_HEIGHT, ColourRGBA::White(), Font::ALIGN_CENTER, "Game Paused");
 
         // Draw the menu items
         MenuScreen::Draw();
@@ -114,7 +117,7 @@ namespace typing
         switch (id)
         {
         case MENUITEM_RESUME:
-            GAME.Pause(false);
+            GAME.Resume();
             return ACTION_GAME;
 
         case MENUITEM_QUIT:
@@ -0,0 +1,115 @@
+#ifndef _OBJECT_POOL_H_
+#define _OBJECT_POOL_H_
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace typing
+{
+    // Storage for objects of a single type, allocated in fixed size blocks.
+    // Objects never move once created, and destroyed objects leave their
+    // slot on a free list to be reused by the next object created, so once
+    // the pool has grown to the most objects alive at once, creating and
+    // destroying objects doesn't touch the heap.
+    template<typename T> class ObjectPool
+    {
+    public:
+        // Ctors/Dtors
+        ObjectPool()
+            : m_live(0), m_highWater(0)
+        {
+        }
+
+        // Methods
+        template<typename... Args> T *Create(Args&&... args)
+        {
+            if (m_free.empty()) {
+                AddBlock();
+            }
+
+            // Only take the slot once the object has been constructed, so
+            // that it isn't lost if the constructor throws.
+            T *obj = new (m_free.back()) T(std::forward<Args>(args)...);
+            m_free.pop_back();
+
+            if (++m_live > m_highWater) {
+                m_highWater = m_live;
+            }
+
+            return obj;
+        }
+
+        void Destroy(T *obj)
+        {
+            obj->~T();
+            m_free.push_back(obj);
+            m_live--;
+        }
+
+        // Reserve
+        // Grows the pool up front to hold at least count objects, so that
+        // the first burst of objects doesn't have to.
+        void Reserve(unsigned int count)
+        {
+            while (Capacity() < count) {
+                AddBlock();
+            }
+        }
+
+        unsigned int Live() const
+        {
+            return m_live;
+        }
+
+        unsigned int HighWater() const
+        {
+            return m_highWater;
+        }
+
+        unsigned int Capacity() const
+        {
+            return static_cast<unsigned int>(m_blocks.size()) * BLOCK_SIZE;
+        }
+
+    private:
+        // Ctors/Dtors
+        // Objects in the pool are owned by whoever created them, so the pool
+        // can't be copied.
+        ObjectPool(const ObjectPool& pool);
+
+        // Consts/Enums
+        static const unsigned int BLOCK_SIZE = 64;
+
+        // Typedefs
+        typedef typename std::aligned_storage<sizeof(T),
+                                              alignof(T)>::type Storage;
+        typedef std::unique_ptr<Storage[]>                      BlockPtr;
+        typedef std::vector<BlockPtr>                           BlockVec;
+        typedef std::vector<void *>                             FreeVec;
+
+        // Methods
+        void AddBlock()
+        {
+            BlockPtr block(new Storage[BLOCK_SIZE]);
+
+            // Add the slots in reverse so that they are handed out in
+            // address order.
+            for (unsigned int i = BLOCK_SIZE; i > 0; i--) {
+                m_free.push_back(&block[i - 1]);
+            }
+
+            m_blocks.push_back(std::move(block));
+        }
+
+        // Members
+        BlockVec     m_blocks;
+        FreeVec      m_free;
+        unsigned int m_live;
+        unsigned int m_highWater;
+    };
+}
+
+#endif // _OBJECT_POOL_H_
@@ -0,0 +1,201 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_opengl.h>
+#include "ParticleSystem.h"
+#include "Random.h"
+#include "Profiler.h"
+#include "RenderState.h"
+
+namespace typing
+{
+    // Particles are drawn as cubes, centred on the particle.
+    static const unsigned int PARTICLE_VERTS = 24;
+    static const float PARTICLE_CORNERS[PARTICLE_VERTS][3] = {
+        // Bottom
+        {-0.5f, -0.5f, -0.5f}, { 0.5f, -0.5f, -0.5f}, { 0.5f,  0.5f, -0.5f}, {-0.5f,  0.5f, -0.5f},
+        // Top
+        {-0.5f,  0.5f,  0.5f}, { 0.5f,  0.5f,  0.5f}, { 0.5f, -0.5f,  0.5f}, {-0.5f, -0.5f,  0.5f},
+        // Left
+        {-0.5f, -0.5f, -0.5f}, {-0.5f, -0.5f,  0.5f}, {-0.5f,  0.5f,  0.5f}, {-0.5f,  0.5f, -0.5f},
+        // Right
+        { 0.5f,  0.5f, -0.5f}, { 0.5f,  0.5f,  0.5f}, { 0.5f, -0.5f,  0.5f}, { 0.5f, -0.5f, -0.5f},
+        // Up
+        {-0.5f,  0.5f, -0.5f}, { 0.5f,  0.5f, -0.5f}, { 0.5f,  0.5f,  0.5f}, {-0.5f,  0.5f,  0.5f},
+        // Down
+        {-0.5f, -0.5f,  0.5f}, { 0.5f, -0.5f,  0.5f}, { 0.5f, -0.5f, -0.5f}, {-0.5f, -0.5f, -0.5f},
+    };
+
+    ParticleSystem::ParticleSystem()
+        : m_count(0), m_spawnedThisFrame(0),
+          m_posX(MAX_PARTICLES), m_posY(MAX_PARTICLES), m_posZ(MAX_PARTICLES),
+          m_dirX(MAX_PARTICLES), m_dirY(MAX_PARTICLES), m_dirZ(MAX_PARTICLES),
+          m_speed(MAX_PARTICLES), m_step(MAX_PARTICLES),
+          m_accel(MAX_PARTICLES), m_alpha(MAX_PARTICLES),
+          m_fade(MAX_PARTICLES), m_life(MAX_PARTICLES), m_size(MAX_PARTICLES),
+          m_red(MAX_PARTICLES), m_green(MAX_PARTICLES), m_blue(MAX_PARTICLES)
+    {
+    }
+
+    unsigned int ParticleSystem::Burst(const juzutil::Vector3& origin,
+                                       const ParticleBurst&    burst,
+                                       unsigned int            count)
+    {
+        unsigned int available = FRAME_BUDGET - m_spawnedThisFrame;
+        if (MAX_PARTICLES - m_count < available) {
+            available = MAX_PARTICLES - m_count;
+        }
+        if (count > available) {
+            count = available;
+        }
+
+        for (unsigned int i = 0; i < count; i++) {
+            const unsigned int p = m_count++;
+
+            juzutil::Vector3 dir(RAND.Range(-0.5f, 0.5f),
+                                 RAND.Range(-0.5f, 0.5f),
+                                 RAND.Range(-0.5f, 0.5f));
+            dir.Normalize();
+
+            m_posX[p]  = origin[0];
+            m_posY[p]  = origin[1];
+            m_posZ[p]  = origin[2];
+            m_dirX[p]  = dir[0];
+            m_dirY[p]  = dir[1];
+            m_dirZ[p]  = dir[2];
+            m_speed[p] = burst.speed;
+            m_step[p]  = 0.0f;
+            m_accel[p] = burst.accel;
+            m_alpha[p] = burst.alpha;
+            m_fade[p]  = burst.fadeSpeed;
+            m_life[p]  = burst.lifetime;
+            m_size[p]  = burst.size;
+            m_red[p]   = burst.colour.GetRed();
+            m_green[p] = burst.colour.GetGreen();
+            m_blue[p]  = burst.colour.GetBlue();
+        }
+
+        m_spawnedThisFrame += count;
+        return count;
+    }
+
+    void ParticleSystem::Update(float frameTime)
+    {
+        m_spawnedThisFrame = 0;
+
+        const unsigned int n = m_count;
+
+        // Keep each loop to a few independent arrays with no branches, so
+        // the compiler is free to vectorise them.
+        float       *posX  = &m_posX[0];
+        float       *posY  = &m_posY[0];
+        float       *posZ  = &m_posZ[0];
+        const float *dirX  = &m_dirX[0];
+        const float *dirY  = &m_dirY[0];
+        const float *dirZ  = &m_dirZ[0];
+        float       *speed = &m_speed[0];
+        float       *step  = &m_step[0];
+        const float *accel = &m_accel[0];
+        float       *alpha = &m_alpha[0];
+        const float *fade  = &m_fade[0];
+        float       *life  = &m_life[0];
+
+        for (unsigned int i = 0; i < n; i++) {
+            step[i] = speed[i] * frameTime;
+        }
+
+        for (unsigned int i = 0; i < n; i++) {
+            posX[i] += dirX[i] * step[i];
+            posY[i] += dirY[i] * step[i];
+            posZ[i] += dirZ[i] * step[i];
+        }
+
+        for (unsigned int i = 0; i < n; i++) {
+            speed[i] += accel[i] * frameTime;
+        }
+
+        for (unsigned int i = 0; i < n; i++) {
+            alpha[i] -= fade[i] * frameTime;
+            life[i]  -= frameTime;
+        }
+
+        // Remove the dead particles. Draw order doesn't matter for
+        // particles, so the last particle is just moved into the gap.
+        for (unsigned int i = 0; i < m_count;) {
+            if (m_life[i] <= 0.0f) {
+                Remove(i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    void ParticleSystem::Remove(unsigned int index)
+    {
+        const unsigned int last = --m_count;
+
+        m_posX[index]  = m_posX[last];
+        m_posY[index]  = m_posY[last];
+        m_posZ[index]  = m_posZ[last];
+        m_dirX[index]  = m_dirX[last];
+        m_dirY[index]  = m_dirY[last];
+        m_dirZ[index]  = m_dirZ[last];
+        m_speed[index] = m_speed[last];
+        m_step[index]  = m_step[last];
+        m_accel[index] = m_accel[last];
+        m_alpha[index] = m_alpha[last];
+        m_fade[index]  = m_fade[last];
+        m_life[index]  = m_life[last];
+        m_size[index]  = m_size[last];
+        m_red[index]   = m_red[last];
+        m_green[index] = m_green[last];
+        m_blue[index]  = m_blue[last];
+    }
+
+    // Particles move in a straight line, so they can be drawn part way
+    // through their last step by backing them up along their direction.
+    void ParticleSystem::Draw(float alpha) const
+    {
+        if (m_count == 0) {
+            return;
+        }
+
+        m_verts.resize(m_count * PARTICLE_VERTS);
+
+        ParticleVertex *vert = &m_verts[0];
+        for (unsigned int i = 0; i < m_count; i++) {
+            const float back = m_step[i] * (alpha - 1.0f);
+            const float x    = m_posX[i] + m_dirX[i] * back;
+            const float y    = m_posY[i] + m_dirY[i] * back;
+            const float z    = m_posZ[i] + m_dirZ[i] * back;
+
+            for (unsigned int v = 0; v < PARTICLE_VERTS; v++, vert++) {
+                vert->x = x + PARTICLE_CORNERS[v][0] * m_size[i];
+                vert->y = y + PARTICLE_CORNERS[v][1] * m_size[i];
+                vert->z = z + PARTICLE_CORNERS[v][2] * m_size[i];
+                vert->r = m_red[i];
+                vert->g = m_green[i];
+                vert->b = m_blue[i];
+                vert->a = m_alpha[i];
+            }
+        }
+
+        RENDERSTATE.Disable(GL_TEXTURE_2D);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+
+        const ParticleVertex& first = m_verts.front();
+        glVertexPointer(3, GL_FLOAT, sizeof(ParticleVertex), &first.x);
+        glColorPointer(4, GL_FLOAT, sizeof(ParticleVertex), &first.r);
+        PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
+        glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(m_verts.size()));
+
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        RENDERSTATE.InvalidateColour();
+    }
+
+    void ParticleSystem::Clear()
+    {
+        m_count = 0;
+        m_spawnedThisFrame = 0;
+    }
+}
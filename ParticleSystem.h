@@ -0,0 +1,92 @@
+#ifndef _PARTICLE_SYSTEM_H_
+#define _PARTICLE_SYSTEM_H_
+
+#include <vector>
+#include "Vector.h"
+#include "Colour.h"
+
+namespace typing
+{
+    // The starting state for the particles in a burst.
+    struct ParticleBurst
+    {
+        ColourRGB colour;
+        float     size;
+        float     speed;
+        float     accel;
+        float     alpha;
+        float     fadeSpeed;
+        float     lifetime;
+    };
+
+    // Stores every live particle in the game as a set of parallel arrays,
+    // so that they can be updated in tight loops and drawn in one batch.
+    class ParticleSystem
+    {
+    public:
+        // Ctors/Dtors
+        ParticleSystem();
+
+        // Methods
+        unsigned int Burst(const juzutil::Vector3& origin,
+                           const ParticleBurst&    burst,
+                           unsigned int            count);
+        void         Update(float frameTime);
+        void         Draw(float alpha) const;
+        void         Clear();
+
+        unsigned int Count() const
+        {
+            return m_count;
+        }
+
+    private:
+        // Consts/Enums
+        // The most particles that can be alive at once.
+        static const unsigned int MAX_PARTICLES = 4096;
+
+        // The most particles that can be spawned between updates. Requests
+        // beyond this are dropped, so that a lot of explosions at once (e.g.
+        // when the player dies) doesn't cause a spike in the frame time.
+        static const unsigned int FRAME_BUDGET  = 600;
+
+        // Typedefs
+        typedef std::vector<float> FloatArray;
+
+        struct ParticleVertex
+        {
+            float x, y, z;
+            float r, g, b, a;
+        };
+        typedef std::vector<ParticleVertex> VertexArray;
+
+        // Methods
+        void Remove(unsigned int index);
+
+        // Members
+        unsigned int m_count;
+        unsigned int m_spawnedThisFrame;
+
+        FloatArray   m_posX;
+        FloatArray   m_posY;
+        FloatArray   m_posZ;
+        FloatArray   m_dirX;
+        FloatArray   m_dirY;
+        FloatArray   m_dirZ;
+        FloatArray   m_speed;
+        FloatArray   m_step;
+        FloatArray   m_accel;
+        FloatArray   m_alpha;
+        FloatArray   m_fade;
+        FloatArray   m_life;
+        FloatArray   m_size;
+        FloatArray   m_red;
+        FloatArray   m_green;
+        FloatArray   m_blue;
+
+        // Scratch space for building the batch, kept between frames.
+        mutable VertexArray m_verts;
+    };
+}
+
+#endif // _PARTICLE_SYSTEM_H_
@@ -1,6 +1,5 @@
 #include "Phrase.h"
 #include "FontManager.h"
-#include "Utils.h"
 #include "Game.h"
 
 namespace typing
@@ -9,16 +8,34 @@ namespace typing
     const float       Phrase::PHRASE_HEIGHT             = 18.0f;
     const float       Phrase::PHRASE_BORDER_GAP         = 3.0f;
     const float       Phrase::PHRASE_BORDER_LINE_LENGTH = 3.0f;
+    const float       Phrase::PHRASE_BORDER_LINE_WIDTH  = 1.0f;
 
     // Nudge the phrase up a bit so that it doesn't cover the entity
     const float       Phrase::PHRASE_Y_OFFSET           = 15.0f;
 
+    const Font *Phrase::m_phraseFont   = NULL;
+    float       Phrase::m_phraseHeight = 0.0f;
+
     void Phrase::Init()
     {
         FONTS.Add(PHRASE_FONT);
+        m_phraseFont = &FONTS.Get(PHRASE_FONT);
+        m_phraseHeight = PHRASE_HEIGHT * APP.GetOption<float>("text-scale");
+    }
+
+    void Phrase::CacheWidths()
+    {
+        m_prefixWidths.resize(m_phrase.length() + 1);
+        m_prefixWidths[0] = 0.0f;
+
+        for (std::string::size_type i = 0; i < m_phrase.length(); i++) {
+            const float advance = m_phraseFont ?
+                m_phraseFont->GetCharWidth(1.0f, m_phrase[i]) : 0.0f;
+            m_prefixWidths[i + 1] = m_prefixWidths[i] + advance;
+        }
     }
 
-    bool Phrase::OnType(char c, float time)
+    bool Phrase::OnType(char c, double time)
     {
         if (m_phraseIndex < m_phrase.length() && m_phrase[m_phraseIndex] == c)
         {
@@ -34,94 +51,96 @@ namespace typing
         return false;
     }
 
-    // This assumes that the view has already been set up in ortho projection.
-    void Phrase::Draw(const juzutil::Vector3& origin,
+    // This assumes that the view has already been set up in ortho projection,
+    // and that coords is the owner's origin in screen coordinates.
+    void Phrase::Draw(const juzutil::Vector2& coords,
                       PhraseDrawOption        option)
     {
 
         if (!m_phrase.empty()) {
-            const float height =
-                            PHRASE_HEIGHT * APP.GetOption<float>("text-scale");
-            const juzutil::Vector2 coords =
-                            GAME.GetCam().PerspectiveProject(origin);
-
-            std::string typed;
-            std::string remaining;
-
-            typed.assign(m_phrase, 0, m_phraseIndex);
-            remaining.assign(m_phrase,
-                             m_phraseIndex,
-                             m_phrase.length() - m_phraseIndex);
-
-            const float typedWidth = FONTS.GetLineWidth(
-                                            PHRASE_FONT, height, typed);
-            const float remainingWidth = FONTS.GetLineWidth(
-                                            PHRASE_FONT, height, remaining);
-            const float totalWidth = typedWidth + remainingWidth;
-
-            float x = coords[0];
-            float y = coords[1] - height / 2.0f - PHRASE_BORDER_GAP -
+            const float height = m_phraseHeight;
+
+            const float typedWidth = m_prefixWidths[m_phraseIndex] * height;
+            const float totalWidth = m_prefixWidths[m_phrase.length()] * height;
+
+            const float x = coords[0];
+            const float y = coords[1] - height / 2.0f - PHRASE_BORDER_GAP -
                                                             PHRASE_Y_OFFSET;
-                
-            glPushMatrix();
-            glTranslatef(x, y, 0.0f);
 
-            if (option == PHRASE_DRAW_BACKWARDS) {
-                glScalef(-1.0f, 1.0f, 1.0f);
-            }
+            // Backwards phrases are queued the right way round and then
+            // mirrored about their middle, as the batch is drawn with
+            // whatever transform is current when it is flushed.
+            const std::string::size_type batchStart =
+                                            m_phraseFont->GetBatchSize();
 
-            glTranslatef(-totalWidth / 2.0f,
-                         -height / 2.0f - PHRASE_BORDER_GAP,
-                         0.0f);
-
-            // Draw the backing
-            DrawRect(ColourRGBA(0.0f, 0.0f, 0.0f, 0.5f),
-                     -PHRASE_BORDER_GAP,
-                     -PHRASE_BORDER_GAP,
-                     totalWidth + PHRASE_BORDER_GAP * 2,
-                     height + PHRASE_BORDER_GAP * 2);
-
-            // Draw the text
-            ColourRGBA textColour;
-            if (option == PHRASE_DRAW_BLOCKED) {
-                textColour[ColourRGBA::COLOUR_RED] = 0.4f;
-                textColour[ColourRGBA::COLOUR_GREEN] = 0.4f;
-                textColour[ColourRGBA::COLOUR_BLUE] = 0.4f;
-                textColour[ColourRGBA::COLOUR_ALPHA] = 1.0f;
-            } else {
-                textColour = ColourRGBA::White();
+            DrawFramed(x - totalWidth / 2.0f,
+                       y - height / 2.0f - PHRASE_BORDER_GAP,
+                       height, typedWidth, totalWidth, option);
+
+            if (option == PHRASE_DRAW_BACKWARDS) {
+                m_phraseFont->MirrorBatch(batchStart, x);
             }
+        }
+    }
 
-            FONTS.Print(PHRASE_FONT,
-                        0.0f, 0.0f, height,
-                        ColourRGBA::Red(),
-                        Font::ALIGN_LEFT,
-                        typed);
+    // Queues the backing, the text and the corners of the frame, in that
+    // order. They all go in the phrase font's batch, so phrases drawn later
+    // cover earlier ones, and the whole layer is still a single draw.
+    void Phrase::DrawFramed(float            left,
+                            float            top,
+                            float            height,
+                            float            typedWidth,
+                            float            totalWidth,
+                            PhraseDrawOption option) const
+    {
+        // Draw the backing
+        m_phraseFont->PrintRect(left - PHRASE_BORDER_GAP,
+                                top - PHRASE_BORDER_GAP,
+                                totalWidth + PHRASE_BORDER_GAP * 2,
+                                height + PHRASE_BORDER_GAP * 2,
+                                ColourRGBA(0.0f, 0.0f, 0.0f, 0.5f));
+
+        // Draw the text
+        ColourRGBA textColour;
+        if (option == PHRASE_DRAW_BLOCKED) {
+            textColour[ColourRGBA::COLOUR_RED] = 0.4f;
+            textColour[ColourRGBA::COLOUR_GREEN] = 0.4f;
+            textColour[ColourRGBA::COLOUR_BLUE] = 0.4f;
+            textColour[ColourRGBA::COLOUR_ALPHA] = 1.0f;
+        } else {
+            textColour = ColourRGBA::White();
+        }
 
-            if (option != PHRASE_DRAW_HIDDEN) {
-                FONTS.Print(PHRASE_FONT,
-                            typedWidth, 0.0f, height,
-                            textColour,
+        m_phraseFont->Print(left, top, height,
+                            ColourRGBA::Red(),
                             Font::ALIGN_LEFT,
-                            remaining);
-            }
-
-            // Draw the corners of the backing
-            x = -PHRASE_BORDER_GAP;
-            y = -PHRASE_BORDER_GAP;
-            DrawLine(textColour, x, y, x, y + PHRASE_BORDER_LINE_LENGTH);
-            DrawLine(textColour, x, y, x + PHRASE_BORDER_LINE_LENGTH, y);
-            x += totalWidth + PHRASE_BORDER_GAP * 2;
-            DrawLine(textColour, x, y, x, y + PHRASE_BORDER_LINE_LENGTH);
-            DrawLine(textColour, x, y, x - PHRASE_BORDER_LINE_LENGTH, y);
-            y += height + PHRASE_BORDER_GAP * 2;
-            DrawLine(textColour, x, y, x, y - PHRASE_BORDER_LINE_LENGTH);
-            DrawLine(textColour, x, y, x - PHRASE_BORDER_LINE_LENGTH, y);
-            x -= totalWidth + PHRASE_BORDER_GAP * 2;
-            DrawLine(textColour, x, y, x, y - PHRASE_BORDER_LINE_LENGTH);
-            DrawLine(textColour, x, y, x + PHRASE_BORDER_LINE_LENGTH, y);
-
-            glPopMatrix();
+                            m_phrase.data(),
+                            m_phraseIndex);
+
+        if (option != PHRASE_DRAW_HIDDEN) {
+            m_phraseFont->Print(left + typedWidth, top, height,
+                                textColour,
+                                Font::ALIGN_LEFT,
+                                m_phrase.data() + m_phraseIndex,
+                                m_phrase.length() - m_phraseIndex);
         }
+
+        // Draw the corners of the backing, as thin rects centred on the
+        // edges of the backing.
+        const float len   = PHRASE_BORDER_LINE_LENGTH;
+        const float width = PHRASE_BORDER_LINE_WIDTH;
+        const float l     = left - PHRASE_BORDER_GAP - width / 2.0f;
+        const float t     = top - PHRASE_BORDER_GAP - width / 2.0f;
+        const float r     = l + totalWidth + PHRASE_BORDER_GAP * 2;
+        const float b     = t + height + PHRASE_BORDER_GAP * 2;
+
+        m_phraseFont->PrintRect(l, t, len, width, textColour);
+        m_phraseFont->PrintRect(l, t, width, len, textColour);
+        m_phraseFont->PrintRect(r + width - len, t, len, width, textColour);
+        m_phraseFont->PrintRect(r, t, width, len, textColour);
+        m_phraseFont->PrintRect(r + width - len, b, len, width, textColour);
+        m_phraseFont->PrintRect(r, b + width - len, width, len, textColour);
+        m_phraseFont->PrintRect(l, b, len, width, textColour);
+        m_phraseFont->PrintRect(l, b + width - len, width, len, textColour);
     }
 }
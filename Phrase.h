@@ -2,11 +2,18 @@
 #define __PHRASE_H__
 
 #include <string>
+#include <vector>
+#include <boost/utility/string_ref.hpp>
 #include "Vector.h"
 
 namespace typing
 {
     class WorldToScreenCoords;
+    class Font;
+
+    // A phrase as handed out by the phrasebook, pointing into its corpus.
+    // The text is copied when a Phrase is made from it.
+    typedef boost::string_ref PhraseView;
 
     class Phrase
     {
@@ -18,10 +25,11 @@ namespace typing
         {
         }
 
-        Phrase(const std::string& phrase)
-            : m_phrase(phrase), m_phraseIndex(0), m_startTime(0.0f),
+        Phrase(PhraseView phrase)
+            : m_phrase(phrase.data(), phrase.length()), m_phraseIndex(0), m_startTime(0.0f),
             m_lastCorrectTypeTime(0.0f)
         {
+            CacheWidths();
         }
 
         static void Init();
@@ -33,16 +41,17 @@ namespace typing
             PHRASE_DRAW_HIDDEN,
         } PhraseDrawOption;
 
-        bool OnType(char c, float time);
-        void Draw(const juzutil::Vector3& origin,
+        bool OnType(char c, double time);
+        void Draw(const juzutil::Vector2& coords,
                   PhraseDrawOption        option = PHRASE_DRAW_DEFAULT);
 
-        void Reset(const std::string& phrase)
+        void Reset(PhraseView phrase)
         {
-            m_phrase = phrase;
+            m_phrase.assign(phrase.data(), phrase.length());
             m_phraseIndex = 0;
             m_startTime = 0.0f;
             m_lastCorrectTypeTime = 0.0f;
+            CacheWidths();
         }
 
         bool IsEmpty() const
@@ -60,6 +69,19 @@ namespace typing
             return m_phrase[0];
         }
 
+        // GetNextChar
+        // Returns the next character to be typed, or '\0' if the phrase has
+        // been finished.
+        char GetNextChar() const
+        {
+            if (Finished())
+            {
+                return '\0';
+            }
+
+            return m_phrase[m_phraseIndex];
+        }
+
         unsigned int Length() const
         {
             return static_cast<unsigned int>(m_phrase.length());
@@ -82,15 +104,31 @@ namespace typing
 
 
     private:
+        void CacheWidths();
+        void DrawFramed(float left, float top, float height,
+                        float typedWidth, float totalWidth,
+                        PhraseDrawOption option) const;
+
         static const float       PHRASE_HEIGHT;
         static const float       PHRASE_BORDER_GAP;
         static const float       PHRASE_BORDER_LINE_LENGTH;
+        static const float       PHRASE_BORDER_LINE_WIDTH;
         static const float       PHRASE_Y_OFFSET;
 
+        // The phrase font and text height, looked up once by Init.
+        static const Font *m_phraseFont;
+        static float       m_phraseHeight;
+
         std::string  m_phrase;
+
+        // m_prefixWidths[i] is the width of the first i characters of the
+        // phrase at a height of 1, so the typed and remaining widths can be
+        // found without measuring the text each frame.
+        std::vector<float> m_prefixWidths;
+
         unsigned int m_phraseIndex;
-        float        m_startTime;
-        float        m_lastCorrectTypeTime;
+        double       m_startTime;
+        double       m_lastCorrectTypeTime;
     };
 }
 
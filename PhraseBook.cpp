@@ -1,4 +1,10 @@
+#include <cmath>
 #include <ctime>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <functional>
+#include <thread>
 #include <boost/format.hpp>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_opengl.h>
@@ -7,40 +13,182 @@
 #include "Exceptions.h"
 #include "Random.h"
 #include "FontManager.h"
+#include "Trace.h"
+#include "PhraseFeatures.h"
+#include "PhraseStream.h"
 
 namespace typing
 {
     const std::string PhraseBook::PHRASE_FILE("phrases/phrases");
+    const std::string PhraseBook::PHRASE_INDEX_FILE("phrases/phrases.idx");
+    const char        PhraseBook::INDEX_MAGIC[4] = { 'T', 'O', 'D', 'P' };
 
-    void PhraseBook::Init(Font phraseFont)
+    PhraseBook::PhraseBook()
+        : m_streamGeneration(0), m_shortPhrases(false),
+          m_minDifficulty(0.0f), m_maxDifficulty(1.0f)
     {
-        FILE * phraseFile = fopen(PHRASE_FILE.c_str(), "r");
-        if (phraseFile == NULL) {
-            throw FileNotFoundException(PHRASE_FILE);
+    }
+
+    void PhraseBook::Init(Font phraseFont, const std::string& indexFile)
+    {
+        StartLoad(phraseFont, indexFile);
+        WaitForLoad();
+    }
+
+    // Loads the phrases on a worker thread, so that the caller can get on
+    // with other things. WaitForLoad must be called before the phrasebook
+    // is used. The phrases are mapped from the index file if it is up to
+    // date, and parsed from the phrase file if not, or if indexFile is
+    // empty.
+    void PhraseBook::StartLoad(Font phraseFont, const std::string& indexFile)
+    {
+        m_corpus.reset();
+        m_stream.reset();
+        m_availChars.Clear();
+        m_loading = std::async(std::launch::async,
+                               &PhraseBook::Load, phraseFont,
+                               indexFile).share();
+    }
+
+    // Samples the phrases from a phrase file that may be too large to keep
+    // in memory, taking a new sample every refreshTime seconds (or only
+    // once, if refreshTime is 0). As with StartLoad, WaitForLoad must be
+    // called before the phrasebook is used.
+    void PhraseBook::StartStream(Font               phraseFont,
+                                 const std::string& phraseFile,
+                                 unsigned int       reservoirSize,
+                                 float              refreshTime)
+    {
+        m_corpus.reset();
+        m_loading = std::shared_future<CorpusPtr>();
+        m_availChars.Clear();
+        m_stream = StreamPtr(new Stream(phraseFont, phraseFile,
+                                        reservoirSize, refreshTime));
+    }
+
+    // Stops a streamed phrase file from being sampled again, keeping the
+    // phrases from the last sample.
+    void PhraseBook::StopStream()
+    {
+        if (m_stream) {
+            m_stream->Stop();
         }
+    }
 
-        char buffer[MAX_PHRASE_LENGTH];
-        while (fgets(buffer, MAX_PHRASE_LENGTH, phraseFile) != NULL) {
-            for (char *c = buffer;; c++) {
-                if (*c == '\r' || *c == '\n') {
-                    *c = '\0';
-                    AddPhrase(buffer);
-                } else if (!phraseFont.HasChar(*c)) {
-                    // Don't add the phrase if the font doesn't have
-                    // all the letters required.
-                    break;
-                }
+    // Blocks until the phrases started by StartLoad have loaded, rethrowing
+    // anything that went wrong while loading them.
+    void PhraseBook::WaitForLoad()
+    {
+        if (m_stream) {
+            if (!m_corpus) {
+                m_corpus = m_stream->WaitForCorpus(m_streamGeneration);
+                MakeAllCharsAvail();
             }
+            return;
+        }
+
+        if (!m_loading.valid()) {
+            return;
+        }
+
+        m_corpus = m_loading.get();
+        m_loading = std::shared_future<CorpusPtr>();
+        MakeAllCharsAvail();
+    }
+
+    PhraseBook::CorpusPtr PhraseBook::Load(Font phraseFont, std::string indexFile)
+    {
+        TraceScope trace("PhraseBook::Load");
+
+        std::shared_ptr<Corpus> corpus(new Corpus);
+        if (indexFile.empty() ||
+            !LoadIndex(*corpus, GetGlyphs(phraseFont),
+                       indexFile, PHRASE_FILE)) {
+            APP.Log(App::LOG_DEBUG,
+                    "No up to date phrase index, loading " + PHRASE_FILE);
+            LoadText(*corpus, phraseFont, PHRASE_FILE);
         }
 
-        fclose(phraseFile);
+        return corpus;
     }
 
-    const std::string& PhraseBook::GetPhrase(PhraseLength len)
+    // Builds the corpus from the phrase file, and writes it out as an index
+    // that later runs can map without parsing. Returns the number of phrases
+    // in the index.
+    unsigned int PhraseBook::CompileIndex(Font               phraseFont,
+                                          const std::string& phraseFile,
+                                          const std::string& indexFile)
     {
-        // We're returning a reference to avoid copying strings,
-        // so we need this to return a reference to in case of error
-        static const std::string defPhrase("default");
+        Corpus corpus;
+        LoadText(corpus, phraseFont, phraseFile);
+
+        IndexHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+        header.version = INDEX_VERSION;
+        header.glyphs  = GetGlyphs(phraseFont);
+        if (!GetSourceInfo(phraseFile, header.sourceSize, header.sourceTime)) {
+            throw FileNotFoundException(phraseFile);
+        }
+
+        // Only the valid phrases are kept, packed together in group order.
+        PhraseEntryVector entries(corpus.entryStore);
+        std::string       text;
+        for (PhraseEntry& entry : entries) {
+            const unsigned int offset = static_cast<unsigned int>(text.size());
+            text.append(corpus.text + entry.offset, entry.length);
+            entry.offset = offset;
+        }
+
+        header.entryCount = static_cast<uint32_t>(entries.size());
+        header.textSize   = static_cast<uint32_t>(text.size());
+
+        FILE *file = fopen(indexFile.c_str(), "wb");
+        if (!file) {
+            throw FileWriteException(indexFile);
+        }
+
+        bool written =
+            fwrite(&header, sizeof(header), 1, file) == 1 &&
+            fwrite(corpus.groups, sizeof(PhraseGroup),
+                   corpus.groupStore.size(), file) == corpus.groupStore.size();
+        if (written && !entries.empty()) {
+            written = fwrite(&entries[0], sizeof(PhraseEntry), entries.size(),
+                             file) == entries.size() &&
+                      fwrite(corpus.charBits, sizeof(uint64_t),
+                             corpus.charBitsStore.size(), file) ==
+                                                corpus.charBitsStore.size();
+        }
+        if (written && !text.empty()) {
+            written = fwrite(text.data(), 1, text.size(), file) == text.size();
+        }
+
+        if (fclose(file) != 0 || !written) {
+            throw FileWriteException(indexFile);
+        }
+
+        return header.entryCount;
+    }
+
+    // Shares the phrases loaded by another phrasebook, with all of their
+    // start characters available. If the other phrasebook is still loading,
+    // this waits for it to finish.
+    void PhraseBook::Share(const PhraseBook& book)
+    {
+        m_stream = book.m_stream;
+        if (m_stream) {
+            m_corpus = m_stream->WaitForCorpus(m_streamGeneration);
+        } else {
+            m_corpus = book.m_loading.valid() ? book.m_loading.get()
+                                              : book.m_corpus;
+        }
+        m_loading = std::shared_future<CorpusPtr>();
+        MakeAllCharsAvail();
+    }
+
+    PhraseView PhraseBook::GetPhrase(PhraseLength len)
+    {
+        CheckStream();
 
         if (UsingShortPhrases() && len > PL_SINGLE) {
             len = static_cast<PhraseLength>(static_cast<int>(len) - 1);
@@ -49,21 +197,20 @@ namespace typing
         // First pick a start character from the available ones.
         const char startChar = PickAvailChar();
         if (startChar == '\0') {
-            return defPhrase;
+            return "default";
         }
 
-        PhraseVectorPtr phraseVec = GetValidPhraseVector(startChar, len);
-        if (!phraseVec || phraseVec->empty()) {
-            return defPhrase;
+        const PhraseGroup& group = GetValidGroup(startChar, len);
+        if (group.count == 0) {
+            return "default";
         }
 
         // Mark the start char unavailable so we don't end up with two phrases
         // in use which both have the same start char.
         MakeCharUnavail(startChar);
 
-        // Select a random phrase from the vector of phrases.
-        unsigned int i = RAND.Range(0, static_cast<int>(phraseVec->size() - 1));
-        return *((*phraseVec)[i]);
+        // Select a random phrase from the group.
+        return PickPhrase(group);
     }
 
     const std::string PhraseBook::GetComboPhrase(unsigned int words,
@@ -71,156 +218,722 @@ namespace typing
     {
         std::string phrase;
 
+        CheckStream();
+
         if (UsingShortPhrases() && length > PL_SINGLE) {
             length = static_cast<PhraseLength>(static_cast<int>(length) - 1);
         }
 
         for (unsigned int i = 0; i < words; i++) {
             const char c = (i == 0 ? PickAvailChar() : PickRandomChar());
+            if (c == '\0') {
+                return "default";
+            }
 
-            PhraseVectorPtr phraseVec;
-            if (c != '\0' &&
-                (phraseVec = GetValidPhraseVector(c, length)) &&
-                !phraseVec->empty()) {
-                
-                if (!phrase.empty()) {
-                    phrase += " ";
-                }
-
-                phrase += *((*phraseVec)[
-                    RAND.Range(0, static_cast<int>(phraseVec->size() - 1))]);
-            } else {
+            const PhraseGroup& group = GetValidGroup(c, length);
+            if (group.count == 0) {
                 return "default";
             }
+
+            if (!phrase.empty()) {
+                phrase += " ";
+            }
+
+            const PhraseView word = PickPhrase(group);
+            phrase.append(word.data(), word.length());
         }
 
         MakeCharUnavail(phrase[0]);
         return (phrase);
     }
 
+    // Picks a random phrase matching the query, without reserving its start
+    // character. Returns false if there are no matching phrases.
+    bool PhraseBook::FindPhrase(const PhraseQuery& query,
+                                PhraseView&        phrase) const
+    {
+        if (!m_corpus->allChars.Contains(query.startChar)) {
+            return false;
+        }
+
+        // The groups for a start character are next to each other, so all
+        // of its phrases are one run.
+        const PhraseGroup& shortest = GetGroup(query.startChar, PL_SINGLE);
+        const PhraseGroup& longest  = GetGroup(query.startChar, PL_LONG);
+        return PickFromRun(shortest.first, longest.first + longest.count,
+                           query, phrase);
+    }
+
+    // Limits the phrases handed out by GetPhrase and GetComboPhrase to
+    // those within a range of difficulty, from 0 for the easiest in the
+    // corpus to 1 for the hardest. If a start character has no phrases in
+    // the range, its phrases of any difficulty are used instead.
+    void PhraseBook::SetDifficulty(float minDifficulty, float maxDifficulty)
+    {
+        m_minDifficulty = minDifficulty;
+        m_maxDifficulty = maxDifficulty;
+    }
+
     void PhraseBook::MakeCharAvail(char c)
     {
         // We should never try to make a char available that we don't have
         // any phrases for, as a phrasebook user should only attempt to
         // make chars available for phrases it has been given from the
-        // phrasebook.
-        assert(m_phrases.find(c) != m_phrases.end());
-        m_availChars.insert(c);
+        // phrasebook. The exception is a streamed corpus, whose latest
+        // sample may not have phrases for a char that an older one did, in
+        // which case the char stays unavailable.
+        if (m_stream && !m_corpus->allChars.Contains(c)) {
+            return;
+        }
+
+        assert(m_corpus->allChars.Contains(c));
+        m_availChars.Insert(c);
     }
 
+    // Start characters are picked from the set by position, so it is
+    // refilled from empty rather than topped up, to give each game the same
+    // order whatever the last game left behind.
     void PhraseBook::MakeAllCharsAvail()
     {
-        for (PhraseMap::iterator iter = m_phrases.begin();
-             iter != m_phrases.end();
-             ++iter) {
-            MakeCharAvail(iter->first);
+        m_availChars.Clear();
+        m_availChars.Insert(m_corpus->allChars);
+    }
+
+    // Picks up the latest sample from a streamed corpus, if there is a new
+    // one. Phrases already handed out are copies, so the old sample can go.
+    void PhraseBook::CheckStream()
+    {
+        if (!m_stream || !m_corpus ||
+            m_stream->GetGeneration() == m_streamGeneration) {
+            return;
+        }
+
+        const CorpusPtr old = m_corpus;
+        m_corpus = m_stream->GetCorpus(m_streamGeneration);
+
+        // Chars in use stay unavailable. Chars the new sample has no
+        // phrases for are dropped, and any it has that the old one didn't
+        // are made available.
+        const CharSet& allChars = m_corpus->allChars;
+        for (unsigned int i = m_availChars.Size(); i > 0; --i) {
+            const char c = m_availChars[i - 1];
+            if (!allChars.Contains(c)) {
+                m_availChars.Erase(c);
+            }
+        }
+
+        for (unsigned int i = 0; i < allChars.Size(); ++i) {
+            if (!old->allChars.Contains(allChars[i])) {
+                m_availChars.Insert(allChars[i]);
+            }
         }
     }
 
     void PhraseBook::MakeCharUnavail(char c)
     {
-        m_availChars.erase(c);
+        m_availChars.Erase(c);
     }
 
     char PhraseBook::PickAvailChar()
     {
-        if (m_availChars.empty()) {
+        if (m_availChars.Empty()) {
             return '\0';
         } else {
-            auto iter = m_availChars.begin();
-            std::advance(iter,
-                         RAND.Range(
-                                0, static_cast<int>(m_availChars.size() - 1)));
-            return *iter;
+            return m_availChars[RAND.Range(0u, m_availChars.Size() - 1)];
         }
     }
 
     char PhraseBook::PickRandomChar()
     {
-        if (m_allChars.empty()) {
+        const CharSet& allChars = m_corpus->allChars;
+        if (allChars.Empty()) {
             return '\0';
         } else {
-            auto iter = m_allChars.begin();
-            std::advance(iter,
-                         RAND.Range(
-                                0, static_cast<int>(m_allChars.size() - 1)));
-            return *iter;
+            return allChars[RAND.Range(0u, allChars.Size() - 1)];
         }
     }
 
-    void PhraseBook::AddPhrase(const std::string& phrase)
+    void PhraseBook::LoadText(Corpus&            corpus,
+                              Font&              phraseFont,
+                              const std::string& phraseFile)
     {
-        const unsigned int len = static_cast<unsigned int>(phrase.length());
-        if (len == 0)
-        {
-            return;
+        FILE * file = fopen(phraseFile.c_str(), "rb");
+        if (file == NULL) {
+            throw FileNotFoundException(phraseFile);
         }
 
-        const char startChar = phrase[0];
+        // The whole file is read into the arena in one go, and the phrases
+        // are left where they are. Lines that can't be used are skipped.
+        long size = -1;
+        if (fseek(file, 0, SEEK_END) == 0) {
+            size = ftell(file);
+        }
+        if (size < 0 || fseek(file, 0, SEEK_SET) != 0) {
+            fclose(file);
+            throw FileCorruptException(phraseFile + ": Unable to read");
+        }
 
-        // Create the arrays for this character if we don't already have them
-        if (m_phrases.find(startChar) == m_phrases.end())
-        {
-            m_phrases[startChar] = PhraseArrayPtr(new PhraseArray);
-            (*m_phrases[startChar])[PL_SINGLE] =
-                                        PhraseVectorPtr(new PhraseVector());
-            (*m_phrases[startChar])[PL_SHORT] =
-                                        PhraseVectorPtr(new PhraseVector());
-            (*m_phrases[startChar])[PL_MEDIUM] =
-                                        PhraseVectorPtr(new PhraseVector());
-            (*m_phrases[startChar])[PL_LONG] =
-                                        PhraseVectorPtr(new PhraseVector());
-        }
-
-        PhraseVectorPtr vec = GetPhraseVector(startChar, LengthToCategory(len));
-        if (vec)
-        {
-            PhrasePtr p(new std::string(phrase));
-            vec->push_back(p);
+        std::string& arena = corpus.arena;
+        arena.resize(static_cast<std::string::size_type>(size));
+        if (size > 0 &&
+            fread(&arena[0], 1, arena.size(), file) != arena.size()) {
+            fclose(file);
+            throw FileCorruptException(phraseFile + ": Unable to read");
+        }
+
+        fclose(file);
+
+        // Large files are split into chunks at line boundaries, which are
+        // parsed in parallel and then joined back up in file order. The last
+        // chunk is parsed on this thread.
+        const std::string::size_type chunkCount =
+            std::max<std::string::size_type>(
+                std::min<std::string::size_type>(
+                    std::thread::hardware_concurrency(),
+                    arena.size() / MIN_CHUNK_SIZE),
+                1);
+
+        std::vector<std::future<ParsedChunk> > chunks;
+        std::string::size_type                 chunkStart = 0;
+        for (std::string::size_type i = 1; i < chunkCount; ++i) {
+            std::string::size_type chunkEnd =
+                arena.find('\n', std::max(chunkStart,
+                                          arena.size() * i / chunkCount));
+            chunkEnd = (chunkEnd == std::string::npos ? arena.size()
+                                                      : chunkEnd + 1);
+
+            chunks.push_back(std::async(std::launch::async,
+                                        &PhraseBook::ParseChunk,
+                                        std::cref(arena), chunkStart, chunkEnd,
+                                        std::ref(phraseFont)));
+            chunkStart = chunkEnd;
+        }
+
+        const ParsedChunk last =
+            ParseChunk(arena, chunkStart, arena.size(), phraseFont);
+
+        std::vector<unsigned int> keys;
+        std::vector<float>        efforts;
+        for (std::future<ParsedChunk>& chunk : chunks) {
+            const ParsedChunk parsed = chunk.get();
+            corpus.entryStore.insert(corpus.entryStore.end(),
+                                     parsed.entries.begin(),
+                                     parsed.entries.end());
+            keys.insert(keys.end(), parsed.keys.begin(), parsed.keys.end());
+            efforts.insert(efforts.end(),
+                           parsed.efforts.begin(), parsed.efforts.end());
+        }
+        corpus.entryStore.insert(corpus.entryStore.end(),
+                                 last.entries.begin(), last.entries.end());
+        keys.insert(keys.end(), last.keys.begin(), last.keys.end());
+        efforts.insert(efforts.end(), last.efforts.begin(), last.efforts.end());
+
+        FinishCorpus(corpus, keys, efforts);
+    }
+
+    // Rates and sorts the entries of a corpus built in memory, given the
+    // group and typing effort of each entry, and makes it ready for use.
+    void PhraseBook::FinishCorpus(Corpus&                          corpus,
+                                  const std::vector<unsigned int>& keys,
+                                  const std::vector<float>&        efforts)
+    {
+        RateDifficulty(corpus.entryStore, efforts);
+        SortEntries(corpus, keys);
+
+        corpus.text    = corpus.arena.data();
+        corpus.entries = corpus.entryStore.data();
+        corpus.groups  = corpus.groupStore.data();
+        FindAllChars(corpus);
+        BuildCharBits(corpus);
+    }
+
+    PhraseBook::PhraseEntry PhraseBook::MakeEntry(const char             *text,
+                                                  std::string::size_type offset,
+                                                  unsigned int           length)
+    {
+        PhraseEntry entry;
+        entry.offset     = static_cast<uint32_t>(offset);
+        entry.length     = static_cast<uint16_t>(length);
+        entry.difficulty = 0;
+        entry.reserved   = 0;
+        entry.chars      = GetPhraseCharMask(text, length);
+        return entry;
+    }
+
+    // Finds the usable phrases in the lines between start and end, which
+    // must be the start of a line and the end of a line (or the file).
+    PhraseBook::ParsedChunk PhraseBook::ParseChunk(
+        const std::string&     arena,
+        std::string::size_type start,
+        std::string::size_type end,
+        Font&                  phraseFont)
+    {
+        ParsedChunk            chunk;
+        std::string::size_type lineStart = start;
+        while (lineStart < end) {
+            std::string::size_type lineEnd = arena.find('\n', lineStart);
+            if (lineEnd == std::string::npos || lineEnd > end) {
+                lineEnd = end;
+            }
+
+            const std::string::size_type next = lineEnd + 1;
+            if (lineEnd > lineStart && arena[lineEnd - 1] == '\r') {
+                --lineEnd;
+            }
+
+            // Don't add the phrase if the font doesn't have all the letters
+            // required.
+            const unsigned int len =
+                static_cast<unsigned int>(lineEnd - lineStart);
+            if (len > 0 && len < MAX_PHRASE_LENGTH &&
+                std::all_of(arena.begin() + lineStart, arena.begin() + lineEnd,
+                            [&](char c) { return phraseFont.HasChar(c); })) {
+                const char *text = arena.data() + lineStart;
+                chunk.entries.push_back(MakeEntry(text, lineStart, len));
+                chunk.efforts.push_back(RatePhraseEffort(text, len));
+
+                chunk.keys.push_back(GroupIndex(arena[lineStart],
+                                                LengthToCategory(len)));
+            }
+
+            lineStart = next;
+        }
+
+        return chunk;
+    }
+
+    bool PhraseBook::LoadIndex(Corpus&            corpus,
+                               const GlyphSet&    glyphs,
+                               const std::string& indexFile,
+                               const std::string& phraseFile)
+    {
+        if (!corpus.index.Open(indexFile)) {
+            return false;
+        }
 
-            MakeCharAvail(startChar);
+        if (!MapIndex(corpus, glyphs, phraseFile)) {
+            APP.Log(App::LOG_DEBUG, indexFile + " is out of date or invalid");
+            corpus.index.Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool PhraseBook::MapIndex(Corpus&            corpus,
+                              const GlyphSet&    glyphs,
+                              const std::string& phraseFile)
+    {
+        const char*  data = corpus.index.GetData();
+        const size_t size = corpus.index.GetSize();
+
+        IndexHeader header;
+        if (size < sizeof(header)) {
+            return false;
+        }
+        memcpy(&header, data, sizeof(header));
+
+        if (memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) ||
+            header.version != INDEX_VERSION ||
+            header.glyphs != glyphs) {
+            return false;
+        }
+
+        // An index can be shipped without the phrase file it was built
+        // from, but if the phrase file is there the index must match it.
+        uint64_t sourceSize;
+        int64_t  sourceTime;
+        if (GetSourceInfo(phraseFile, sourceSize, sourceTime) &&
+            (header.sourceSize != sourceSize ||
+             header.sourceTime != sourceTime)) {
+            return false;
+        }
+
+        const unsigned int bitWords = GetBitWords(header.entryCount);
+        const size_t groupsSize  = sizeof(PhraseGroup) * CHAR_COUNT * PL_COUNT;
+        const size_t entriesSize = sizeof(PhraseEntry) * header.entryCount;
+        const size_t bitsSize    = sizeof(uint64_t) * PCB_COUNT * bitWords;
+        if (size != sizeof(header) + groupsSize + entriesSize + bitsSize +
+                                                            header.textSize) {
+            return false;
+        }
+
+        corpus.groups     = reinterpret_cast<const PhraseGroup*>(
+                                data + sizeof(header));
+        corpus.entries    = reinterpret_cast<const PhraseEntry*>(
+                                data + sizeof(header) + groupsSize);
+        corpus.charBits   = reinterpret_cast<const uint64_t*>(
+                                data + sizeof(header) + groupsSize +
+                                entriesSize);
+        corpus.text       = data + sizeof(header) + groupsSize + entriesSize +
+                                                                    bitsSize;
+        corpus.entryCount = header.entryCount;
+        corpus.bitWords   = bitWords;
+
+        // Make sure nothing points outside of the index, so that a damaged
+        // index can't take the game down with it.
+        for (unsigned int i = 0; i < CHAR_COUNT * PL_COUNT; ++i) {
+            const PhraseGroup& group = corpus.groups[i];
+            if (group.first > header.entryCount ||
+                group.count > header.entryCount - group.first) {
+                return false;
+            }
+        }
+
+        for (unsigned int i = 0; i < header.entryCount; ++i) {
+            const PhraseEntry& entry = corpus.entries[i];
+            if (entry.chars >> PCB_COUNT ||
+                entry.length == 0 ||
+                entry.length >= MAX_PHRASE_LENGTH ||
+                entry.offset > header.textSize ||
+                entry.length > header.textSize - entry.offset) {
+                return false;
+            }
+        }
+
+        FindAllChars(corpus);
+        return true;
+    }
 
-            // Add the char to the list of all characters
-            m_allChars.insert(startChar);
+    bool PhraseBook::GetSourceInfo(const std::string& phraseFile,
+                                   uint64_t&          size,
+                                   int64_t&           time)
+    {
+        struct stat info;
+        if (stat(phraseFile.c_str(), &info) != 0) {
+            return false;
         }
+
+        size = static_cast<uint64_t>(info.st_size);
+        time = static_cast<int64_t>(info.st_mtime);
+        return true;
     }
 
-    PhraseBook::PhraseVectorPtr PhraseBook::GetPhraseVector(
-                                                    char         startChar,
-                                                    PhraseLength cat)
+    PhraseBook::GlyphSet PhraseBook::GetGlyphs(Font& phraseFont)
     {
-        PhraseVectorPtr vec;
+        GlyphSet glyphs;
+        glyphs.fill(0);
+
+        for (unsigned int c = 1; c < CHAR_COUNT; ++c) {
+            if (phraseFont.HasChar(static_cast<char>(c))) {
+                glyphs[c / 32] |= 1u << (c % 32);
+            }
+        }
+
+        return glyphs;
+    }
+
+    void PhraseBook::BuildCharBits(Corpus& corpus)
+    {
+        corpus.entryCount = static_cast<unsigned int>(corpus.entryStore.size());
+        corpus.bitWords   = GetBitWords(corpus.entryCount);
+        corpus.charBitsStore.assign(PCB_COUNT * corpus.bitWords, 0);
+
+        for (unsigned int i = 0; i < corpus.entryCount; ++i) {
+            const uint64_t entryBit = uint64_t(1) << (i % 64);
+            for (uint64_t chars = corpus.entryStore[i].chars;
+                 chars != 0;
+                 chars &= chars - 1) {
+                const unsigned int bit = __builtin_ctzll(chars);
+                corpus.charBitsStore[bit * corpus.bitWords + i / 64] |=
+                                                                    entryBit;
+            }
+        }
+
+        corpus.charBits = corpus.charBitsStore.data();
+    }
+
+    void PhraseBook::FindAllChars(Corpus& corpus)
+    {
+        corpus.allChars.Clear();
+        for (unsigned int c = 0; c < CHAR_COUNT; ++c) {
+            for (unsigned int cat = PL_SINGLE; cat < PL_COUNT; ++cat) {
+                if (corpus.groups[c * PL_COUNT + cat].count > 0) {
+                    corpus.allChars.Insert(static_cast<char>(c));
+                    break;
+                }
+            }
+        }
+    }
+
+    // Sorts the entries into their groups with a counting sort, then sorts
+    // each group by length and difficulty, keeping phrases that tie in file
+    // order.
+    void PhraseBook::SortEntries(Corpus&                          corpus,
+                                 const std::vector<unsigned int>& keys)
+    {
+        PhraseGroupArray& groups = corpus.groupStore;
+        for (PhraseGroup& group : groups) {
+            group.first = 0;
+            group.count = 0;
+        }
+
+        for (unsigned int key : keys) {
+            groups[key].count++;
+        }
+
+        std::vector<unsigned int> next(groups.size());
+        unsigned int              first = 0;
+        for (unsigned int i = 0; i < groups.size(); ++i) {
+            groups[i].first = first;
+            next[i] = first;
+            first += groups[i].count;
+        }
+
+        PhraseEntryVector sorted(corpus.entryStore.size());
+        for (unsigned int i = 0; i < keys.size(); ++i) {
+            sorted[next[keys[i]]++] = corpus.entryStore[i];
+        }
+        corpus.entryStore.swap(sorted);
+
+        for (const PhraseGroup& group : groups) {
+            std::stable_sort(corpus.entryStore.begin() + group.first,
+                             corpus.entryStore.begin() + group.first +
+                                 group.count,
+                             [](const PhraseEntry& a, const PhraseEntry& b) {
+                                 return SortKey(a) < SortKey(b);
+                             });
+        }
+    }
+
+    // Sets each entry's difficulty from its rank among all of the entries
+    // by typing effort, so that difficulties are spread evenly over the
+    // corpus whatever the phrases are like. Entries with the same effort
+    // get the same difficulty.
+    void PhraseBook::RateDifficulty(PhraseEntryVector&        entries,
+                                    const std::vector<float>& efforts)
+    {
+        std::vector<unsigned int> order(entries.size());
+        for (unsigned int i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
 
-        // We should never get a phrase vector for a start char that
-        // we don't have an array for.
-        assert(m_phrases.find(startChar) != m_phrases.end());
+        std::stable_sort(order.begin(), order.end(),
+                         [&](unsigned int a, unsigned int b) {
+                             return efforts[a] < efforts[b];
+                         });
+
+        const size_t last = order.empty() ? 0 : order.size() - 1;
+        size_t       rank = 0;
+        for (size_t i = 0; i < order.size(); ++i) {
+            if (i > 0 && efforts[order[i]] != efforts[order[i - 1]]) {
+                rank = i;
+            }
+
+            entries[order[i]].difficulty = static_cast<uint8_t>(
+                last > 0 ? rank * MAX_DIFFICULTY / last : 0);
+        }
+    }
+
+    const PhraseBook::PhraseGroup& PhraseBook::GetGroup(
+                                                char         startChar,
+                                                PhraseLength cat) const
+    {
+        // We should never get a group for a start char that we don't have
+        // any phrases for.
+        assert(m_corpus->allChars.Contains(startChar));
         assert(cat >= PL_SINGLE && cat < PL_COUNT);
-        vec = (*m_phrases[startChar])[cat];
 
-        return vec;
+        return m_corpus->groups[GroupIndex(startChar, cat)];
     }
 
-    PhraseBook::PhraseVectorPtr PhraseBook::GetValidPhraseVector(
+    const PhraseBook::PhraseGroup& PhraseBook::GetValidGroup(
                                                 char         startChar,
-                                                PhraseLength cat)
+                                                PhraseLength cat) const
     {
-        PhraseVectorPtr vec = GetPhraseVector(startChar, cat);
-        while (!vec || vec->empty()) {
+        const PhraseGroup* group = &GetGroup(startChar, cat);
+        while (group->count == 0) {
             APP.Log(App::LOG_DEBUG,
                     boost::str(boost::format(
                         "Couldn't find phrases for char %c category %u") %
                         startChar % cat));
 
             if (cat == PL_SINGLE) {
-                // We've failed to find a populated vector.
+                // We've failed to find a populated group.
                 break;
             } else {
                 cat = static_cast<PhraseLength>(static_cast<int>(cat) - 1);
             }
-            vec = (*m_phrases[startChar])[cat];
+            group = &GetGroup(startChar, cat);
         }
 
-        return vec;
+        return *group;
+    }
+
+    // Picks a phrase from the group within the difficulty set by
+    // SetDifficulty, or from the whole group if it has none that difficult.
+    PhraseView PhraseBook::PickPhrase(const PhraseGroup& group) const
+    {
+        const unsigned int end = group.first + group.count;
+        PhraseView         phrase;
+        if (!PickFromRun(group.first, end,
+                         PhraseQuery('\0', 0, MAX_PHRASE_LENGTH,
+                                     m_minDifficulty, m_maxDifficulty),
+                         phrase)) {
+            PickFromRun(group.first, end,
+                        PhraseQuery('\0', 0, MAX_PHRASE_LENGTH), phrase);
+        }
+
+        return phrase;
+    }
+
+    // Picks a random phrase matching the query from a run of entries, which
+    // must be sorted by length and difficulty. Each length within the
+    // query's range takes a few binary searches to find the phrases that
+    // are difficult enough, so picking doesn't depend on the corpus size.
+    // Excluded chars are then filtered out with the char bitsets, 64
+    // phrases at a time. Returns false if no phrase matches.
+    bool PhraseBook::PickFromRun(unsigned int       first,
+                                 unsigned int       end,
+                                 const PhraseQuery& query,
+                                 PhraseView&        phrase) const
+    {
+        const unsigned int minLength = std::max(query.minLength, 1u);
+        const unsigned int maxLength =
+            std::min(query.maxLength, MAX_PHRASE_LENGTH - 1);
+        const float        minDiff =
+            std::ceil(std::max(query.minDifficulty, 0.0f) * MAX_DIFFICULTY);
+        const float        maxDiff =
+            std::floor(std::min(query.maxDifficulty, 1.0f) * MAX_DIFFICULTY);
+        if (first >= end || minLength > maxLength || minDiff > maxDiff) {
+            return false;
+        }
+
+        const unsigned int minDifficulty = static_cast<unsigned int>(minDiff);
+        const unsigned int maxDifficulty = static_cast<unsigned int>(maxDiff);
+
+        const PhraseEntry* entries = m_corpus->entries;
+        auto lowerBound = [&](unsigned int from, unsigned int to,
+                              unsigned int key) {
+            return static_cast<unsigned int>(std::lower_bound(
+                entries + from, entries + to, key,
+                [](const PhraseEntry& e, unsigned int k) {
+                    return SortKey(e) < k;
+                }) - entries);
+        };
+
+        // Find the phrases of each length which are in the difficulty
+        // range. Only lengths that have phrases are visited.
+        std::array<PhraseGroup, MAX_PHRASE_LENGTH> runs;
+        unsigned int runCount = 0;
+        unsigned int total    = 0;
+        unsigned int pos      = lowerBound(first, end,
+                                           SortKey(minLength, 0));
+        const unsigned int stop =
+            lowerBound(pos, end, SortKey(maxLength + 1, 0));
+        while (pos < stop) {
+            const unsigned int len = entries[pos].length;
+            const unsigned int runStart =
+                lowerBound(pos, stop, SortKey(len, minDifficulty));
+            const unsigned int runEnd =
+                lowerBound(runStart, stop, SortKey(len, maxDifficulty + 1));
+
+            if (runEnd > runStart) {
+                runs[runCount].first = runStart;
+                runs[runCount].count = runEnd - runStart;
+                total += runs[runCount].count;
+                runCount++;
+            }
+
+            pos = lowerBound(runEnd, stop, SortKey(len + 1, 0));
+        }
+
+        // Count what is left of each run once phrases using the excluded
+        // chars are taken out. Chars that no phrase can use don't count.
+        const uint64_t exclude =
+            query.excludeChars & ((uint64_t(1) << PCB_COUNT) - 1);
+        std::array<unsigned int, MAX_PHRASE_LENGTH> counts;
+        for (unsigned int r = 0; r < runCount; ++r) {
+            counts[r] = runs[r].count;
+        }
+        if (exclude != 0) {
+            total = 0;
+            for (unsigned int r = 0; r < runCount; ++r) {
+                counts[r] = CountAllowed(runs[r], exclude);
+                total += counts[r];
+            }
+        }
+
+        if (total == 0) {
+            return false;
+        }
+
+        // Pick one at random.
+        unsigned int n = RAND.Range(0u, total - 1);
+        unsigned int run = 0;
+        while (n >= counts[run]) {
+            n -= counts[run];
+            run++;
+        }
+
+        const PhraseEntry& entry =
+            entries[exclude != 0 ? FindAllowed(runs[run], exclude, n)
+                                 : runs[run].first + n];
+        phrase = PhraseView(m_corpus->text + entry.offset, entry.length);
+        return true;
+    }
+
+    // Returns the bits of one word of the char bitsets for the entries in
+    // the run which use none of the excluded chars.
+    uint64_t PhraseBook::AllowedBits(const PhraseGroup& run,
+                                     unsigned int       word,
+                                     uint64_t           exclude) const
+    {
+        const unsigned int end = run.first + run.count;
+
+        uint64_t used = 0;
+        for (; exclude != 0; exclude &= exclude - 1) {
+            const unsigned int bit = __builtin_ctzll(exclude);
+            used |= m_corpus->charBits[bit * m_corpus->bitWords + word];
+        }
+
+        uint64_t bits = ~used;
+        if (word == run.first / 64) {
+            bits &= ~uint64_t(0) << (run.first % 64);
+        }
+        if (word == (end - 1) / 64 && end % 64 != 0) {
+            bits &= (uint64_t(1) << (end % 64)) - 1;
+        }
+
+        return bits;
+    }
+
+    unsigned int PhraseBook::CountAllowed(const PhraseGroup& run,
+                                          uint64_t           exclude) const
+    {
+        if (run.count == 0) {
+            return 0;
+        }
+
+        unsigned int count = 0;
+        const unsigned int last = (run.first + run.count - 1) / 64;
+        for (unsigned int word = run.first / 64; word <= last; ++word) {
+            count += __builtin_popcountll(AllowedBits(run, word, exclude));
+        }
+
+        return count;
+    }
+
+    // Returns the index of the nth entry in the run which uses none of the
+    // excluded chars. There must be more than n of them.
+    unsigned int PhraseBook::FindAllowed(const PhraseGroup& run,
+                                         uint64_t           exclude,
+                                         unsigned int       n) const
+    {
+        for (unsigned int word = run.first / 64; ; ++word) {
+            uint64_t bits = AllowedBits(run, word, exclude);
+
+            const unsigned int count = __builtin_popcountll(bits);
+            if (n >= count) {
+                n -= count;
+                continue;
+            }
+
+            for (; n > 0; --n) {
+                bits &= bits - 1;
+            }
+            return word * 64 + __builtin_ctzll(bits);
+        }
     }
 
     PhraseBook::PhraseLength PhraseBook::LengthToCategory(unsigned int len)
@@ -241,16 +954,13 @@ namespace typing
     void PhraseBook::DrawChars(const std::string &font, float y, float height)
     {
         float x = 0.0f;
-        for (PhraseMap::iterator iter = m_phrases.begin(); iter != m_phrases.end(); ++iter)
+        for (unsigned int i = 0; i < m_corpus->allChars.Size(); ++i)
         {
-            PhraseVectorPtr vec = (*iter->second)[PL_SINGLE];
-            std::string str = *((*vec)[0]);
-
             char c[2];
-            c[0] = str[0];
+            c[0] = m_corpus->allChars[i];
             c[1] = '\0';
 
-            bool avail = (std::find(m_availChars.begin(), m_availChars.end(), c[0]) != m_availChars.end());
+            bool avail = m_availChars.Contains(c[0]);
             
             FONTS.Print(font, x, y, height, avail ? ColourRGBA::White() : ColourRGBA::Red(), Font::ALIGN_LEFT, c);
 
@@ -1,16 +1,45 @@
 #ifndef __PHRASE_BOOK_H__
 #define __PHRASE_BOOK_H__
 
-#include <set>
+#include <stdint.h>
 #include <vector>
 #include <string>
-#include <map>
 #include <memory>
 #include <array>
+#include <future>
 #include "FontManager.h"
+#include "Phrase.h"
+#include "MappedFile.h"
+#include "CharSet.h"
 
 namespace typing
 {
+    // What a phrase picked by PhraseBook::FindPhrase must look like. The
+    // lengths are inclusive, and difficulty runs from 0 for the easiest
+    // phrases in the corpus to 1 for the hardest. Phrases using any of the
+    // excluded chars (see PhraseCharBits) are skipped.
+    struct PhraseQuery
+    {
+        PhraseQuery(char         start,
+                    unsigned int minLen,
+                    unsigned int maxLen,
+                    float        minDiff = 0.0f,
+                    float        maxDiff = 1.0f,
+                    uint64_t     exclude = 0)
+            : startChar(start), minLength(minLen), maxLength(maxLen),
+              minDifficulty(minDiff), maxDifficulty(maxDiff),
+              excludeChars(exclude)
+        {
+        }
+
+        char         startChar;
+        unsigned int minLength;
+        unsigned int maxLength;
+        float        minDifficulty;
+        float        maxDifficulty;
+        uint64_t     excludeChars;
+    };
+
     class PhraseBook
     {
     public:
@@ -22,13 +51,39 @@ namespace typing
             PL_LONG,
             PL_COUNT };
 
+        static const std::string  PHRASE_FILE;
+        static const std::string  PHRASE_INDEX_FILE;
+
+        // Ctors/Dtors
+        PhraseBook();
+
         // Methods
-        void               Init(Font phraseFont);
-        const std::string& GetPhrase(PhraseLength length);
+        static unsigned int CompileIndex(Font               phraseFont,
+                                         const std::string& phraseFile,
+                                         const std::string& indexFile);
+
+        void               Init(Font               phraseFont,
+                                const std::string& indexFile =
+                                                        PHRASE_INDEX_FILE);
+        void               StartLoad(Font               phraseFont,
+                                     const std::string& indexFile =
+                                                        PHRASE_INDEX_FILE);
+        void               StartStream(Font               phraseFont,
+                                       const std::string& phraseFile,
+                                       unsigned int       reservoirSize,
+                                       float              refreshTime);
+        void               WaitForLoad();
+        void               StopStream();
+        void               Share(const PhraseBook& book);
+        PhraseView         GetPhrase(PhraseLength length);
         const std::string  GetComboPhrase(unsigned int words,
                                           PhraseLength length);
         void               MakeCharAvail(char c);
         void               MakeAllCharsAvail();
+        bool               FindPhrase(const PhraseQuery& query,
+                                      PhraseView&        phrase) const;
+        void               SetDifficulty(float minDifficulty,
+                                         float maxDifficulty);
 
         void UseShortPhrases()
         {
@@ -50,35 +105,198 @@ namespace typing
 #endif
 
     private:
-        // Typedefs
-        typedef std::shared_ptr<std::string>          PhrasePtr;
-        typedef std::vector<PhrasePtr>                PhraseVector;
-        typedef std::shared_ptr<PhraseVector>         PhraseVectorPtr;
-        typedef std::array<PhraseVectorPtr, PL_COUNT> PhraseArray;
-        typedef std::shared_ptr<PhraseArray>          PhraseArrayPtr;
-        typedef std::map<char, PhraseArrayPtr>        PhraseMap;
-
         // Consts/Enums
         static const unsigned int SINGLE_PHRASE_LENGTH = 1;
         static const unsigned int SHORT_PHRASE_LENGTH  = 6;
         static const unsigned int MEDIUM_PHRASE_LENGTH = 12;
         static const unsigned int MAX_PHRASE_LENGTH    = 128;
-        static const std::string  PHRASE_FILE;
+        static const unsigned int CHAR_COUNT           = 256;
+        static const unsigned int MIN_CHUNK_SIZE       = 256 * 1024;
+        static const unsigned int GLYPH_WORDS          = CHAR_COUNT / 32;
+        static const unsigned int MAX_DIFFICULTY       = 255;
+        static const unsigned int INDEX_VERSION        = 3;
+        static const char         INDEX_MAGIC[4];
+
+        // Typedefs
+        // A phrase is a slice of the corpus arena, along with the features
+        // that phrases are picked by. The difficulty is the phrase's rank in
+        // the corpus by typing effort, scaled to 0 - MAX_DIFFICULTY.
+        struct PhraseEntry
+        {
+            uint32_t offset;
+            uint16_t length;
+            uint8_t  difficulty;
+            uint8_t  reserved;
+            uint64_t chars;
+        };
+        typedef std::vector<PhraseEntry> PhraseEntryVector;
+
+        // The run of entries holding the phrases for one start character
+        // and length category, sorted by length and then difficulty.
+        struct PhraseGroup
+        {
+            unsigned int first;
+            unsigned int count;
+        };
+        typedef std::array<PhraseGroup, CHAR_COUNT * PL_COUNT> PhraseGroupArray;
+
+        // One bit for each character the font can draw.
+        typedef std::array<uint32_t, GLYPH_WORDS> GlyphSet;
+
+        // The phrases themselves never change once loaded, so they are
+        // shared between phrasebooks. Only the available characters belong
+        // to each phrasebook.
+        //
+        // All of the text lives in one arena, and the entries are sorted by
+        // start character then category, so each group is a contiguous run.
+        // The arena, entries and groups are either built from the phrase
+        // file or mapped straight from a compiled index.
+        //
+        // For each of the PhraseCharBits there is a bitset with a bit for
+        // every entry, set if the entry uses that char. They are stored one
+        // after the other, bitWords words each, so that phrases can be
+        // filtered by the chars they use 64 at a time.
+        struct Corpus
+        {
+            Corpus()
+                : text(NULL), entries(NULL), groups(NULL), charBits(NULL),
+                  entryCount(0), bitWords(0)
+            {
+            }
+
+            const char*        text;
+            const PhraseEntry* entries;
+            const PhraseGroup* groups;
+            const uint64_t*    charBits;
+            unsigned int       entryCount;
+            unsigned int       bitWords;
+            CharSet            allChars;
+
+            // Storage for a corpus built from the phrase file.
+            std::string           arena;
+            PhraseEntryVector     entryStore;
+            PhraseGroupArray      groupStore;
+            std::vector<uint64_t> charBitsStore;
+
+            // Storage for a corpus mapped from an index.
+            MappedFile         index;
+        };
+        typedef std::shared_ptr<const Corpus> CorpusPtr;
+
+        // Samples phrases from a phrase file in the background, for files
+        // too large to keep in memory.
+        class Stream;
+        typedef std::shared_ptr<Stream> StreamPtr;
+
+        // The phrases found in one chunk of the phrase file, with the group
+        // each one belongs in.
+        struct ParsedChunk
+        {
+            PhraseEntryVector         entries;
+            std::vector<unsigned int> keys;
+            std::vector<float>        efforts;
+        };
+
+        // A compiled index is this header, followed by the groups, the
+        // entries, the char bitsets and then the arena holding just the
+        // valid phrases. The
+        // source's size and modification time, and the glyphs the phrases
+        // were checked against, tell whether the index is still valid.
+        struct IndexHeader
+        {
+            char     magic[4];
+            uint32_t version;
+            uint64_t sourceSize;
+            int64_t  sourceTime;
+            GlyphSet glyphs;
+            uint32_t entryCount;
+            uint32_t textSize;
+        };
 
         // Methods
-        PhraseVectorPtr GetPhraseVector(char startChar, PhraseLength cat);
-        PhraseVectorPtr GetValidPhraseVector(char startChar, PhraseLength cat);
-        PhraseLength    LengthToCategory(unsigned int len);
-        void            AddPhrase(const std::string& phrase);
-        void            MakeCharUnavail(char c);
-        char            PickAvailChar();
-        char            PickRandomChar();
+        static unsigned int GroupIndex(char startChar, PhraseLength cat)
+        {
+            return static_cast<unsigned char>(startChar) * PL_COUNT + cat;
+        }
+
+        // Entries within a group are sorted by this key.
+        static unsigned int SortKey(unsigned int length,
+                                    unsigned int difficulty)
+        {
+            return length * (MAX_DIFFICULTY + 1) + difficulty;
+        }
+
+        static unsigned int SortKey(const PhraseEntry& entry)
+        {
+            return SortKey(entry.length, entry.difficulty);
+        }
+
+        const PhraseGroup&  GetGroup(char startChar, PhraseLength cat) const;
+        const PhraseGroup&  GetValidGroup(char         startChar,
+                                          PhraseLength cat) const;
+        PhraseView          PickPhrase(const PhraseGroup& group) const;
+        bool                PickFromRun(unsigned int       first,
+                                        unsigned int       end,
+                                        const PhraseQuery& query,
+                                        PhraseView&        phrase) const;
+        uint64_t            AllowedBits(const PhraseGroup& run,
+                                        unsigned int       word,
+                                        uint64_t           exclude) const;
+        unsigned int        CountAllowed(const PhraseGroup& run,
+                                         uint64_t           exclude) const;
+        unsigned int        FindAllowed(const PhraseGroup& run,
+                                        uint64_t           exclude,
+                                        unsigned int       n) const;
+        static void         RateDifficulty(PhraseEntryVector&        entries,
+                                           const std::vector<float>& efforts);
+        static PhraseLength LengthToCategory(unsigned int len);
+        static void         SortEntries(Corpus&                           corpus,
+                                        const std::vector<unsigned int>&  keys);
+        static CorpusPtr    Load(Font phraseFont, std::string indexFile);
+        static ParsedChunk  ParseChunk(const std::string&     arena,
+                                       std::string::size_type start,
+                                       std::string::size_type end,
+                                       Font&                  phraseFont);
+        static void         LoadText(Corpus&            corpus,
+                                     Font&              phraseFont,
+                                     const std::string& phraseFile);
+        static bool         LoadIndex(Corpus&            corpus,
+                                      const GlyphSet&    glyphs,
+                                      const std::string& indexFile,
+                                      const std::string& phraseFile);
+        static bool         MapIndex(Corpus&            corpus,
+                                     const GlyphSet&    glyphs,
+                                     const std::string& phraseFile);
+        static bool         GetSourceInfo(const std::string& phraseFile,
+                                          uint64_t&          size,
+                                          int64_t&           time);
+        static GlyphSet     GetGlyphs(Font& phraseFont);
+        static void         FindAllChars(Corpus& corpus);
+        static void         BuildCharBits(Corpus& corpus);
+        static unsigned int GetBitWords(unsigned int entryCount)
+        {
+            return (entryCount + 63) / 64;
+        }
+        static void         FinishCorpus(Corpus&                          corpus,
+                                         const std::vector<unsigned int>& keys,
+                                         const std::vector<float>&        efforts);
+        static PhraseEntry  MakeEntry(const char             *text,
+                                      std::string::size_type offset,
+                                      unsigned int           length);
+        void                CheckStream();
+        void                MakeCharUnavail(char c);
+        char                PickAvailChar();
+        char                PickRandomChar();
 
         // Members
-        PhraseMap      m_phrases;
-        std::set<char> m_availChars;
-        std::set<char> m_allChars; 
-        bool           m_shortPhrases;
+        CorpusPtr                     m_corpus;
+        std::shared_future<CorpusPtr> m_loading;
+        StreamPtr                     m_stream;
+        unsigned int                  m_streamGeneration;
+        CharSet                       m_availChars;
+        bool                          m_shortPhrases;
+        float                         m_minDifficulty;
+        float                         m_maxDifficulty;
     };
 }
 
@@ -0,0 +1,196 @@
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include "PhraseFeatures.h"
+
+namespace typing
+{
+    namespace
+    {
+        // Where each key sits on a US QWERTY keyboard, in key widths, and
+        // whether shift is needed to type it. The home row is row 2.
+        struct KeyInfo
+        {
+            bool  known;
+            bool  shifted;
+            float x;
+            float row;
+        };
+
+        const float HOME_ROW            = 2.0f;
+        const float SPACE_ROW           = 4.0f;
+        const float SPACE_X             = 7.0f;
+        const float RIGHT_HAND_X        = 6.5f;
+        const float ROW_REACH_COST      = 0.5f;
+        const float SHIFT_COST          = 1.0f;
+        const float UNKNOWN_COST        = 3.0f;
+        const float REPEAT_COST         = 0.5f;
+        const float ALTERNATE_SCALE     = 0.5f;
+        const float COMMON_BIGRAM_SCALE = 0.6f;
+
+        // The most common letter pairs in English text, which are typed
+        // fluently even when the keys are some way apart.
+        const char *const COMMON_BIGRAMS[] = {
+            "th", "he", "in", "er", "an", "re", "on", "at", "en", "nd",
+            "ti", "es", "or", "te", "of", "ed", "is", "it", "al", "ar",
+            "st", "to", "nt", "ng", "se", "ha", "as", "ou", "io", "le",
+            "ve", "co", "me", "de", "hi", "ri", "ro", "ic", "ne", "ea",
+            "ra", "ce", "li", "ch", "ll", "be", "ma", "si", "om", "ur"
+        };
+
+        class Keyboard
+        {
+        public:
+            Keyboard()
+            {
+                memset(m_keys, 0, sizeof(m_keys));
+                memset(m_common, 0, sizeof(m_common));
+
+                AddRow("`1234567890-=", "~!@#$%^&*()_+", 0.0f, 0.0f);
+                AddRow("qwertyuiop[]\\", "QWERTYUIOP{}|", 1.5f, 1.0f);
+                AddRow("asdfghjkl;'", "ASDFGHJKL:\"", 1.75f, 2.0f);
+                AddRow("zxcvbnm,./", "ZXCVBNM<>?", 2.25f, 3.0f);
+                AddKey(' ', false, SPACE_X, SPACE_ROW);
+
+                for (const char *bigram : COMMON_BIGRAMS) {
+                    m_common[bigram[0] - 'a'][bigram[1] - 'a'] = true;
+                }
+            }
+
+            const KeyInfo& GetKey(char c) const
+            {
+                return m_keys[static_cast<unsigned char>(c)];
+            }
+
+            bool IsCommon(char a, char b) const
+            {
+                a = static_cast<char>(tolower(static_cast<unsigned char>(a)));
+                b = static_cast<char>(tolower(static_cast<unsigned char>(b)));
+                return a >= 'a' && a <= 'z' && b >= 'a' && b <= 'z' &&
+                       m_common[a - 'a'][b - 'a'];
+            }
+
+        private:
+            void AddRow(const char *keys, const char *shiftedKeys,
+                        float x, float row)
+            {
+                for (unsigned int i = 0; keys[i] != '\0'; ++i) {
+                    AddKey(keys[i], false, x + i, row);
+                    AddKey(shiftedKeys[i], true, x + i, row);
+                }
+            }
+
+            void AddKey(char c, bool shifted, float x, float row)
+            {
+                KeyInfo& key = m_keys[static_cast<unsigned char>(c)];
+                key.known   = true;
+                key.shifted = shifted;
+                key.x       = x;
+                key.row     = row;
+            }
+
+            KeyInfo m_keys[256];
+            bool    m_common[26][26];
+        };
+
+        const Keyboard& GetKeyboard()
+        {
+            static const Keyboard keyboard;
+            return keyboard;
+        }
+
+        // The cost of reaching a key from the home row.
+        float ReachCost(const KeyInfo& key)
+        {
+            if (!key.known) {
+                return UNKNOWN_COST;
+            }
+
+            float cost = 0.0f;
+            if (key.row != SPACE_ROW) {
+                cost += fabsf(key.row - HOME_ROW) * ROW_REACH_COST;
+            }
+            if (key.shifted) {
+                cost += SHIFT_COST;
+            }
+
+            return cost;
+        }
+
+        // The cost of moving from one key to the next. Moving between hands
+        // or to and from the space bar is cheaper, as the next key can be
+        // lined up while the last one is pressed.
+        float MoveCost(const Keyboard& keyboard, char a, char b)
+        {
+            const KeyInfo& from = keyboard.GetKey(a);
+            const KeyInfo& to   = keyboard.GetKey(b);
+            if (!from.known || !to.known) {
+                return UNKNOWN_COST;
+            }
+
+            if (from.x == to.x && from.row == to.row) {
+                return REPEAT_COST;
+            }
+
+            const float dx   = to.x - from.x;
+            const float dy   = to.row - from.row;
+            float       cost = sqrtf(dx * dx + dy * dy);
+
+            const bool fromRight = from.x >= RIGHT_HAND_X;
+            const bool toRight   = to.x >= RIGHT_HAND_X;
+            if (from.row == SPACE_ROW || to.row == SPACE_ROW ||
+                fromRight != toRight) {
+                cost *= ALTERNATE_SCALE;
+            }
+
+            if (keyboard.IsCommon(a, b)) {
+                cost *= COMMON_BIGRAM_SCALE;
+            }
+
+            return cost;
+        }
+    }
+
+    uint64_t GetPhraseCharMask(const char *text, unsigned int length)
+    {
+        uint64_t mask = 0;
+        for (unsigned int i = 0; i < length; ++i) {
+            const unsigned char c = static_cast<unsigned char>(text[i]);
+            if (isupper(c)) {
+                mask |= (1ull << PCB_UPPER) |
+                        (1ull << (PCB_LETTERS + (tolower(c) - 'a')));
+            } else if (islower(c)) {
+                mask |= 1ull << (PCB_LETTERS + (c - 'a'));
+            } else if (isdigit(c)) {
+                mask |= 1ull << (PCB_DIGITS + (c - '0'));
+            } else if (c == ' ') {
+                mask |= 1ull << PCB_SPACE;
+            } else if (ispunct(c)) {
+                mask |= 1ull << PCB_PUNCTUATION;
+            } else {
+                mask |= 1ull << PCB_OTHER;
+            }
+        }
+
+        return mask;
+    }
+
+    float RatePhraseEffort(const char *text, unsigned int length)
+    {
+        if (length == 0) {
+            return 0.0f;
+        }
+
+        const Keyboard& keyboard = GetKeyboard();
+
+        float effort = 0.0f;
+        for (unsigned int i = 0; i < length; ++i) {
+            effort += ReachCost(keyboard.GetKey(text[i]));
+            if (i > 0) {
+                effort += MoveCost(keyboard, text[i - 1], text[i]);
+            }
+        }
+
+        return effort / length;
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef _PHRASE_FEATURES_H_
+#define _PHRASE_FEATURES_H_
+
+#include <stdint.h>
+
+namespace typing
+{
+    // Bits in a phrase's char mask. Letters are folded to lower case, and
+    // each letter and digit has a bit of its own.
+    enum PhraseCharBits
+    {
+        PCB_LETTERS     = 0,    // 'a' to 'z' are bits 0 to 25
+        PCB_DIGITS      = 26,   // '0' to '9' are bits 26 to 35
+        PCB_SPACE       = 36,
+        PCB_UPPER       = 37,
+        PCB_PUNCTUATION = 38,
+        PCB_OTHER       = 39,
+        PCB_COUNT       = 40
+    };
+
+    // Returns the mask of PhraseCharBits for the chars in the text.
+    uint64_t GetPhraseCharMask(const char *text, unsigned int length);
+
+    // Rates how awkward the text is to type, from how far each key is from
+    // the home row, how far the fingers travel between keys, whether the
+    // hands alternate and how common each pair of letters is in English.
+    // The rating is an average over the text, so it doesn't depend on the
+    // length, and is only meaningful compared with other ratings.
+    float RatePhraseEffort(const char *text, unsigned int length);
+}
+
+#endif // _PHRASE_FEATURES_H_
@@ -0,0 +1,213 @@
+#include <cstring>
+#include <algorithm>
+#include <zlib.h>
+#include "App.h"
+#include "PhraseStream.h"
+#include "PhraseFeatures.h"
+#include "Exceptions.h"
+#include "Trace.h"
+
+namespace typing
+{
+    // zlib's read buffer. The default is small for files this size.
+    static const unsigned int STREAM_BUFFER_SIZE = 128 * 1024;
+
+    // How many lines are read between checks for the stream being stopped.
+    static const unsigned int STOP_CHECK_LINES = 4096;
+
+    PhraseBook::Stream::Stream(Font               phraseFont,
+                               const std::string& phraseFile,
+                               unsigned int       reservoirSize,
+                               float              refreshTime)
+        : m_font(phraseFont), m_file(phraseFile),
+          m_reservoirSize(std::max(reservoirSize, 1u)),
+          m_refreshTime(static_cast<long>(std::max(refreshTime, 0.0f) *
+                                          1000.0f)),
+          m_random(std::random_device()()), m_generation(0),
+          m_stopping(false)
+    {
+        m_thread = std::thread(&Stream::Run, this);
+    }
+
+    PhraseBook::Stream::~Stream()
+    {
+        Stop();
+    }
+
+    // Stops sampling, abandoning any sample part way through, and waits for
+    // the stream's thread to finish. The last sample taken stays in use.
+    void PhraseBook::Stream::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+
+        m_changed.notify_all();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    // Returns the latest sample, and its generation.
+    PhraseBook::CorpusPtr PhraseBook::Stream::GetCorpus(
+                                                unsigned int& generation)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        generation = m_generation;
+        return m_corpus;
+    }
+
+    // Returns the latest sample and its generation, waiting for the first
+    // one if need be. Throws if the first sample couldn't be taken.
+    PhraseBook::CorpusPtr PhraseBook::Stream::WaitForCorpus(
+                                                unsigned int& generation)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_changed.wait(lock, [this]() { return m_corpus || m_error; });
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
+
+        generation = m_generation;
+        return m_corpus;
+    }
+
+    void PhraseBook::Stream::Run()
+    {
+        for (;;) {
+            try {
+                const CorpusPtr corpus = Sample();
+                if (!corpus) {
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_corpus = corpus;
+                m_generation++;
+            } catch (std::exception& e) {
+                // A failed refresh leaves the last sample in use, but if
+                // there isn't one yet there's nothing to play with.
+                std::lock_guard<std::mutex> lock(m_mutex);
+                APP.Log(App::LOG_ERROR, m_file + ": " + e.what());
+                if (!m_corpus) {
+                    m_error = std::current_exception();
+                    m_changed.notify_all();
+                    return;
+                }
+            }
+
+            m_changed.notify_all();
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            auto stopping = [this]() -> bool { return m_stopping; };
+            if (m_refreshTime.count() == 0) {
+                m_changed.wait(lock, stopping);
+            } else {
+                m_changed.wait_for(lock, m_refreshTime, stopping);
+            }
+
+            if (m_stopping) {
+                return;
+            }
+        }
+    }
+
+    // Reads the whole file, keeping a random sample of the usable phrases
+    // for each group, and builds a corpus from the sample. Returns no corpus
+    // if the stream was stopped part way through.
+    PhraseBook::CorpusPtr PhraseBook::Stream::Sample()
+    {
+        TraceScope trace("PhraseBook::Stream::Sample");
+
+        gzFile file = gzopen(m_file.c_str(), "rb");
+        if (!file) {
+            throw FileNotFoundException(m_file);
+        }
+        gzbuffer(file, STREAM_BUFFER_SIZE);
+
+        std::vector<Reservoir>    reservoirs(CHAR_COUNT * PL_COUNT);
+        std::vector<unsigned int> seen(reservoirs.size(), 0);
+
+        // Lines too long to be phrases are read in pieces and skipped.
+        char         line[MAX_PHRASE_LENGTH + 2];
+        bool         partial = false;
+        unsigned int lines   = 0;
+        while (gzgets(file, line, sizeof(line)) != NULL) {
+            if (++lines % STOP_CHECK_LINES == 0 && m_stopping) {
+                gzclose(file);
+                return CorpusPtr();
+            }
+
+            unsigned int len     = static_cast<unsigned int>(strlen(line));
+            const bool   skip    = partial;
+            const bool   lineEnd = (len > 0 && line[len - 1] == '\n');
+
+            partial = !lineEnd && !gzeof(file);
+            if (skip || partial) {
+                continue;
+            }
+
+            while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) {
+                --len;
+            }
+
+            // Don't add the phrase if the font doesn't have all the letters
+            // required.
+            if (len > 0 && len < MAX_PHRASE_LENGTH &&
+                std::all_of(line, line + len,
+                            [this](char c) { return m_font.HasChar(c); })) {
+                const unsigned int key =
+                    GroupIndex(line[0], LengthToCategory(len));
+                AddToReservoir(reservoirs[key], seen[key], line, len);
+            }
+        }
+
+        int errorCode = Z_OK;
+        const char *error = gzerror(file, &errorCode);
+        const std::string message(errorCode == Z_OK ? "" : error);
+        gzclose(file);
+        if (errorCode != Z_OK && errorCode != Z_STREAM_END) {
+            throw FileCorruptException(m_file + ": " + message);
+        }
+
+        std::shared_ptr<Corpus>   corpus(new Corpus);
+        std::vector<unsigned int> keys;
+        std::vector<float>        efforts;
+        for (unsigned int key = 0; key < reservoirs.size(); ++key) {
+            for (const std::string& phrase : reservoirs[key]) {
+                const unsigned int len =
+                    static_cast<unsigned int>(phrase.length());
+
+                corpus->entryStore.push_back(
+                    MakeEntry(phrase.data(), corpus->arena.size(), len));
+                corpus->arena.append(phrase);
+                keys.push_back(key);
+                efforts.push_back(RatePhraseEffort(phrase.data(), len));
+            }
+        }
+
+        FinishCorpus(*corpus, keys, efforts);
+        return corpus;
+    }
+
+    // Keeps each of the phrases seen so far for a group in the reservoir
+    // with equal chance.
+    void PhraseBook::Stream::AddToReservoir(Reservoir&    reservoir,
+                                            unsigned int& seen,
+                                            const char   *text,
+                                            unsigned int  length)
+    {
+        seen++;
+        if (reservoir.size() < m_reservoirSize) {
+            reservoir.push_back(std::string(text, length));
+            return;
+        }
+
+        std::uniform_int_distribution<unsigned int> pick(0, seen - 1);
+        const unsigned int slot = pick(m_random);
+        if (slot < m_reservoirSize) {
+            reservoir[slot].assign(text, length);
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef _PHRASE_STREAM_H_
+#define _PHRASE_STREAM_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include "PhraseBook.h"
+
+namespace typing
+{
+    // Keeps a random sample of a phrase file in memory, so that files of
+    // any size can be used. The file, which may be gzipped, is read once
+    // per sample, keeping a reservoir of at most reservoirSize phrases for
+    // each start character and length category. A new sample is taken
+    // every refreshTime seconds on a thread of the stream's own, and each
+    // sample is handed out as a corpus of its own.
+    class PhraseBook::Stream
+    {
+    public:
+        // Ctors/Dtors
+        Stream(Font               phraseFont,
+               const std::string& phraseFile,
+               unsigned int       reservoirSize,
+               float              refreshTime);
+        ~Stream();
+
+        // Methods
+        void      Stop();
+        CorpusPtr GetCorpus(unsigned int& generation);
+        CorpusPtr WaitForCorpus(unsigned int& generation);
+
+        // GetGeneration
+        // Returns the number of samples taken so far, so that users of the
+        // stream can tell when there is a new one.
+        unsigned int GetGeneration() const
+        {
+            return m_generation;
+        }
+
+    private:
+        // Typedefs
+        typedef std::vector<std::string> Reservoir;
+
+        // Ctors/Dtors
+        Stream(const Stream&);
+        Stream& operator=(const Stream&);
+
+        // Methods
+        void      Run();
+        CorpusPtr Sample();
+        void      AddToReservoir(Reservoir&    reservoir,
+                                 unsigned int& seen,
+                                 const char   *text,
+                                 unsigned int  length);
+
+        // Members
+        Font                      m_font;
+        std::string               m_file;
+        unsigned int              m_reservoirSize;
+        std::chrono::milliseconds m_refreshTime;
+        std::mt19937              m_random;
+
+        std::mutex                m_mutex;
+        std::condition_variable   m_changed;
+        CorpusPtr                 m_corpus;
+        std::exception_ptr        m_error;
+        std::atomic<unsigned int> m_generation;
+        std::atomic<bool>         m_stopping;
+
+        std::thread               m_thread;
+    };
+}
+
+#endif // _PHRASE_STREAM_H_
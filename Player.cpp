@@ -30,36 +30,32 @@ namespace typing
         // Alpha fades between 0.1 and 0.5
         const float alpha =
             m_lives > 0 ? 
-                0.1f + (1.0f + sinf(GAME.GetTime())) / 5.0f : 0.0f;
+                0.1f + (1.0f + static_cast<float>(sin(GAME.GetTime()))) / 5.0f : 0.0f;
 
-        glPushMatrix();
-            glTranslatef(PLAYER_ORIGIN.GetX(),
-                         PLAYER_ORIGIN.GetY(),
-                         PLAYER_ORIGIN.GetZ());
-            glRotatef(45.0f, 0.0f, 0.0f, 1.0f);
-            glRotatef(45.0f, 0.0f, 1.0f, 0.0f);
-            glScalef(38.0f, 38.0f, 38.0f);
+        ShapeTransform transform;
+        transform.Translate(PLAYER_ORIGIN)
+                 .Rotate(45.0f, 0.0f, 0.0f, 1.0f)
+                 .Rotate(45.0f, 0.0f, 1.0f, 0.0f)
+                 .Scale(38.0f);
 
-            DrawCube(ColourRGBA(m_lives > 1 ? 0.7f : 1.0f,
-                                m_lives > 1 ? 1.0f : 0.0f,
-                                0.0f, alpha),
-                     ColourRGBA(0.8f, 1.0f, 0.8f, 1.0f));
+        DrawCube(transform,
+                 ColourRGBA(m_lives > 1 ? 0.7f : 1.0f,
+                            m_lives > 1 ? 1.0f : 0.0f,
+                            0.0f, alpha),
+                 ColourRGBA(0.8f, 1.0f, 0.8f, 1.0f));
 
-            glPushMatrix();
-                glScalef(1.1f, 1.1f, 1.1f);
-                if (m_lastFireTime != 0.0f && GAME.GetTime() - m_lastFireTime < FIRE_FADE_TIME)
-                {
-                    const float fireAlpha = 1.0f - (GAME.GetTime() - m_lastFireTime) / FIRE_FADE_TIME;
-                    DrawCube(ColourRGBA(1.0f, 1.0f, 1.0f, fireAlpha));
-                }
+        transform.Scale(1.1f);
+        if (m_lastFireTime != 0.0f && GAME.GetTime() - m_lastFireTime < FIRE_FADE_TIME)
+        {
+            const float fireAlpha = 1.0f - (GAME.GetTime() - m_lastFireTime) / FIRE_FADE_TIME;
+            DrawCube(transform, ColourRGBA(1.0f, 1.0f, 1.0f, fireAlpha));
+        }
 
-                if (m_damageTime != 0.0f && GAME.GetTime() - m_damageTime < DAMAGE_FADE_TIME)
-                {
-                    const float damageAlpha = 1.0f - (GAME.GetTime() - m_damageTime) / DAMAGE_FADE_TIME;
-                    DrawCube(ColourRGBA(1.0f, 0.0f, 0.0f, damageAlpha));
-                }
-            glPopMatrix();
-        glPopMatrix();
+        if (m_damageTime != 0.0f && GAME.GetTime() - m_damageTime < DAMAGE_FADE_TIME)
+        {
+            const float damageAlpha = 1.0f - (GAME.GetTime() - m_damageTime) / DAMAGE_FADE_TIME;
+            DrawCube(transform, ColourRGBA(1.0f, 0.0f, 0.0f, damageAlpha));
+        }
     }
 
     void Player::Update()
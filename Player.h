@@ -49,8 +49,8 @@ namespace typing
 
         // Members
         unsigned int m_lives;
-        float        m_lastFireTime;
-        float        m_damageTime;
+        double       m_lastFireTime;
+        double       m_damageTime;
     };
 }
 
@@ -10,6 +10,8 @@
 #include "Random.h"
 #include "Award.h"
 #include "Utils.h"
+#include "Profiler.h"
+#include "RenderState.h"
 
 namespace typing
 {
@@ -27,6 +29,8 @@ namespace typing
                                                  "sounds/powerup.wav");
     static const std::string POWERUPACTIVATEEFFECT_FLARE_TEXTURE(
                                                  "textures/game/flare.tga");
+    static SoundHandle   s_powerupActivateSound;
+    static TextureHandle s_powerupActivateFlareTexture;
     static const float POWERUPACTIVATEEFFECT_LIFETIME = 0.4f; 
     static const float POWERUPACTIVATEEFFECT_FLARE_START_SIZE = 10.0f;
     static const float POWERUPACTIVATEEFFECT_FLARE_EXPAND_SPEED = 1500.0f;
@@ -35,13 +39,14 @@ namespace typing
 
     void PowerupActivateEffect::Init()
     {
-        SOUNDS.Add(POWERUPACTIVATEEFFECT_SOUND);
-        TEXTURES.Add(POWERUPACTIVATEEFFECT_FLARE_TEXTURE);
+        s_powerupActivateSound = SOUNDS.Add(POWERUPACTIVATEEFFECT_SOUND);
+        s_powerupActivateFlareTexture =
+            TEXTURES.Add(POWERUPACTIVATEEFFECT_FLARE_TEXTURE);
     }
 
     void PowerupActivateEffect::OnSpawn()
     {
-        SOUNDS.Play(POWERUPACTIVATEEFFECT_SOUND);
+        SOUNDS.Play(s_powerupActivateSound);
     }
 
     void PowerupActivateEffect::Update()
@@ -56,6 +61,7 @@ namespace typing
 
     void PowerupActivateEffect::Draw()
     {
+        const Camera& cam = GAME.GetCam();
         const float flareSize = POWERUPACTIVATEEFFECT_FLARE_START_SIZE +
             m_age * POWERUPACTIVATEEFFECT_FLARE_EXPAND_SPEED;
         const float flareAlpha = POWERUPACTIVATEEFFECT_FLARE_START_ALPHA -
@@ -64,24 +70,26 @@ namespace typing
         glPushMatrix();
             glTranslatef(m_origin[0], m_origin[1], m_origin[2]);
             glScalef(flareSize, flareSize, flareSize);
-            TEXTURES.Bind(POWERUPACTIVATEEFFECT_FLARE_TEXTURE);
-            glColor4f(0.6f, 1.0f, 0.6f, flareAlpha);
+            RENDERSTATE.Enable(GL_TEXTURE_2D);
+            TEXTURES.Bind(s_powerupActivateFlareTexture);
+            RENDERSTATE.Colour(0.6f, 1.0f, 0.6f, flareAlpha);
 
+            PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
             glBegin(GL_QUADS);
                 juzutil::Vector3 vertex =
-                    (-GAME.GetCam().GetRight() - GAME.GetCam().GetUp()) / 2.0f;
+                    (-cam.GetRight() - cam.GetUp()) / 2.0f;
                 glTexCoord2f(0.0f, 0.0f);
                 glVertex3f(vertex[0], vertex[1], vertex[2]);
 
-                vertex += GAME.GetCam().GetRight();
+                vertex += cam.GetRight();
                 glTexCoord2f(0.0f, 1.0f);
                 glVertex3f(vertex[0], vertex[1], vertex[2]);
 
-                vertex += GAME.GetCam().GetUp();
+                vertex += cam.GetUp();
                 glTexCoord2f(1.0f, 1.0f);
                 glVertex3f(vertex[0], vertex[1], vertex[2]);
 
-                vertex -= GAME.GetCam().GetRight();
+                vertex -= cam.GetRight();
                 glTexCoord2f(1.0f, 0.0f);
                 glVertex3f(vertex[0], vertex[1], vertex[2]);
             glEnd();
@@ -93,7 +101,17 @@ namespace typing
     // PowerupFactory
     //////////////////////////////////////////////////////////////////////////
 
-    PowerupPtr PowerupFactory::Create(const juzutil::Vector3& origin)
+    template<typename powerupType>
+    EntityHandle CreatePowerup(PhraseView phrase, const juzutil::Vector3& origin)
+    {
+        return GAME.SpawnEntity<powerupType>(phrase, origin);
+    }
+
+    template EntityHandle CreatePowerup<ExtraLife>(PhraseView phrase, const juzutil::Vector3& origin);
+    template EntityHandle CreatePowerup<ShortenPhrases>(PhraseView phrase, const juzutil::Vector3& origin);
+
+
+    EntityHandle PowerupFactory::Create(const juzutil::Vector3& origin)
     {
         if (m_creators.empty()) {
             throw std::runtime_error("Empty Powerup Factory");
@@ -116,38 +134,32 @@ namespace typing
         *hit = m_phrase.OnType(c, GAME.GetTime());
 
         if (!*hit) {
-            ExplosionPtr explosion(new Explosion(m_origin,
-                                                 ColourRGBA::Red()));
-            GAME.AddEffect(explosion);
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
+            GAME.SpawnEffect<Explosion>(m_origin, ColourRGBA::Red());
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
             m_unlink = true;
         } else {
             *phraseFinished = m_phrase.Finished();
 
             if (*phraseFinished) {
-                GAME.MakeCharAvail(m_phrase.GetStartChar());
+                GAME.MakeCharAvail(this, m_phrase.GetStartChar());
                 GAME.AddExtraLife();
-                GAME.AddEffect2d(
-                    AwardPtr(new Award(
-                                GAME.GetCam().PerspectiveProject(m_origin),
-                                AWARD_EXTRALIFE,
-                                GAME.GetTime())));
+                GAME.SpawnEffect2d<Award>(GAME.GetView().Project(m_origin),
+                                          AWARD_EXTRALIFE,
+                                          GAME.GetTime());
 
-                PowerupActivateEffectPtr activate(
-                                        new PowerupActivateEffect(m_origin));
-                GAME.AddEffect(activate);
+                GAME.SpawnEffect<PowerupActivateEffect>(m_origin);
 
                 m_unlink = true;
             }
         }
     }
 
-    void ExtraLife::Draw2D()
+    void ExtraLife::Draw2D(const juzutil::Vector2& screenOrigin)
     {
-        m_phrase.Draw(m_origin);
+        m_phrase.Draw(screenOrigin);
     }
 
-    void ExtraLife::Draw3D()
+    void ExtraLife::Draw3D(const juzutil::Vector3& origin)
     {
         ColourRGBA sphereColour(POWERUP_SPHERE_COLOUR);
         const float blinkTime = (GAME.GetTime() - m_spawnTime) -
@@ -159,30 +171,21 @@ namespace typing
                               static_cast<float>(M_PI) * POWERUP_BLINK_SPEED));
         }
 
-        glPushMatrix();
-            glTranslatef(m_origin[0], m_origin[1], m_origin[2]);
-
-            glPushMatrix();
-                float angle =
-                    RadToDeg(acosf(fmod(POWERUP_ROTATE_SPEED * 
-                                        GAME.GetTime(), 2.0f) - 1.0f));
-                glRotatef(angle, 0.0f, 1.0f, 0.0f);
-
-                glPushMatrix();
-                    glScalef(7.0f, 18.0f, 7.0f);
-                    DrawCube(ColourRGBA::Red());
-                glPopMatrix();
-                glPushMatrix();
-                    glScalef(18.0f, 7.0f, 7.0f);
-                    DrawCube(ColourRGBA::Red());
-                glPopMatrix();
-            glPopMatrix();
-
-            glPushMatrix();
-                glScalef(20.0f, 20.0f, 20.0f);
-                DrawSphere(ColourRGBA(sphereColour));
-            glPopMatrix();
-        glPopMatrix();
+        ShapeTransform transform;
+        transform.Translate(origin);
+
+        const float angle =
+            RadToDeg(acosf(static_cast<float>(fmod(POWERUP_ROTATE_SPEED *
+                                                   GAME.GetTime(), 2.0)) - 1.0f));
+        ShapeTransform crossTransform(transform);
+        crossTransform.Rotate(angle, 0.0f, 1.0f, 0.0f);
+        DrawCube(ShapeTransform(crossTransform).Scale(7.0f, 18.0f, 7.0f),
+                 ColourRGBA::Red());
+        DrawCube(ShapeTransform(crossTransform).Scale(18.0f, 7.0f, 7.0f),
+                 ColourRGBA::Red());
+
+        transform.Scale(20.0f);
+        DrawSphere(transform, ColourRGBA(sphereColour));
     }
 
     void ExtraLife::OnSpawn()
@@ -193,7 +196,7 @@ namespace typing
     void ExtraLife::Update()
     {
         if (GAME.GetTime() - m_spawnTime >= POWERUP_LIFETIME) {
-            GAME.MakeCharAvail(GetStartChar());
+            GAME.MakeCharAvail(this, GetStartChar());
             m_unlink = true;
         }
     }
@@ -206,38 +209,32 @@ namespace typing
         *hit = m_phrase.OnType(c, GAME.GetTime());
 
         if (!*hit) {
-            ExplosionPtr explosion(new Explosion(m_origin,
-                                                 ColourRGBA::Blue()));
-            GAME.AddEffect(explosion);
-            GAME.MakeCharAvail(m_phrase.GetStartChar());
+            GAME.SpawnEffect<Explosion>(m_origin, ColourRGBA::Blue());
+            GAME.MakeCharAvail(this, m_phrase.GetStartChar());
             m_unlink = true;
         } else {
             *phraseFinished = m_phrase.Finished();
 
             if (*phraseFinished) {
-                GAME.MakeCharAvail(m_phrase.GetStartChar());
+                GAME.MakeCharAvail(this, m_phrase.GetStartChar());
                 GAME.StartShortenPhrases();
-                GAME.AddEffect2d(
-                    AwardPtr(new Award(
-                                GAME.GetCam().PerspectiveProject(m_origin),
-                                AWARD_SHORTEN_PHRASES,
-                                GAME.GetTime())));
+                GAME.SpawnEffect2d<Award>(GAME.GetView().Project(m_origin),
+                                          AWARD_SHORTEN_PHRASES,
+                                          GAME.GetTime());
 
-                PowerupActivateEffectPtr activate(
-                                    new PowerupActivateEffect(m_origin));
-                GAME.AddEffect(activate);
+                GAME.SpawnEffect<PowerupActivateEffect>(m_origin);
 
                 m_unlink = true;
             }
         }
     }
 
-    void ShortenPhrases::Draw2D()
+    void ShortenPhrases::Draw2D(const juzutil::Vector2& screenOrigin)
     {
-        m_phrase.Draw(m_origin);
+        m_phrase.Draw(screenOrigin);
     }
 
-    void ShortenPhrases::Draw3D()
+    void ShortenPhrases::Draw3D(const juzutil::Vector3& origin)
     {
         ColourRGBA sphereColour(POWERUP_SPHERE_COLOUR);
         const float blinkTime = (GAME.GetTime() - m_spawnTime) -
@@ -249,27 +246,20 @@ namespace typing
                               static_cast<float>(M_PI) * POWERUP_BLINK_SPEED));
         }
 
-        glPushMatrix();
-            glTranslatef(m_origin[0], m_origin[1], m_origin[2]);
+        ShapeTransform transform;
+        transform.Translate(origin);
 
-            glPushMatrix();
-                float angle =
-                    RadToDeg(acosf(fmod(POWERUP_ROTATE_SPEED * 
-                                        GAME.GetTime(), 2.0f) - 1.0f));
-                glRotatef(angle, 0.0f, 1.0f, 0.0f);
-
-                glPushMatrix();
-                    glTranslatef(-0.0f, -5.0f, -0.0f);
-                    glScalef(10.0f, 10.0f, 10.0f);
-                    DrawPyramid(ColourRGBA::Blue());
-                glPopMatrix();
-            glPopMatrix();
-
-            glPushMatrix();
-                glScalef(20.0f, 20.0f, 20.0f);
-                DrawSphere(ColourRGBA(sphereColour));
-            glPopMatrix();
-        glPopMatrix();
+        const float angle =
+            RadToDeg(acosf(static_cast<float>(fmod(POWERUP_ROTATE_SPEED *
+                                                   GAME.GetTime(), 2.0)) - 1.0f));
+        ShapeTransform pyramidTransform(transform);
+        pyramidTransform.Rotate(angle, 0.0f, 1.0f, 0.0f)
+                        .Translate(-0.0f, -5.0f, -0.0f)
+                        .Scale(10.0f);
+        DrawPyramid(pyramidTransform, ColourRGBA::Blue());
+
+        transform.Scale(20.0f);
+        DrawSphere(transform, ColourRGBA(sphereColour));
     }
 
     void ShortenPhrases::OnSpawn()
@@ -280,7 +270,7 @@ namespace typing
     void ShortenPhrases::Update()
     {
         if (GAME.GetTime() - m_spawnTime >= POWERUP_LIFETIME) {
-            GAME.MakeCharAvail(GetStartChar());
+            GAME.MakeCharAvail(this, GetStartChar());
             m_unlink = true;
         }
     }
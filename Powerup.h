@@ -34,7 +34,6 @@ namespace typing
             juzutil::Vector3 m_origin;
             float            m_age;
     };
-    typedef std::shared_ptr<PowerupActivateEffect> PowerupActivateEffectPtr;
 
     //////////////////////////////////////////////////////////////////////////
     // Powerup
@@ -45,6 +44,7 @@ namespace typing
         virtual const juzutil::Vector3& GetOrigin()                 const = 0;
         virtual char                    GetStartChar()              const = 0;
         virtual bool                    StartsWith(const char c)    const = 0;
+        virtual char                    GetNextChar()               const = 0;
         virtual bool                    IsPhraseSingle()            const = 0;
         virtual float                   GetTypingSpeed()            const = 0;
         virtual bool                    Unlink()                    const = 0;
@@ -71,11 +71,11 @@ namespace typing
         {
         }
 
-        virtual void Draw2D()
+        virtual void Draw2D(const juzutil::Vector2& screenOrigin)
         {
         }
 
-        virtual void Draw3D()
+        virtual void Draw3D(const juzutil::Vector3& origin)
         {
         }
 
@@ -85,14 +85,13 @@ namespace typing
         }
 
     };
-    typedef std::shared_ptr<Powerup> PowerupPtr;
-    typedef PowerupPtr (*PowerupCreator)(const std::string& phrase, const juzutil::Vector3& origin);
+    typedef EntityHandle (*PowerupCreator)(PhraseView phrase, const juzutil::Vector3& origin);
 
+    // Spawns a powerup of the given type into the game. This needs the full
+    // Game definition, so it is defined and instantiated in Powerup.cpp for
+    // each type of powerup.
     template<typename powerupType>
-    PowerupPtr CreatePowerup(const std::string& phrase, const juzutil::Vector3& origin)
-    {
-        return PowerupPtr(new powerupType(phrase, origin));
-    }
+    EntityHandle CreatePowerup(PhraseView phrase, const juzutil::Vector3& origin);
 
 
     //////////////////////////////////////////////////////////////////////////
@@ -107,7 +106,7 @@ namespace typing
             m_creators.push_back(creator);
         }
 
-        PowerupPtr Create(const juzutil::Vector3& origin);
+        EntityHandle Create(const juzutil::Vector3& origin);
 
     private:
         // Typedefs
@@ -124,7 +123,7 @@ namespace typing
     class ExtraLife : public Powerup
     {
     public:
-        ExtraLife (const std::string& phrase, const juzutil::Vector3& origin)
+        ExtraLife (PhraseView phrase, const juzutil::Vector3& origin)
             : m_phrase(phrase), m_origin(origin), m_unlink(false)
         {
         }
@@ -144,6 +143,11 @@ namespace typing
             return (GetStartChar() == c);
         }
 
+        char GetNextChar() const
+        {
+            return m_phrase.GetNextChar();
+        }
+
         bool IsPhraseSingle() const
         {
             return (m_phrase.Length() == 1);
@@ -162,14 +166,14 @@ namespace typing
         void OnSpawn();
         void Update();
         void OnType(char c, bool *hit, bool *phraseFinished);
-        void Draw2D();
-        void Draw3D();    
+        void Draw2D(const juzutil::Vector2& screenOrigin);
+        void Draw3D(const juzutil::Vector3& origin);    
 
     private:
         Phrase           m_phrase;
         juzutil::Vector3 m_origin;
         bool             m_unlink;
-        float            m_spawnTime;
+        double           m_spawnTime;
     };
     
 
@@ -179,7 +183,7 @@ namespace typing
     class ShortenPhrases : public Powerup
     {
     public:
-        ShortenPhrases (const std::string& phrase,
+        ShortenPhrases (PhraseView phrase,
                        const juzutil::Vector3& origin)
             : m_phrase(phrase), m_origin(origin), m_unlink(false)
         {
@@ -200,6 +204,11 @@ namespace typing
             return (GetStartChar() == c);
         }
 
+        char GetNextChar() const
+        {
+            return m_phrase.GetNextChar();
+        }
+
         bool IsPhraseSingle() const
         {
             return (m_phrase.Length() == 1);
@@ -218,14 +227,14 @@ namespace typing
         void OnSpawn();
         void Update();
         void OnType(char c, bool *hit, bool *phraseFinished);
-        void Draw2D();
-        void Draw3D();    
+        void Draw2D(const juzutil::Vector2& screenOrigin);
+        void Draw3D(const juzutil::Vector3& origin);    
 
     private:
         Phrase           m_phrase;
         juzutil::Vector3 m_origin;
         bool             m_unlink;
-        float            m_spawnTime;
+        double           m_spawnTime;
     };
 }
 
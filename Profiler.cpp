@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <boost/format.hpp>
+#include "Profiler.h"
+#include "App.h"
+#include "Exceptions.h"
+#include "FontManager.h"
+
+namespace typing
+{
+    const std::string Profiler::OVERLAY_FONT("fonts/hudfont.fnt");
+
+    static FontHandle s_overlayFont;
+
+    const char *const Profiler::ZONE_NAMES[ZONE_COUNT] = {
+        "events",
+        "game_update",
+        "menu_update",
+        "draw_background",
+        "draw_entities",
+        "draw_effects",
+        "draw_phrases",
+        "draw_hud",
+        "swap"
+    };
+
+    const char *const Profiler::COUNTER_NAMES[COUNTER_COUNT] = {
+        "entities",
+        "effects",
+        "draw_calls",
+        "texture_binds",
+        "state_filtered"
+    };
+
+    std::auto_ptr<Profiler> Profiler::m_singleton(new Profiler);
+    Profiler& Profiler::GetProfiler()
+    {
+        return *(m_singleton.get());
+    }
+
+    Profiler::Profiler()
+        : m_csvFile(NULL), m_overlay(false), m_frame(0), m_frameStart(0),
+          m_avgFrameMs(0.0)
+    {
+        std::fill(m_zoneCounts, m_zoneCounts + ZONE_COUNT, 0);
+        std::fill(m_counters, m_counters + COUNTER_COUNT, 0);
+        std::fill(m_lastCounters, m_lastCounters + COUNTER_COUNT, 0);
+        std::fill(m_avgZoneMs, m_avgZoneMs + ZONE_COUNT, 0.0);
+    }
+
+    void Profiler::Init()
+    {
+        if (!APP.IsHeadless()) {
+            s_overlayFont = FONTS.Add(OVERLAY_FONT);
+        }
+
+        if (!APP.HasOption("profile-csv")) {
+            return;
+        }
+
+        const std::string filename = APP.GetOption<std::string>("profile-csv");
+        m_csvFile = fopen(filename.c_str(), "w");
+        if (!m_csvFile) {
+            throw FileNotFoundException(filename);
+        }
+
+        fprintf(m_csvFile, "frame,frame_ms");
+        for (unsigned int i = 0; i < ZONE_COUNT; i++) {
+            fprintf(m_csvFile, ",%s_ms", ZONE_NAMES[i]);
+        }
+        for (unsigned int i = 0; i < COUNTER_COUNT; i++) {
+            fprintf(m_csvFile, ",%s", COUNTER_NAMES[i]);
+        }
+        fprintf(m_csvFile, "\n");
+    }
+
+    void Profiler::Shutdown()
+    {
+        if (m_csvFile) {
+            fclose(m_csvFile);
+            m_csvFile = NULL;
+        }
+    }
+
+    void Profiler::BeginFrame()
+    {
+        std::fill(m_zoneCounts, m_zoneCounts + ZONE_COUNT, 0);
+        std::fill(m_counters, m_counters + COUNTER_COUNT, 0);
+
+        m_frameStart = IsEnabled() ? SDL_GetPerformanceCounter() : 0;
+    }
+
+    void Profiler::EndFrame()
+    {
+        // Skip the frame the profiler was turned on in, it wasn't measured
+        // from the start.
+        if (!IsEnabled() || !m_frameStart) {
+            return;
+        }
+
+        const double frameMs =
+                    CountsToMs(SDL_GetPerformanceCounter() - m_frameStart);
+
+        const double SMOOTHING = 0.05;
+        m_avgFrameMs += (frameMs - m_avgFrameMs) * SMOOTHING;
+        for (unsigned int i = 0; i < ZONE_COUNT; i++) {
+            m_avgZoneMs[i] += (CountsToMs(m_zoneCounts[i]) - m_avgZoneMs[i]) *
+                              SMOOTHING;
+        }
+
+        std::copy(m_counters, m_counters + COUNTER_COUNT, m_lastCounters);
+
+        if (m_csvFile) {
+            WriteCsvRow(frameMs);
+        }
+
+        m_frame++;
+    }
+
+    void Profiler::DrawOverlay()
+    {
+        if (!m_overlay) {
+            return;
+        }
+
+        const float X      = 10.0f;
+        const float HEIGHT = 16.0f;
+        float       y      = 10.0f;
+
+        FONTS.Print(s_overlayFont, X, y, HEIGHT, ColourRGBA::Yellow(),
+                    Font::ALIGN_LEFT,
+                    boost::str(boost::format("frame %1$.2f ms") %
+                               m_avgFrameMs));
+        y += HEIGHT;
+
+        for (unsigned int i = 0; i < ZONE_COUNT; i++) {
+            FONTS.Print(s_overlayFont, X, y, HEIGHT, ColourRGBA::White(),
+                        Font::ALIGN_LEFT,
+                        boost::str(boost::format("%1% %2$.2f ms") %
+                                   ZONE_NAMES[i] % m_avgZoneMs[i]));
+            y += HEIGHT;
+        }
+
+        // This frame's counts are still going up, so show the last frame's.
+        for (unsigned int i = 0; i < COUNTER_COUNT; i++) {
+            FONTS.Print(s_overlayFont, X, y, HEIGHT, ColourRGBA::White(),
+                        Font::ALIGN_LEFT,
+                        boost::str(boost::format("%1% %2%") %
+                                   COUNTER_NAMES[i] % m_lastCounters[i]));
+            y += HEIGHT;
+        }
+    }
+
+    double Profiler::CountsToMs(Uint64 counts) const
+    {
+        return (static_cast<double>(counts) * 1000.0 /
+                static_cast<double>(SDL_GetPerformanceFrequency()));
+    }
+
+    void Profiler::WriteCsvRow(double frameMs)
+    {
+        fprintf(m_csvFile, "%u,%.4f", m_frame, frameMs);
+        for (unsigned int i = 0; i < ZONE_COUNT; i++) {
+            fprintf(m_csvFile, ",%.4f", CountsToMs(m_zoneCounts[i]));
+        }
+        for (unsigned int i = 0; i < COUNTER_COUNT; i++) {
+            fprintf(m_csvFile, ",%u", m_counters[i]);
+        }
+        fprintf(m_csvFile, "\n");
+    }
+}
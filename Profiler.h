@@ -0,0 +1,151 @@
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <SDL2/SDL.h>
+#include "Trace.h"
+
+namespace typing
+{
+    // Measures where the time goes in each frame. Time is added up for a
+    // fixed set of zones, along with counts of things like draw calls, and
+    // each frame can be shown in an overlay and written as a row of a CSV
+    // file. Nothing is measured unless one of those is turned on.
+    class Profiler
+    {
+    public:
+        // Consts/Enums
+        enum Zone {
+            ZONE_EVENTS,
+            ZONE_GAME_UPDATE,
+            ZONE_MENU_UPDATE,
+            ZONE_DRAW_BACKGROUND,
+            ZONE_DRAW_ENTITIES,
+            ZONE_DRAW_EFFECTS,
+            ZONE_DRAW_PHRASES,
+            ZONE_DRAW_HUD,
+            ZONE_SWAP,
+            ZONE_COUNT };
+
+        enum Counter {
+            COUNTER_ENTITIES,
+            COUNTER_EFFECTS,
+            COUNTER_DRAW_CALLS,
+            COUNTER_TEXTURE_BINDS,
+            COUNTER_STATE_FILTERED,
+            COUNTER_COUNT };
+
+        // Methods
+        void Init();
+        void Shutdown();
+        void BeginFrame();
+        void EndFrame();
+        void DrawOverlay();
+
+        void ToggleOverlay()
+        {
+            m_overlay = !m_overlay;
+        }
+
+        bool IsEnabled() const
+        {
+            return (m_overlay || m_csvFile != NULL);
+        }
+
+        void AddTime(Zone zone, Uint64 counts)
+        {
+            m_zoneCounts[zone] += counts;
+        }
+
+        void Count(Counter counter, unsigned int count = 1)
+        {
+            if (IsEnabled()) {
+                m_counters[counter] += count;
+            }
+        }
+
+        void SetCount(Counter counter, unsigned int count)
+        {
+            m_counters[counter] = count;
+        }
+
+        static const char *GetZoneName(Zone zone)
+        {
+            return ZONE_NAMES[zone];
+        }
+
+        // Singleton Implementation
+        static Profiler& GetProfiler();
+
+    private:
+        // Ctors/Dtors
+        Profiler();
+        Profiler(const Profiler& p);
+
+        // Consts/Enums
+        static const std::string OVERLAY_FONT;
+        static const char *const ZONE_NAMES[ZONE_COUNT];
+        static const char *const COUNTER_NAMES[COUNTER_COUNT];
+
+        // Methods
+        double CountsToMs(Uint64 counts) const;
+        void   WriteCsvRow(double frameMs);
+
+        // Members
+        FILE         *m_csvFile;
+        bool          m_overlay;
+        unsigned int  m_frame;
+        Uint64        m_frameStart;
+        Uint64        m_zoneCounts[ZONE_COUNT];
+        unsigned int  m_counters[COUNTER_COUNT];
+        unsigned int  m_lastCounters[COUNTER_COUNT];
+
+        // The overlay shows averages, as single frames change too quickly
+        // to read.
+        double        m_avgFrameMs;
+        double        m_avgZoneMs[ZONE_COUNT];
+
+        // Singleton Implementation
+        static std::auto_ptr<Profiler> m_singleton;
+    };
+    #define PROFILER Profiler::GetProfiler()
+
+    // Adds the time between its construction and destruction to a zone,
+    // and records it as a span in the trace.
+    class ProfileScope
+    {
+    public:
+        // Ctors/Dtors
+        ProfileScope(Profiler::Zone zone)
+            : m_zone(zone),
+              m_start(PROFILER.IsEnabled() ? SDL_GetPerformanceCounter() : 0),
+              m_traceStart(TRACE.IsEnabled() ? TRACE.Now() : 0)
+        {
+        }
+
+        ~ProfileScope()
+        {
+            if (m_start) {
+                PROFILER.AddTime(m_zone, SDL_GetPerformanceCounter() - m_start);
+            }
+
+            if (TRACE.IsEnabled()) {
+                TRACE.Span(Profiler::GetZoneName(m_zone), m_traceStart,
+                           TRACE.Now() - m_traceStart);
+            }
+        }
+
+    private:
+        // Ctors/Dtors
+        ProfileScope(const ProfileScope& scope);
+
+        // Members
+        Profiler::Zone m_zone;
+        Uint64         m_start;
+        long long      m_traceStart;
+    };
+}
+
+#endif // _PROFILER_H_
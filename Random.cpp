@@ -2,9 +2,11 @@
 
 namespace typing
 {
+    thread_local Random *Random::m_threadRandom = NULL;
+
     std::auto_ptr<Random> Random::m_singleton(new Random);
     Random& Random::GetRandom()
     {
-        return *(m_singleton.get());
+        return (m_threadRandom ? *m_threadRandom : *(m_singleton.get()));
     }
 }
\ No newline at end of file
@@ -44,11 +44,22 @@ namespace typing
             }
         }
 
+        // SetThreadRandom
+        // Makes RAND refer to random on the calling thread, so that games
+        // simulated on different threads have their own random sequences.
+        // Passing NULL goes back to the singleton.
+        static void SetThreadRandom(Random *random)
+        {
+            m_threadRandom = random;
+        }
+
         // Singleton implementation
         static Random& GetRandom();
     private:
         std::mt19937 m_rng;
 
+        static thread_local Random *m_threadRandom;
+
         // Singleton implementation
         static std::auto_ptr<Random> m_singleton;
     };
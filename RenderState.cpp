@@ -0,0 +1,31 @@
+#include <algorithm>
+#include "RenderState.h"
+
+namespace typing
+{
+    std::auto_ptr<RenderState> RenderState::m_singleton(new RenderState);
+    RenderState& RenderState::GetRenderState()
+    {
+        return *(m_singleton.get());
+    }
+
+    RenderState::RenderState()
+        : m_texture(0), m_textureKnown(false), m_colourKnown(false),
+          m_lineWidth(1.0f), m_lineWidthKnown(false),
+          m_blendSrc(GL_ONE), m_blendDst(GL_ZERO), m_blendKnown(false)
+    {
+        Invalidate();
+    }
+
+    // Forgets all of the tracked state, so that the next change to each
+    // part of it goes to GL whatever its value.
+    void RenderState::Invalidate()
+    {
+        std::fill(m_caps, m_caps + CAP_COUNT, CAP_UNKNOWN);
+        std::fill(m_colour, m_colour + 4, 0.0f);
+        m_textureKnown   = false;
+        m_colourKnown    = false;
+        m_lineWidthKnown = false;
+        m_blendKnown     = false;
+    }
+}
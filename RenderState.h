@@ -0,0 +1,177 @@
+#ifndef _RENDER_STATE_H_
+#define _RENDER_STATE_H_
+
+#include <memory>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_opengl.h>
+#include "Colour.h"
+#include "Profiler.h"
+
+namespace typing
+{
+    // Keeps a copy of the GL state that the game changes while drawing, so
+    // that calls which wouldn't change anything can be dropped before they
+    // reach the driver. Each draw sets the state it needs rather than
+    // putting back what it found, so runs of similar draws only pay for the
+    // first change. The calls dropped are counted by the profiler.
+    //
+    // Anything that changes the tracked state without going through here,
+    // such as drawing with a colour array or calling a display list, must
+    // say so with InvalidateColour or Invalidate.
+    class RenderState
+    {
+    public:
+        // Singleton Implementation
+        static RenderState& GetRenderState();
+
+        // Methods
+        void Invalidate();
+
+        // Enable/Disable
+        // Only a few caps are tracked, the rest go straight to GL.
+        void Enable(GLenum cap)
+        {
+            SetCap(cap, true);
+        }
+
+        void Disable(GLenum cap)
+        {
+            SetCap(cap, false);
+        }
+
+        void BindTexture(GLuint texture)
+        {
+            if (m_textureKnown && m_texture == texture) {
+                Filtered();
+                return;
+            }
+
+            PROFILER.Count(Profiler::COUNTER_TEXTURE_BINDS);
+            glBindTexture(GL_TEXTURE_2D, texture);
+            m_texture      = texture;
+            m_textureKnown = true;
+        }
+
+        void Colour(float r, float g, float b, float a)
+        {
+            if (m_colourKnown && m_colour[0] == r && m_colour[1] == g &&
+                m_colour[2] == b && m_colour[3] == a) {
+                Filtered();
+                return;
+            }
+
+            glColor4f(r, g, b, a);
+            m_colour[0]   = r;
+            m_colour[1]   = g;
+            m_colour[2]   = b;
+            m_colour[3]   = a;
+            m_colourKnown = true;
+        }
+
+        void Colour(const ColourRGBA& col)
+        {
+            Colour(col.GetRed(), col.GetGreen(), col.GetBlue(), col.GetAlpha());
+        }
+
+        void LineWidth(float width)
+        {
+            if (m_lineWidthKnown && m_lineWidth == width) {
+                Filtered();
+                return;
+            }
+
+            glLineWidth(width);
+            m_lineWidth      = width;
+            m_lineWidthKnown = true;
+        }
+
+        void BlendFunc(GLenum src, GLenum dst)
+        {
+            if (m_blendKnown && m_blendSrc == src && m_blendDst == dst) {
+                Filtered();
+                return;
+            }
+
+            glBlendFunc(src, dst);
+            m_blendSrc   = src;
+            m_blendDst   = dst;
+            m_blendKnown = true;
+        }
+
+        // InvalidateColour
+        // Drawing with a colour array leaves the current colour undefined.
+        void InvalidateColour()
+        {
+            m_colourKnown = false;
+        }
+
+    private:
+        // Ctors/Dtors
+        RenderState();
+
+        // Enums
+        enum TrackedCap {
+            CAP_TEXTURE_2D,
+            CAP_BLEND,
+            CAP_LINE_SMOOTH,
+            CAP_LIGHTING,
+            CAP_COUNT };
+
+        enum CapState { CAP_UNKNOWN, CAP_ON, CAP_OFF };
+
+        // Methods
+        static int GetCapIndex(GLenum cap)
+        {
+            switch (cap) {
+            case GL_TEXTURE_2D:  return CAP_TEXTURE_2D;
+            case GL_BLEND:       return CAP_BLEND;
+            case GL_LINE_SMOOTH: return CAP_LINE_SMOOTH;
+            case GL_LIGHTING:    return CAP_LIGHTING;
+            default:             return -1;
+            }
+        }
+
+        void SetCap(GLenum cap, bool enable)
+        {
+            const int      index = GetCapIndex(cap);
+            const CapState state = enable ? CAP_ON : CAP_OFF;
+            if (index >= 0 && m_caps[index] == state) {
+                Filtered();
+                return;
+            }
+
+            if (enable) {
+                glEnable(cap);
+            } else {
+                glDisable(cap);
+            }
+
+            if (index >= 0) {
+                m_caps[index] = state;
+            }
+        }
+
+        void Filtered()
+        {
+            PROFILER.Count(Profiler::COUNTER_STATE_FILTERED);
+        }
+
+        // Members
+        CapState m_caps[CAP_COUNT];
+        GLuint   m_texture;
+        bool     m_textureKnown;
+        float    m_colour[4];
+        bool     m_colourKnown;
+        float    m_lineWidth;
+        bool     m_lineWidthKnown;
+        GLenum   m_blendSrc;
+        GLenum   m_blendDst;
+        bool     m_blendKnown;
+
+        // Singleton Implementation
+        static std::auto_ptr<RenderState> m_singleton;
+    };
+    #define RENDERSTATE RenderState::GetRenderState()
+}
+
+#endif // _RENDER_STATE_H_
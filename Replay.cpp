@@ -0,0 +1,197 @@
+#include <stdio.h>
+#include <cstring>
+#include "Replay.h"
+#include "Exceptions.h"
+
+namespace typing
+{
+    const char Replay::MAGIC[4] = { 'T', 'O', 'D', 'R' };
+
+    Replay::Replay()
+        : m_readPos(0), m_seed(0), m_startTicks(0), m_tickRate(0),
+          m_lastTicks(0), m_recording(false)
+    {
+    }
+
+
+    void Replay::Record(unsigned int seed,
+                        Uint32       startTicks,
+                        unsigned int tickRate)
+    {
+        m_data.clear();
+        m_data.insert(m_data.end(), MAGIC, MAGIC + sizeof(MAGIC));
+        WriteVarint(VERSION);
+        WriteVarint(tickRate);
+        WriteVarint(seed);
+        WriteVarint(startTicks);
+
+        m_seed       = seed;
+        m_startTicks = startTicks;
+        m_tickRate   = tickRate;
+        m_lastTicks  = startTicks;
+        m_recording  = true;
+    }
+
+
+    void Replay::AddFrame(Uint32 ticks)
+    {
+        AddEvent(EVENT_FRAME, ticks - m_lastTicks);
+        m_lastTicks = ticks;
+    }
+
+
+    void Replay::AddType(char c)
+    {
+        AddEvent(EVENT_TYPE, static_cast<unsigned char>(c));
+    }
+
+
+    void Replay::AddKeyDown(SDL_Keycode keycode)
+    {
+        AddEvent(EVENT_KEYDOWN, static_cast<unsigned int>(keycode));
+    }
+
+
+    void Replay::AddResume()
+    {
+        AddEvent(EVENT_RESUME, 0);
+    }
+
+
+    void Replay::AddQuit()
+    {
+        AddEvent(EVENT_QUIT, 0);
+    }
+
+
+    // Saves the replay and stops recording.
+    void Replay::Save(const std::string& filename)
+    {
+        m_recording = false;
+
+        FILE *file = fopen(filename.c_str(), "wb");
+        if (!file)
+        {
+            throw FileNotFoundException(filename);
+        }
+
+        const size_t written = fwrite(&m_data[0], sizeof(unsigned char),
+                                      m_data.size(), file);
+        fclose(file);
+
+        if (written != m_data.size())
+        {
+            throw FileWriteException(filename);
+        }
+    }
+
+
+    void Replay::Load(const std::string& filename)
+    {
+        FILE *file = fopen(filename.c_str(), "rb");
+        if (!file)
+        {
+            throw FileNotFoundException(filename);
+        }
+
+        m_data.clear();
+        unsigned char buffer[4096];
+        size_t        read;
+        while ((read = fread(buffer, sizeof(unsigned char), sizeof(buffer),
+                             file)) > 0)
+        {
+            m_data.insert(m_data.end(), buffer, buffer + read);
+        }
+        fclose(file);
+
+        unsigned long long version    = 0;
+        unsigned long long tickRate   = 0;
+        unsigned long long seed       = 0;
+        unsigned long long startTicks = 0;
+
+        m_readPos = sizeof(MAGIC);
+        if (m_data.size() < sizeof(MAGIC) ||
+            memcmp(&m_data[0], MAGIC, sizeof(MAGIC)) != 0 ||
+            !ReadVarint(version) || version != VERSION ||
+            !ReadVarint(tickRate) || !ReadVarint(seed) ||
+            !ReadVarint(startTicks))
+        {
+            throw FileCorruptException(filename);
+        }
+
+        m_seed       = static_cast<unsigned int>(seed);
+        m_startTicks = static_cast<Uint32>(startTicks);
+        m_tickRate   = static_cast<unsigned int>(tickRate);
+        m_recording  = false;
+    }
+
+
+    // Reads the next event of a loaded replay, returning false at the end.
+    bool Replay::NextEvent(Event& ev)
+    {
+        unsigned long long value;
+        if (!ReadVarint(value))
+        {
+            return false;
+        }
+
+        const unsigned int type =
+                    static_cast<unsigned int>(value & ((1 << EVENT_BITS) - 1));
+        if (type >= EVENT_COUNT)
+        {
+            throw FileCorruptException("replay event");
+        }
+
+        ev.type  = static_cast<EventType>(type);
+        ev.value = static_cast<unsigned int>(value >> EVENT_BITS);
+        return true;
+    }
+
+
+    // Events are packed into one integer with the type in the low bits, so
+    // short frames and typed characters fit in one or two bytes.
+    void Replay::AddEvent(EventType type, unsigned int value)
+    {
+        if (m_recording)
+        {
+            WriteVarint((static_cast<unsigned long long>(value) << EVENT_BITS) |
+                        type);
+        }
+    }
+
+
+    // Writes seven bits per byte, lowest first, with the top bit set on all
+    // but the last byte.
+    void Replay::WriteVarint(unsigned long long value)
+    {
+        while (value >= 0x80)
+        {
+            m_data.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+
+        m_data.push_back(static_cast<unsigned char>(value));
+    }
+
+
+    bool Replay::ReadVarint(unsigned long long& value)
+    {
+        value = 0;
+        for (unsigned int shift = 0; shift < 64; shift += 7)
+        {
+            if (m_readPos >= m_data.size())
+            {
+                return false;
+            }
+
+            const unsigned char byte = m_data[m_readPos++];
+            value |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef _REPLAY_H_
+#define _REPLAY_H_
+
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+namespace typing
+{
+    // A recording of a single game: the seed it was started with, the tick
+    // of every update and every input the game was given, so that the game
+    // can be played again exactly. Replays are stored as a stream of
+    // variable length integers, each update holding only the ticks since the
+    // update before, so most take a single byte.
+    class Replay
+    {
+    public:
+        // Consts/Enums
+        enum EventType {
+            EVENT_FRAME,
+            EVENT_TYPE,
+            EVENT_KEYDOWN,
+            EVENT_RESUME,
+            EVENT_QUIT,
+            EVENT_COUNT };
+
+        // Typedefs
+        struct Event
+        {
+            EventType    type;
+            unsigned int value;
+        };
+
+        // Ctors/Dtors
+        Replay();
+
+        // Methods
+        // Recording
+        void Record(unsigned int seed, Uint32 startTicks, unsigned int tickRate);
+        void AddFrame(Uint32 ticks);
+        void AddType(char c);
+        void AddKeyDown(SDL_Keycode keycode);
+        void AddResume();
+        void AddQuit();
+        void Save(const std::string& filename);
+
+        bool IsRecording() const
+        {
+            return m_recording;
+        }
+
+        // Playback
+        void Load(const std::string& filename);
+        bool NextEvent(Event& ev);
+
+        unsigned int GetSeed() const
+        {
+            return m_seed;
+        }
+
+        Uint32 GetStartTicks() const
+        {
+            return m_startTicks;
+        }
+
+        unsigned int GetTickRate() const
+        {
+            return m_tickRate;
+        }
+
+    private:
+        // Consts/Enums
+        static const char         MAGIC[4];
+        static const unsigned int VERSION    = 2;
+        static const unsigned int EVENT_BITS = 3;
+
+        // Typedefs
+        typedef std::vector<unsigned char> ByteVec;
+
+        // Methods
+        void AddEvent(EventType type, unsigned int value);
+        void WriteVarint(unsigned long long value);
+        bool ReadVarint(unsigned long long& value);
+
+        // Members
+        ByteVec      m_data;
+        size_t       m_readPos;
+        unsigned int m_seed;
+        Uint32       m_startTicks;
+        unsigned int m_tickRate;
+        Uint32       m_lastTicks;
+        bool         m_recording;
+    };
+}
+
+#endif // _REPLAY_H_
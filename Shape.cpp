@@ -1,226 +1,271 @@
 #include <math.h>
+#include <vector>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_opengl.h>
 #include "Shape.h"
 #include "Vector.h"
 #include "Utils.h"
+#include "Profiler.h"
+#include "RenderState.h"
 
 namespace typing
 {
-    void DrawPyramid(const ColourRGBA& faceColour, const ColourRGBA& lineColour)
+    //////////////////////////////////////////////////////////////////////////
+    // ShapeTransform
+    //////////////////////////////////////////////////////////////////////////
+
+    ShapeTransform::ShapeTransform()
     {
-        DrawPyramid(faceColour);
+        for (unsigned int i = 0; i < 12; i++) {
+            m_matrix[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+        }
+    }
 
-        glDisable(GL_TEXTURE_2D);
+    ShapeTransform& ShapeTransform::Translate(float x, float y, float z)
+    {
+        for (unsigned int row = 0; row < 3; row++) {
+            float *m = &m_matrix[row * 4];
+            m[3] += m[0] * x + m[1] * y + m[2] * z;
+        }
 
-        glColor4f(lineColour.GetRed(), lineColour.GetGreen(), lineColour.GetBlue(), lineColour.GetAlpha());
-        glBegin(GL_LINE_STRIP);
-            glVertex3f(0, 0, 0);
-            glVertex3f(1, 1, 1);
-            glVertex3f(1, 1, -1);
-            glVertex3f(0, 0, 0);
-            glVertex3f(-1, 1, -1);
-            glVertex3f(-1, 1, 1);
-            glVertex3f(0, 0, 0);
-        glEnd();
+        return *this;
+    }
 
-        glBegin(GL_LINES);
-            glVertex3f(1, 1, 1);
-            glVertex3f(-1, 1, 1);
-            glVertex3f(1, 1, -1);
-            glVertex3f(-1, 1, -1);
-        glEnd();
-
-        glEnable(GL_TEXTURE_2D);
-    }
-
-    void DrawPyramid(const ColourRGBA& faceColour)
-    {
-        glDisable(GL_TEXTURE_2D);
+    ShapeTransform& ShapeTransform::Translate(const juzutil::Vector3& v)
+    {
+        return Translate(v[0], v[1], v[2]);
+    }
 
-        glColor4f(faceColour.GetRed(), faceColour.GetGreen(), faceColour.GetBlue(), faceColour.GetAlpha());
-        glBegin(GL_TRIANGLE_FAN);
-            glVertex3f( 0, 0,  0);
-            glVertex3f( 1, 1,  1);
-            glVertex3i( 1, 1, -1);
-            glVertex3i(-1, 1, -1);
-            glVertex3i(-1, 1,  1);
-            glVertex3i( 1, 1,  1);
-        glEnd();
-
-        glEnable(GL_TEXTURE_2D);
-    }
-
-    void DrawCube(const ColourRGBA& faceColour, const ColourRGBA& lineColour)
-    {
-        DrawCube(faceColour);
-
-        glDisable(GL_TEXTURE_2D);
+    ShapeTransform& ShapeTransform::Rotate(float angle, float x, float y, float z)
+    {
+        const float len = sqrtf(x * x + y * y + z * z);
+        if (len == 0.0f) {
+            return *this;
+        }
 
-        glColor4f(lineColour.GetRed(), lineColour.GetGreen(), lineColour.GetBlue(), lineColour.GetAlpha());
-        // Bottom lines
-        glBegin(GL_LINE_LOOP);
-            glVertex3f(-0.5f, -0.5f, -0.5f);
-            glVertex3f( 0.5f, -0.5f, -0.5f);
-            glVertex3f( 0.5f,  0.5f, -0.5f);
-            glVertex3f(-0.5f,  0.5f, -0.5f);
-        glEnd();
-
-        // Top lines
-        glBegin(GL_LINE_LOOP);
-            glVertex3f(-0.5f,  0.5f, 0.5f);
-            glVertex3f( 0.5f,  0.5f, 0.5f);
-            glVertex3f( 0.5f, -0.5f, 0.5f);
-            glVertex3f(-0.5f, -0.5f, 0.5f);
-        glEnd();
-
-        // Side lines
-        glBegin(GL_LINES);
-            glVertex3f( 0.5f,  0.5f, -0.5f);
-            glVertex3f( 0.5f,  0.5f,  0.5f);
-
-            glVertex3f(-0.5f,  0.5f, -0.5f);
-            glVertex3f(-0.5f,  0.5f,  0.5f);
-
-            glVertex3f( 0.5f, -0.5f, -0.5f);
-            glVertex3f( 0.5f, -0.5f,  0.5f);
-
-            glVertex3f(-0.5f, -0.5f, -0.5f);
-            glVertex3f(-0.5f, -0.5f,  0.5f);
-        glEnd();
-
-        glEnable(GL_TEXTURE_2D);
-    }
-
-    void DrawCube(const ColourRGBA& faceColour)
-    {
-        glDisable(GL_TEXTURE_2D);
-
-        glColor4f(faceColour.GetRed(), faceColour.GetGreen(), faceColour.GetBlue(), faceColour.GetAlpha());
-        glBegin(GL_QUADS);
-            // Bottom
-            glVertex3f(-0.5f, -0.5f, -0.5f);
-            glVertex3f( 0.5f, -0.5f, -0.5f);
-            glVertex3f( 0.5f,  0.5f, -0.5f);
-            glVertex3f(-0.5f,  0.5f, -0.5f);
-
-            // Top
-            glVertex3f(-0.5f,  0.5f, 0.5f);
-            glVertex3f( 0.5f,  0.5f, 0.5f);
-            glVertex3f( 0.5f, -0.5f, 0.5f);
-            glVertex3f(-0.5f, -0.5f, 0.5f);
-
-            // Left
-            glVertex3f(-0.5f, -0.5f,  -0.5f);
-            glVertex3f(-0.5f, -0.5f,   0.5f);
-            glVertex3f(-0.5f,  0.5f,   0.5f);
-            glVertex3f(-0.5f,  0.5f,  -0.5f);
-
-            // Right
-            glVertex3f(0.5f,  0.5f,  -0.5f);
-            glVertex3f(0.5f,  0.5f,   0.5f);
-            glVertex3f(0.5f, -0.5f,   0.5f);
-            glVertex3f(0.5f, -0.5f,  -0.5f);
-
-            // Up
-            glVertex3f(-0.5f, 0.5f, -0.5f);
-            glVertex3f( 0.5f, 0.5f, -0.5f);
-            glVertex3f( 0.5f, 0.5f,  0.5f);
-            glVertex3f(-0.5f, 0.5f,  0.5f);
-
-            // Down
-            glVertex3f(-0.5f, -0.5f,  0.5f);
-            glVertex3f( 0.5f, -0.5f,  0.5f);
-            glVertex3f( 0.5f, -0.5f, -0.5f);
-            glVertex3f(-0.5f, -0.5f, -0.5f);
-        glEnd();
-
-        glEnable(GL_TEXTURE_2D);
-    }
-
-    static void DrawDodecahedronFace(const juzutil::Vector3& p1,
-                                     const juzutil::Vector3& p2,
-                                     const juzutil::Vector3& p3,
-                                     const juzutil::Vector3& p4,
-                                     const juzutil::Vector3& p5,
-                                     GLenum type)
-    {
-        glBegin(type);
-            glVertex3f(p1[0], p1[1], p1[2]);
-            glVertex3f(p2[0], p2[1], p2[2]);
-            glVertex3f(p3[0], p3[1], p3[2]);
-            glVertex3f(p4[0], p4[1], p4[2]);
-            glVertex3f(p5[0], p5[1], p5[2]);
-        glEnd();
-    }
-
-    void DrawDodecahedron(const ColourRGBA& faceColour, const ColourRGBA& lineColour)
-    {
-        const static float PHI = 1.6180339887f;
-        const static juzutil::Vector3 points[] = {
-            juzutil::Vector3(-1.0f/PHI,  0.0f,      PHI),
-            juzutil::Vector3( 1.0f/PHI,  0.0f,      PHI),
-            juzutil::Vector3(-1.0f,     -1.0f,     -1.0f),
-            juzutil::Vector3(-1.0f,     -1.0f,      1.0f),
-            juzutil::Vector3(-1.0f,      1.0f,     -1.0f),
-            juzutil::Vector3(-1.0f,      1.0f,      1.0f),
-            juzutil::Vector3(1.0f,      -1.0f,     -1.0f),
-            juzutil::Vector3(1.0f,      -1.0f,      1.0f),
-            juzutil::Vector3(1.0f,       1.0f,     -1.0f),
-            juzutil::Vector3(1.0f,       1.0f,      1.0f),
-            juzutil::Vector3(PHI,        1.0f/PHI,  0.0f),
-            juzutil::Vector3(PHI,       -1.0f/PHI,  0.0f),
-            juzutil::Vector3(-PHI,       1.0f/PHI,  0.0f),
-            juzutil::Vector3(-PHI,      -1.0f/PHI, -0.0f),
-            juzutil::Vector3(-1.0f/PHI,  0.0f,     -PHI),
-            juzutil::Vector3(1.0f/PHI,   0.0f,     -PHI),
-            juzutil::Vector3(0.0f,       PHI,       1.0f/PHI),
-            juzutil::Vector3(0.0f,       PHI,      -1.0f/PHI),
-            juzutil::Vector3(0.0f,      -PHI,       1.0f/PHI),
-            juzutil::Vector3(0.0f,      -PHI,      -1.0f/PHI),
+        x /= len;
+        y /= len;
+        z /= len;
+
+        // Same rotation matrix as glRotatef.
+        const float rad = DegToRad(angle);
+        const float c   = cosf(rad);
+        const float s   = sinf(rad);
+        const float t   = 1.0f - c;
+        const float rot[3][3] = {
+            { x * x * t + c,     x * y * t - z * s, x * z * t + y * s },
+            { y * x * t + z * s, y * y * t + c,     y * z * t - x * s },
+            { z * x * t - y * s, z * y * t + x * s, z * z * t + c     }
         };
 
-        glDisable(GL_TEXTURE_2D);
-
-        glColor4f(faceColour.GetRed(), faceColour.GetGreen(), faceColour.GetBlue(), faceColour.GetAlpha());
-        DrawDodecahedronFace(points[0],  points[1],  points[9],  points[16], points[5],  GL_POLYGON);
-        DrawDodecahedronFace(points[1],  points[0],  points[3],  points[18], points[7],  GL_POLYGON);
-        DrawDodecahedronFace(points[1],  points[7],  points[11], points[10], points[9],  GL_POLYGON);
-        DrawDodecahedronFace(points[11], points[7],  points[18], points[19], points[6],  GL_POLYGON);
-        DrawDodecahedronFace(points[8],  points[17], points[16], points[9],  points[10], GL_POLYGON);
-        DrawDodecahedronFace(points[2],  points[14], points[15], points[6],  points[19], GL_POLYGON);
-        DrawDodecahedronFace(points[2],  points[13], points[12], points[4],  points[14], GL_POLYGON);
-        DrawDodecahedronFace(points[2],  points[19], points[18], points[3],  points[13], GL_POLYGON);
-        DrawDodecahedronFace(points[3],  points[0],  points[5],  points[12], points[13], GL_POLYGON);
-        DrawDodecahedronFace(points[6],  points[15], points[8],  points[10], points[11], GL_POLYGON);
-        DrawDodecahedronFace(points[4],  points[17], points[8],  points[15], points[14], GL_POLYGON);
-        DrawDodecahedronFace(points[4],  points[12], points[5],  points[16], points[17], GL_POLYGON);
-
-        glColor4f(lineColour.GetRed(), lineColour.GetGreen(), lineColour.GetBlue(), lineColour.GetAlpha());
-        DrawDodecahedronFace(points[0],  points[1],  points[9],  points[16], points[5],  GL_LINE_LOOP);
-        DrawDodecahedronFace(points[1],  points[0],  points[3],  points[18], points[7],  GL_LINE_LOOP);
-        DrawDodecahedronFace(points[1],  points[7],  points[11], points[10], points[9],  GL_LINE_LOOP);
-        DrawDodecahedronFace(points[11], points[7],  points[18], points[19], points[6],  GL_LINE_LOOP);
-        DrawDodecahedronFace(points[8],  points[17], points[16], points[9],  points[10], GL_LINE_LOOP);
-        DrawDodecahedronFace(points[2],  points[14], points[15], points[6],  points[19], GL_LINE_LOOP);
-        DrawDodecahedronFace(points[2],  points[13], points[12], points[4],  points[14], GL_LINE_LOOP);
-        DrawDodecahedronFace(points[2],  points[19], points[18], points[3],  points[13], GL_LINE_LOOP);
-        DrawDodecahedronFace(points[3],  points[0],  points[5],  points[12], points[13], GL_LINE_LOOP);
-        DrawDodecahedronFace(points[6],  points[15], points[8],  points[10], points[11], GL_LINE_LOOP);
-        DrawDodecahedronFace(points[4],  points[17], points[8],  points[15], points[14], GL_LINE_LOOP);
-        DrawDodecahedronFace(points[4],  points[12], points[5],  points[16], points[17], GL_LINE_LOOP);
-
-        glEnable(GL_TEXTURE_2D);
-    }
-
-    void DrawSphere(const ColourRGBA& colour)
+        for (unsigned int row = 0; row < 3; row++) {
+            float *m = &m_matrix[row * 4];
+            const float m0 = m[0];
+            const float m1 = m[1];
+            const float m2 = m[2];
+
+            for (unsigned int col = 0; col < 3; col++) {
+                m[col] = m0 * rot[0][col] + m1 * rot[1][col] + m2 * rot[2][col];
+            }
+        }
+
+        return *this;
+    }
+
+    ShapeTransform& ShapeTransform::Scale(float x, float y, float z)
+    {
+        for (unsigned int row = 0; row < 3; row++) {
+            float *m = &m_matrix[row * 4];
+            m[0] *= x;
+            m[1] *= y;
+            m[2] *= z;
+        }
+
+        return *this;
+    }
+
+    ShapeTransform& ShapeTransform::Scale(float s)
+    {
+        return Scale(s, s, s);
+    }
+
+    void ShapeTransform::Apply(const float *in, float *out) const
+    {
+        for (unsigned int row = 0; row < 3; row++) {
+            const float *m = &m_matrix[row * 4];
+            out[row] = m[0] * in[0] + m[1] * in[1] + m[2] * in[2] + m[3];
+        }
+    }
+
+
+    //////////////////////////////////////////////////////////////////////////
+    // Meshes
+    //////////////////////////////////////////////////////////////////////////
+
+    enum ShapeType {
+        SHAPE_PYRAMID,
+        SHAPE_CUBE,
+        SHAPE_DODECAHEDRON,
+        SHAPE_SPHERE,
+        SHAPE_COUNT
+    };
+
+    // Model space geometry for one shape, shared by every instance of it.
+    struct ShapeMesh
+    {
+        std::vector<float>          verts;
+        std::vector<unsigned short> triangles;
+        std::vector<unsigned short> lines;
+    };
+
+    // A queued draw of a shape.
+    struct ShapeInstance
+    {
+        ShapeTransform transform;
+        ColourRGBA     faceColour;
+        ColourRGBA     lineColour;
+        bool           outline;
+    };
+
+    struct ShapeVertex
+    {
+        float x, y, z;
+        float r, g, b, a;
+    };
+
+    static void AddVerts(ShapeMesh& mesh, const float *verts, unsigned int count)
+    {
+        mesh.verts.insert(mesh.verts.end(), verts, verts + count * 3);
+    }
+
+    static void AddIndices(std::vector<unsigned short>& indices, const unsigned short *src, unsigned int count)
+    {
+        indices.insert(indices.end(), src, src + count);
+    }
+
+    static void BuildPyramid(ShapeMesh& mesh)
+    {
+        const float verts[] = {
+             0.0f, 0.0f,  0.0f,
+             1.0f, 1.0f,  1.0f,
+             1.0f, 1.0f, -1.0f,
+            -1.0f, 1.0f, -1.0f,
+            -1.0f, 1.0f,  1.0f,
+        };
+        const unsigned short triangles[] = {
+            0, 1, 2,  0, 2, 3,  0, 3, 4,  0, 4, 1,
+        };
+        const unsigned short lines[] = {
+            0, 1,  1, 2,  2, 0,  0, 3,  3, 4,  4, 0,  1, 4,  2, 3,
+        };
+
+        AddVerts(mesh, verts, 5);
+        AddIndices(mesh.triangles, triangles, sizeof(triangles) / sizeof(triangles[0]));
+        AddIndices(mesh.lines, lines, sizeof(lines) / sizeof(lines[0]));
+    }
+
+    static void BuildCube(ShapeMesh& mesh)
+    {
+        const float verts[] = {
+            -0.5f, -0.5f, -0.5f,
+             0.5f, -0.5f, -0.5f,
+             0.5f,  0.5f, -0.5f,
+            -0.5f,  0.5f, -0.5f,
+            -0.5f,  0.5f,  0.5f,
+             0.5f,  0.5f,  0.5f,
+             0.5f, -0.5f,  0.5f,
+            -0.5f, -0.5f,  0.5f,
+        };
+        const unsigned short quads[] = {
+            0, 1, 2, 3, // Bottom
+            4, 5, 6, 7, // Top
+            0, 7, 4, 3, // Left
+            2, 5, 6, 1, // Right
+            3, 2, 5, 4, // Up
+            7, 6, 1, 0, // Down
+        };
+        const unsigned short lines[] = {
+            0, 1,  1, 2,  2, 3,  3, 0, // Bottom
+            4, 5,  5, 6,  6, 7,  7, 4, // Top
+            2, 5,  3, 4,  1, 6,  0, 7, // Sides
+        };
+
+        AddVerts(mesh, verts, 8);
+        for (unsigned int i = 0; i < sizeof(quads) / sizeof(quads[0]); i += 4) {
+            const unsigned short tris[] = {
+                quads[i], quads[i + 1], quads[i + 2],
+                quads[i], quads[i + 2], quads[i + 3],
+            };
+            AddIndices(mesh.triangles, tris, 6);
+        }
+        AddIndices(mesh.lines, lines, sizeof(lines) / sizeof(lines[0]));
+    }
+
+    static void BuildDodecahedron(ShapeMesh& mesh)
+    {
+        const float PHI = 1.6180339887f;
+        const float verts[] = {
+            -1.0f/PHI,  0.0f,      PHI,
+             1.0f/PHI,  0.0f,      PHI,
+            -1.0f,     -1.0f,     -1.0f,
+            -1.0f,     -1.0f,      1.0f,
+            -1.0f,      1.0f,     -1.0f,
+            -1.0f,      1.0f,      1.0f,
+             1.0f,     -1.0f,     -1.0f,
+             1.0f,     -1.0f,      1.0f,
+             1.0f,      1.0f,     -1.0f,
+             1.0f,      1.0f,      1.0f,
+             PHI,       1.0f/PHI,  0.0f,
+             PHI,      -1.0f/PHI,  0.0f,
+            -PHI,       1.0f/PHI,  0.0f,
+            -PHI,      -1.0f/PHI, -0.0f,
+            -1.0f/PHI,  0.0f,     -PHI,
+             1.0f/PHI,  0.0f,     -PHI,
+             0.0f,      PHI,       1.0f/PHI,
+             0.0f,      PHI,      -1.0f/PHI,
+             0.0f,     -PHI,       1.0f/PHI,
+             0.0f,     -PHI,      -1.0f/PHI,
+        };
+        const unsigned short faces[] = {
+            0,  1,  9,  16, 5,
+            1,  0,  3,  18, 7,
+            1,  7,  11, 10, 9,
+            11, 7,  18, 19, 6,
+            8,  17, 16, 9,  10,
+            2,  14, 15, 6,  19,
+            2,  13, 12, 4,  14,
+            2,  19, 18, 3,  13,
+            3,  0,  5,  12, 13,
+            6,  15, 8,  10, 11,
+            4,  17, 8,  15, 14,
+            4,  12, 5,  16, 17,
+        };
+
+        AddVerts(mesh, verts, 20);
+        for (unsigned int i = 0; i < sizeof(faces) / sizeof(faces[0]); i += 5) {
+            const unsigned short *face = &faces[i];
+            const unsigned short tris[] = {
+                face[0], face[1], face[2],
+                face[0], face[2], face[3],
+                face[0], face[3], face[4],
+            };
+            const unsigned short lines[] = {
+                face[0], face[1],  face[1], face[2],  face[2], face[3],
+                face[3], face[4],  face[4], face[0],
+            };
+            AddIndices(mesh.triangles, tris, 9);
+            AddIndices(mesh.lines, lines, 10);
+        }
+    }
+
+    static void BuildSphere(ShapeMesh& mesh)
     {
         const unsigned int SPHERE_LATS = 10;
         const unsigned int SPHERE_LONGS = 10;
 
-        glDisable(GL_TEXTURE_2D);
-        glColor4f(colour.GetRed(), colour.GetGreen(), colour.GetBlue(), colour.GetAlpha());
-
+        // Each latitude band was originally a quad strip, built with the
+        // same (slightly odd, the i - 1 and j - 1 wrap) coordinates so the
+        // sphere looks exactly as it did.
         for (unsigned int i = 0; i < SPHERE_LATS; i++) {
             const float lat0 = static_cast<float>(M_PI) * (-0.5f + static_cast<float>(i - 1) / static_cast<float>(SPHERE_LATS));
             const float z0 = sinf(lat0);
@@ -230,18 +275,176 @@ namespace typing
             const float z1 = sinf(lat1);
             const float zr1 = cosf(lat1);
 
-            glBegin(GL_QUAD_STRIP);
+            const unsigned short base = static_cast<unsigned short>(mesh.verts.size() / 3);
             for(unsigned int j = 0; j <= SPHERE_LONGS; j++) {
                 const float lng = 2.0f * static_cast<float>(M_PI) * static_cast<float>(j - 1) / static_cast<float>(SPHERE_LONGS);
                 const float x = cosf(lng);
                 const float y = sinf(lng);
 
-                glVertex3f(x * zr0, y * zr0, z0);
-                glVertex3f(x * zr1, y * zr1, z1);
+                const float verts[] = {
+                    x * zr0, y * zr0, z0,
+                    x * zr1, y * zr1, z1,
+                };
+                AddVerts(mesh, verts, 2);
+            }
+
+            for (unsigned int j = 0; j < SPHERE_LONGS; j++) {
+                const unsigned short v = static_cast<unsigned short>(base + j * 2);
+                const unsigned short tris[] = {
+                    v,                                   static_cast<unsigned short>(v + 1), static_cast<unsigned short>(v + 2),
+                    static_cast<unsigned short>(v + 2), static_cast<unsigned short>(v + 1), static_cast<unsigned short>(v + 3),
+                };
+                AddIndices(mesh.triangles, tris, 6);
+            }
+        }
+    }
+
+    static const ShapeMesh& GetMesh(ShapeType type)
+    {
+        static ShapeMesh meshes[SHAPE_COUNT];
+        static bool      built = false;
+
+        if (!built) {
+            BuildPyramid(meshes[SHAPE_PYRAMID]);
+            BuildCube(meshes[SHAPE_CUBE]);
+            BuildDodecahedron(meshes[SHAPE_DODECAHEDRON]);
+            BuildSphere(meshes[SHAPE_SPHERE]);
+            built = true;
+        }
+
+        return meshes[type];
+    }
+
+
+    //////////////////////////////////////////////////////////////////////////
+    // Batching
+    //////////////////////////////////////////////////////////////////////////
+
+    // Instances queued since the last flush, and the scratch buffers they are
+    // transformed into. All of these keep their capacity between frames.
+    static std::vector<ShapeInstance> s_instances[SHAPE_COUNT];
+    static std::vector<ShapeVertex>   s_faceVerts;
+    static std::vector<ShapeVertex>   s_lineVerts;
+    static std::vector<float>         s_transformed;
+
+    static void QueueShape(ShapeType             type,
+                           const ShapeTransform& transform,
+                           const ColourRGBA&     faceColour,
+                           const ColourRGBA&     lineColour,
+                           bool                  outline)
+    {
+        ShapeInstance instance;
+        instance.transform  = transform;
+        instance.faceColour = faceColour;
+        instance.lineColour = lineColour;
+        instance.outline    = outline;
+
+        s_instances[type].push_back(instance);
+    }
+
+    static void EmitVerts(std::vector<ShapeVertex>&          out,
+                          const std::vector<unsigned short>& indices,
+                          const std::vector<float>&          positions,
+                          const ColourRGBA&                  colour)
+    {
+        ShapeVertex vert;
+        vert.r = colour.GetRed();
+        vert.g = colour.GetGreen();
+        vert.b = colour.GetBlue();
+        vert.a = colour.GetAlpha();
+
+        for (std::vector<unsigned short>::const_iterator iter = indices.begin(); iter != indices.end(); ++iter)
+        {
+            const float *pos = &positions[*iter * 3];
+            vert.x = pos[0];
+            vert.y = pos[1];
+            vert.z = pos[2];
+            out.push_back(vert);
+        }
+    }
+
+    static void DrawVerts(GLenum mode, const std::vector<ShapeVertex>& verts)
+    {
+        if (verts.empty()) {
+            return;
+        }
+
+        const ShapeVertex& first = verts.front();
+        glVertexPointer(3, GL_FLOAT, sizeof(ShapeVertex), &first.x);
+        glColorPointer(4, GL_FLOAT, sizeof(ShapeVertex), &first.r);
+        PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
+        glDrawArrays(mode, 0, static_cast<GLsizei>(verts.size()));
+    }
+
+    void DrawPyramid(const ShapeTransform& transform, const ColourRGBA& faceColour)
+    {
+        QueueShape(SHAPE_PYRAMID, transform, faceColour, faceColour, false);
+    }
+
+    void DrawPyramid(const ShapeTransform& transform, const ColourRGBA& faceColour, const ColourRGBA& lineColour)
+    {
+        QueueShape(SHAPE_PYRAMID, transform, faceColour, lineColour, true);
+    }
+
+    void DrawCube(const ShapeTransform& transform, const ColourRGBA& faceColour)
+    {
+        QueueShape(SHAPE_CUBE, transform, faceColour, faceColour, false);
+    }
+
+    void DrawCube(const ShapeTransform& transform, const ColourRGBA& faceColour, const ColourRGBA& lineColour)
+    {
+        QueueShape(SHAPE_CUBE, transform, faceColour, lineColour, true);
+    }
+
+    void DrawDodecahedron(const ShapeTransform& transform, const ColourRGBA& faceColour, const ColourRGBA& lineColour)
+    {
+        QueueShape(SHAPE_DODECAHEDRON, transform, faceColour, lineColour, true);
+    }
+
+    void DrawSphere(const ShapeTransform& transform, const ColourRGBA& colour)
+    {
+        QueueShape(SHAPE_SPHERE, transform, colour, colour, false);
+    }
+
+    void FlushShapes()
+    {
+        s_faceVerts.clear();
+        s_lineVerts.clear();
+
+        for (unsigned int type = 0; type < SHAPE_COUNT; type++) {
+            const ShapeMesh&             mesh      = GetMesh(static_cast<ShapeType>(type));
+            std::vector<ShapeInstance>&  instances = s_instances[type];
+
+            s_transformed.resize(mesh.verts.size());
+
+            for (std::vector<ShapeInstance>::const_iterator iter = instances.begin(); iter != instances.end(); ++iter)
+            {
+                for (std::vector<float>::size_type i = 0; i < mesh.verts.size(); i += 3) {
+                    iter->transform.Apply(&mesh.verts[i], &s_transformed[i]);
+                }
+
+                EmitVerts(s_faceVerts, mesh.triangles, s_transformed, iter->faceColour);
+                if (iter->outline) {
+                    EmitVerts(s_lineVerts, mesh.lines, s_transformed, iter->lineColour);
+                }
             }
-            glEnd();
+
+            instances.clear();
         }
 
-        glEnable(GL_TEXTURE_2D);
+        if (s_faceVerts.empty() && s_lineVerts.empty()) {
+            return;
+        }
+
+        RENDERSTATE.Disable(GL_TEXTURE_2D);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+
+        DrawVerts(GL_TRIANGLES, s_faceVerts);
+        DrawVerts(GL_LINES, s_lineVerts);
+
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        RENDERSTATE.InvalidateColour();
     }
 }
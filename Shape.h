@@ -2,15 +2,44 @@
 #define __SHAPE_H__
 
 #include "Colour.h"
+#include "Vector.h"
 
 namespace typing
 {
-    void DrawPyramid(const ColourRGBA& faceColour);
-    void DrawPyramid(const ColourRGBA& faceColour, const ColourRGBA& lineColour);
-    void DrawCube(const ColourRGBA& faceColour);
-    void DrawCube(const ColourRGBA& faceColour, const ColourRGBA& lineColour);
-    void DrawDodecahedron(const ColourRGBA& faceColour, const ColourRGBA& lineColour);
-    void DrawSphere(const ColourRGBA& colour);
+    // A transform for a batched shape, applied on the CPU when the batch is
+    // flushed. The methods behave like glTranslatef, glRotatef and glScalef,
+    // and are applied in the same order as the equivalent GL calls would be.
+    class ShapeTransform
+    {
+    public:
+        // Ctors/Dtors
+        ShapeTransform();
+
+        // Methods
+        ShapeTransform& Translate(float x, float y, float z);
+        ShapeTransform& Translate(const juzutil::Vector3& v);
+        ShapeTransform& Rotate(float angle, float x, float y, float z);
+        ShapeTransform& Scale(float x, float y, float z);
+        ShapeTransform& Scale(float s);
+        void            Apply(const float *in, float *out) const;
+
+    private:
+        // Members
+        // The upper 3x4 of the matrix, stored by row.
+        float m_matrix[12];
+    };
+
+    // The shape functions queue an instance of the shape, which is drawn by
+    // the next call to FlushShapes. All queued shapes are drawn with one call
+    // for the faces and one for the outlines, so the faces of every shape are
+    // drawn before any of the outlines.
+    void DrawPyramid(const ShapeTransform& transform, const ColourRGBA& faceColour);
+    void DrawPyramid(const ShapeTransform& transform, const ColourRGBA& faceColour, const ColourRGBA& lineColour);
+    void DrawCube(const ShapeTransform& transform, const ColourRGBA& faceColour);
+    void DrawCube(const ShapeTransform& transform, const ColourRGBA& faceColour, const ColourRGBA& lineColour);
+    void DrawDodecahedron(const ShapeTransform& transform, const ColourRGBA& faceColour, const ColourRGBA& lineColour);
+    void DrawSphere(const ShapeTransform& transform, const ColourRGBA& colour);
+    void FlushShapes();
 }
 
 #endif // __SHAPE_H__
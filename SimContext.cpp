@@ -0,0 +1,38 @@
+#include "SimContext.h"
+#include "App.h"
+#include "Game.h"
+
+namespace typing
+{
+    SimContext::SimContext()
+        : m_game(new Game), m_time(0.0f)
+    {
+    }
+
+
+    SimContext::~SimContext()
+    {
+    }
+
+
+    void SimContext::Init()
+    {
+        m_game->Init(GAME);
+    }
+
+
+    void SimContext::Bind()
+    {
+        Game::SetThreadGame(m_game.get());
+        Random::SetThreadRandom(&m_random);
+        App::SetThreadClock(&m_time);
+    }
+
+
+    void SimContext::Unbind()
+    {
+        Game::SetThreadGame(NULL);
+        Random::SetThreadRandom(NULL);
+        App::SetThreadClock(NULL);
+    }
+}
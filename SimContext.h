@@ -0,0 +1,61 @@
+#ifndef _SIM_CONTEXT_H_
+#define _SIM_CONTEXT_H_
+
+#include <memory>
+#include "Random.h"
+
+namespace typing
+{
+    class Game;
+
+    // Everything a simulated game owns, so that several games can be played
+    // at once on different threads. The context holds its own game, random
+    // number generator and clock, and binding it to a thread makes GAME,
+    // RAND and APP.GetTime() refer to them there. Media and the phrases
+    // themselves are only read while playing, and stay shared.
+    class SimContext
+    {
+    public:
+        // Ctors/Dtors
+        SimContext();
+        ~SimContext();
+
+        // Methods
+        // Init
+        // Sets up the context's game to share the phrases of the main game.
+        // This registers media with the managers, so it must be called from
+        // the main thread before the context is bound to another.
+        void Init();
+
+        // Bind
+        // Makes the calling thread use this context until Unbind is called.
+        void Bind();
+        static void Unbind();
+
+        void SetTime(double time)
+        {
+            m_time = time;
+        }
+
+        double GetTime() const
+        {
+            return m_time;
+        }
+
+        Game& GetGame()
+        {
+            return *m_game;
+        }
+
+    private:
+        // Ctors/Dtors
+        SimContext(const SimContext& context);
+
+        // Members
+        std::unique_ptr<Game> m_game;
+        Random                m_random;
+        double                m_time;
+    };
+}
+
+#endif // _SIM_CONTEXT_H_
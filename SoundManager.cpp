@@ -3,14 +3,22 @@
 
 namespace typing
 {
+    // A sound without a chunk comes from a headless sound manager, and is
+    // silent.
     void Sound::Play(int loops)
     {
-        m_channel = Mix_PlayChannel(-1, m_chunk, loops);
+        if (m_chunk)
+        {
+            m_channel = Mix_PlayChannel(-1, m_chunk, loops);
+        }
     }
 
     void Sound::FadeIn(int loops, int ms)
     {
-        m_channel = Mix_FadeInChannel(-1, m_chunk, loops, ms);
+        if (m_chunk)
+        {
+            m_channel = Mix_FadeInChannel(-1, m_chunk, loops, ms);
+        }
     }
 
     void Sound::FadeOut(int ms)
@@ -35,27 +43,33 @@ namespace typing
         return *(m_singleton.get());
     }
 
-    Sound SoundManager::Add(const std::string& soundName)
+    // A headless sound manager registers sounds without loading them, so
+    // they are silent.
+    SoundHandle SoundManager::Add(const std::string& soundName)
     {
-        if(m_soundMap.find(soundName) == m_soundMap.end())
+        SoundMap::const_iterator iter = m_soundMap.find(soundName);
+        if (iter != m_soundMap.end())
         {
-            Mix_Chunk * sound = Mix_LoadWAV(soundName.c_str());
+            return iter->second;
+        }
+
+        Mix_Chunk * sound = NULL;
+        if (!m_headless)
+        {
+            sound = Mix_LoadWAV(soundName.c_str());
             if (!sound)
             {
                 throw FileNotFoundException(soundName);
             }
-            else
-            {
-                m_soundMap[soundName] = sound;
-            }
-
-            return Sound(sound);
-        } else {
-            return Get(soundName);
         }
+
+        const SoundHandle handle(static_cast<unsigned int>(m_chunks.size()));
+        m_chunks.push_back(sound);
+        m_soundMap[soundName] = handle;
+        return handle;
     }
 
-    Mix_Chunk * SoundManager::GetChunk(const std::string& soundName) const
+    SoundHandle SoundManager::GetHandle(const std::string& soundName) const
     {
         SoundMap::const_iterator iter = m_soundMap.find(soundName);
         if (iter == m_soundMap.end())
@@ -70,7 +84,7 @@ namespace typing
 
     Sound SoundManager::Get(const std::string& soundName) const
     {
-        return Sound(GetChunk(soundName));
+        return Get(GetHandle(soundName));
     }
 
     // SoundManager::Play can be used for 'fire and forget' sound playing.
@@ -83,6 +97,9 @@ namespace typing
 
     void SoundManager::StopAll() const
     {
-        Mix_HaltChannel(-1);
+        if (!m_headless)
+        {
+            Mix_HaltChannel(-1);
+        }
     }
 }
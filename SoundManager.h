@@ -4,8 +4,10 @@
 #include <string>
 #include <map>
 #include <memory>
+#include <vector>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_mixer.h>
+#include "AssetHandle.h"
 
 namespace typing
 {
@@ -31,6 +33,7 @@ namespace typing
         Mix_Chunk *m_chunk;
         int        m_channel;
     };
+    typedef AssetHandle<Sound> SoundHandle;
 
     class SoundManager
     {
@@ -39,25 +42,45 @@ namespace typing
         static SoundManager& GetSoundManager();
 
         // Methods
-        Sound Add(const std::string& soundName);
-        Sound Get(const std::string& soundName) const;
-        void  Play(const std::string& soundName) const;
-        void  StopAll() const;
+        SoundHandle Add(const std::string& soundName);
+        SoundHandle GetHandle(const std::string& soundName) const;
+        Sound       Get(const std::string& soundName) const;
+        void        Play(const std::string& soundName) const;
+        void        StopAll() const;
+
+        Sound Get(SoundHandle sound) const
+        {
+            return Sound(m_chunks[sound.index]);
+        }
+
+        void Play(SoundHandle sound) const
+        {
+            Get(sound).Play(0);
+        }
+
+        // SetHeadless
+        // When headless, sounds are registered without being loaded and
+        // never play, so that the game can run without audio.
+        void SetHeadless(bool headless)
+        {
+            m_headless = headless;
+        }
 
     private:
         // Ctors/Dtors
         SoundManager()
+            : m_headless(false)
         {
         }
 
         // Typedefs
-        typedef std::map<std::string, Mix_Chunk*> SoundMap;
-
-        // Methods
-        Mix_Chunk * GetChunk(const std::string& soundName) const;
+        typedef std::map<std::string, SoundHandle> SoundMap;
+        typedef std::vector<Mix_Chunk*>            ChunkVec;
 
         // Members
         SoundMap m_soundMap;
+        ChunkVec m_chunks;
+        bool     m_headless;
 
         // Singleton Implementation
         static std::auto_ptr<SoundManager> m_singleton;
@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include "TextureManager.h"
 #include "Exceptions.h"
+#include "RenderState.h"
 
 namespace typing
 {
@@ -69,7 +70,7 @@ namespace typing
         fclose(textureFile);
 
         glGenTextures(1, &m_id);
-        glBindTexture(GL_TEXTURE_2D, m_id);
+        RENDERSTATE.BindTexture(m_id);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR_MIPMAP_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -87,7 +88,21 @@ namespace typing
 
     void Texture::Bind() const
     {
-        glBindTexture(GL_TEXTURE_2D, m_id);
+        RENDERSTATE.BindTexture(m_id);
+    }
+
+    // x and y are in texels from the start of the image data, which for a
+    // TGA is the bottom left.
+    void Texture::FillSolid(unsigned int x, unsigned int y,
+                            unsigned int width, unsigned int height)
+    {
+        const std::vector<unsigned char> white(width * height * 4, 0xFF);
+
+        RENDERSTATE.BindTexture(m_id);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height,
+                        GL_RGBA, GL_UNSIGNED_BYTE, &white[0]);
     }
 
 
@@ -101,17 +116,27 @@ namespace typing
         return *(m_singleton.get());
     }
 
-    void TextureManager::Add(const std::string& textureName)
+    TextureHandle TextureManager::Add(const std::string& textureName)
     {
-        if (m_textureMap.find(textureName) == m_textureMap.end())
+        TextureMap::const_iterator iter = m_textureMap.find(textureName);
+        if (iter != m_textureMap.end())
+        {
+            return iter->second;
+        }
+
+        TexturePtr texture(new Texture());
+        if (!m_headless)
         {
-            TexturePtr texture(new Texture());
             texture->Load(textureName);
-            m_textureMap[textureName] = texture;
         }
+
+        const TextureHandle handle(static_cast<unsigned int>(m_textures.size()));
+        m_textures.push_back(texture);
+        m_textureMap[textureName] = handle;
+        return handle;
     }
 
-    const Texture& TextureManager::Get(const std::string& textureName) const
+    TextureHandle TextureManager::GetHandle(const std::string& textureName) const
     {
         TextureMap::const_iterator iter = m_textureMap.find(textureName);
         if (iter == m_textureMap.end())
@@ -120,10 +145,15 @@ namespace typing
         }
         else
         {
-            return *(iter->second);
+            return iter->second;
         }
     }
 
+    const Texture& TextureManager::Get(const std::string& textureName) const
+    {
+        return Get(GetHandle(textureName));
+    }
+
     void TextureManager::Bind(const std::string& textureName) const
     {
         Get(textureName).Bind();
@@ -5,8 +5,10 @@
 #include <memory>
 #include <map>
 #include <memory>
+#include <vector>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_opengl.h>
+#include "AssetHandle.h"
 
 namespace typing
 {
@@ -21,11 +23,14 @@ namespace typing
         // Methods
         void Load(const std::string& textureName);
         void Bind() const;
+        void FillSolid(unsigned int x, unsigned int y,
+                       unsigned int width, unsigned int height);
 
     private:
         GLuint m_id;
     };
     typedef std::shared_ptr<Texture> TexturePtr;
+    typedef AssetHandle<Texture>     TextureHandle;
 
     class TextureManager
     {
@@ -34,21 +39,60 @@ namespace typing
         static TextureManager& GetTextureManager();
 
         // Methods
-        void           Add(const std::string& textureName);
+        TextureHandle  Add(const std::string& textureName);
+        TextureHandle  GetHandle(const std::string& textureName) const;
         const Texture& Get(const std::string& textureName)  const;
         void           Bind(const std::string& textureName) const;
 
+        const Texture& Get(TextureHandle texture) const
+        {
+            return *m_textures[texture.index];
+        }
+
+        void Bind(TextureHandle texture) const
+        {
+            Get(texture).Bind();
+        }
+
+        // FillSolid
+        // Fills a block of the texture with opaque white, so that solid
+        // shapes can be drawn from it in the same batch as the rest of
+        // what uses it. Does nothing when headless.
+        void FillSolid(TextureHandle texture,
+                       unsigned int  x,
+                       unsigned int  y,
+                       unsigned int  width,
+                       unsigned int  height)
+        {
+            if (!m_headless) {
+                m_textures[texture.index]->FillSolid(x, y, width, height);
+            }
+        }
+
+        // SetHeadless
+        // When headless, textures are registered without being loaded, so
+        // that the game can run without a GL context. They must not be
+        // bound.
+        void SetHeadless(bool headless)
+        {
+            m_headless = headless;
+        }
+
     private:
         // Ctors/Dtors
         TextureManager()
+            : m_headless(false)
         {
         }
 
         // Typedefs
-        typedef std::map<std::string, TexturePtr> TextureMap;
+        typedef std::map<std::string, TextureHandle> TextureMap;
+        typedef std::vector<TexturePtr>              TextureVec;
 
         // Members
         TextureMap m_textureMap;
+        TextureVec m_textures;
+        bool       m_headless;
 
         // Singleton Implementation
         static std::auto_ptr<TextureManager> m_singleton;
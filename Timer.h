@@ -25,12 +25,12 @@ namespace typing
 
         void Update()
         {
-            float thisTime = APP.GetTime();
+            double thisTime = APP.GetTime();
 
             if (!m_paused)
             {
-                m_frameTime = thisTime - m_lastTime;
-                m_time += m_frameTime;
+                m_frameTime = static_cast<float>(thisTime - m_lastTime);
+                m_time += thisTime - m_lastTime;
             }
 
             m_lastTime = thisTime;
@@ -41,7 +41,7 @@ namespace typing
             return m_frameTime;
         }
 
-        float GetTime() const
+        double GetTime() const
         {
             return m_time;
         }
@@ -52,10 +52,12 @@ namespace typing
         }
 
     private:
-        float m_lastTime;
-        float m_frameTime;
-        float m_time;
-        bool  m_paused;
+        // The times are kept as doubles, so that they don't lose precision
+        // as a long game goes on.
+        double m_lastTime;
+        float  m_frameTime;
+        double m_time;
+        bool   m_paused;
     };
 }
 
@@ -0,0 +1,112 @@
+#include <cstdio>
+#include "Trace.h"
+#include "App.h"
+
+namespace typing
+{
+    thread_local Trace::ThreadBuffer *Trace::m_threadBuffer = NULL;
+
+    std::auto_ptr<Trace> Trace::m_singleton(new Trace);
+    Trace& Trace::GetTrace()
+    {
+        return *(m_singleton.get());
+    }
+
+    Trace::Trace()
+        : m_enabled(false), m_start(Clock::now())
+    {
+    }
+
+    void Trace::Init()
+    {
+        if (APP.HasOption("trace")) {
+            m_filename = APP.GetOption<std::string>("trace");
+            m_start    = Clock::now();
+            m_enabled  = true;
+        }
+    }
+
+    // Writes out the trace. Any other threads that were traced must have
+    // finished by now.
+    void Trace::Shutdown()
+    {
+        if (m_enabled) {
+            m_enabled = false;
+            Write();
+        }
+    }
+
+    void Trace::Add(const char *name, long long start, long long duration)
+    {
+        ThreadBuffer *buffer = GetThreadBuffer();
+
+        const unsigned int count = buffer->count.load(std::memory_order_relaxed);
+        Event& ev   = buffer->events[count % BUFFER_SIZE];
+        ev.name     = name;
+        ev.start    = start;
+        ev.duration = duration;
+
+        buffer->count.store(count + 1, std::memory_order_release);
+    }
+
+    // The lock is only taken the first time a thread records an event.
+    Trace::ThreadBuffer *Trace::GetThreadBuffer()
+    {
+        if (!m_threadBuffer) {
+            ThreadBufferPtr buffer(new ThreadBuffer);
+            buffer->events.resize(BUFFER_SIZE);
+            buffer->count.store(0);
+
+            std::lock_guard<std::mutex> lock(m_buffersMutex);
+            buffer->id = static_cast<unsigned int>(m_buffers.size()) + 1;
+            m_threadBuffer = buffer.get();
+            m_buffers.push_back(std::move(buffer));
+        }
+
+        return m_threadBuffer;
+    }
+
+    void Trace::Write() const
+    {
+        // This is called while shutting down, so report a failure rather
+        // than throwing.
+        FILE *file = fopen(m_filename.c_str(), "w");
+        if (!file) {
+            APP.Log(App::LOG_ERROR, "Couldn't write trace to " + m_filename);
+            return;
+        }
+
+        fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+        bool first = true;
+        for (ThreadBufferVec::const_iterator iter = m_buffers.begin();
+             iter != m_buffers.end();
+             ++iter) {
+            const ThreadBuffer& buffer = **iter;
+            const unsigned int  count  =
+                            buffer.count.load(std::memory_order_acquire);
+
+            // Once the buffer has wrapped, only the latest events are left.
+            const unsigned int begin =
+                            count > BUFFER_SIZE ? count - BUFFER_SIZE : 0;
+
+            for (unsigned int i = begin; i < count; i++) {
+                const Event& ev = buffer.events[i % BUFFER_SIZE];
+
+                fprintf(file, "%s\n{\"name\":\"%s\",\"pid\":1,\"tid\":%u,"
+                              "\"ts\":%lld,",
+                        first ? "" : ",", ev.name, buffer.id, ev.start);
+                if (ev.duration == INSTANT) {
+                    fprintf(file, "\"ph\":\"i\",\"s\":\"t\"}");
+                } else {
+                    fprintf(file, "\"ph\":\"X\",\"dur\":%lld}", ev.duration);
+                }
+
+                first = false;
+            }
+        }
+
+        fprintf(file, "\n]}\n");
+        fclose(file);
+    }
+}
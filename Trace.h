@@ -0,0 +1,135 @@
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace typing
+{
+    // Records spans and instant events for viewing on a timeline, written
+    // out as trace event JSON that chrome://tracing and Perfetto can load.
+    // Each thread writes to its own ring buffer without taking a lock, so
+    // tracing is cheap enough to leave on for long runs; once a buffer is
+    // full the oldest events are overwritten.
+    //
+    // Event names must be string literals, as only the pointer is kept.
+    class Trace
+    {
+    public:
+        // Methods
+        void Init();
+        void Shutdown();
+
+        bool IsEnabled() const
+        {
+            return m_enabled;
+        }
+
+        // Now
+        // Returns the time since tracing started in microseconds.
+        long long Now() const
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                        Clock::now() - m_start).count();
+        }
+
+        void Span(const char *name, long long start, long long duration)
+        {
+            if (m_enabled) {
+                Add(name, start, duration);
+            }
+        }
+
+        void Instant(const char *name)
+        {
+            if (m_enabled) {
+                Add(name, Now(), INSTANT);
+            }
+        }
+
+        // Singleton Implementation
+        static Trace& GetTrace();
+
+    private:
+        // Ctors/Dtors
+        Trace();
+        Trace(const Trace& t);
+
+        // Consts/Enums
+        // Each thread keeps its latest 64k events.
+        static const unsigned int BUFFER_SIZE = 65536;
+        static const long long    INSTANT     = -1;
+
+        // Typedefs
+        typedef std::chrono::steady_clock Clock;
+
+        struct Event
+        {
+            const char *name;
+            long long   start;
+            long long   duration;
+        };
+
+        // Only the owning thread writes to a buffer. The count is published
+        // after each event is written, so the buffer can be read once the
+        // thread has finished.
+        struct ThreadBuffer
+        {
+            unsigned int              id;
+            std::vector<Event>        events;
+            std::atomic<unsigned int> count;
+        };
+        typedef std::unique_ptr<ThreadBuffer> ThreadBufferPtr;
+        typedef std::vector<ThreadBufferPtr>  ThreadBufferVec;
+
+        // Methods
+        void          Add(const char *name, long long start, long long duration);
+        ThreadBuffer *GetThreadBuffer();
+        void          Write() const;
+
+        // Members
+        bool              m_enabled;
+        std::string       m_filename;
+        Clock::time_point m_start;
+        std::mutex        m_buffersMutex;
+        ThreadBufferVec   m_buffers;
+
+        static thread_local ThreadBuffer *m_threadBuffer;
+
+        // Singleton Implementation
+        static std::auto_ptr<Trace> m_singleton;
+    };
+    #define TRACE Trace::GetTrace()
+
+    // Records a span covering its lifetime.
+    class TraceScope
+    {
+    public:
+        // Ctors/Dtors
+        TraceScope(const char *name)
+            : m_name(name), m_start(TRACE.IsEnabled() ? TRACE.Now() : 0)
+        {
+        }
+
+        ~TraceScope()
+        {
+            if (TRACE.IsEnabled()) {
+                TRACE.Span(m_name, m_start, TRACE.Now() - m_start);
+            }
+        }
+
+    private:
+        // Ctors/Dtors
+        TraceScope(const TraceScope& scope);
+
+        // Members
+        const char *m_name;
+        long long   m_start;
+    };
+}
+
+#endif // _TRACE_H_
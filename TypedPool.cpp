@@ -0,0 +1,6 @@
+#include "TypedPool.h"
+
+namespace typing
+{
+    std::atomic<unsigned int> PoolTypeId::m_count(0);
+}
@@ -0,0 +1,125 @@
+#ifndef _TYPED_POOL_H_
+#define _TYPED_POOL_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+#include <boost/core/demangle.hpp>
+#include "ObjectPool.h"
+
+namespace typing
+{
+    // How full one of the pools in a TypedPools is.
+    struct PoolStats
+    {
+        std::string  name;
+        unsigned int live;
+        unsigned int highWater;
+        unsigned int capacity;
+    };
+    typedef std::vector<PoolStats> PoolStatsVec;
+
+    // Gives each pooled type a small id, used to find its pool. The ids are
+    // shared by every set of pools, whichever thread it is used on, so the
+    // count is atomic.
+    class PoolTypeId
+    {
+    public:
+        template<typename T> static unsigned int Get()
+        {
+            static const unsigned int id = m_count++;
+            return id;
+        }
+
+    private:
+        static std::atomic<unsigned int> m_count;
+    };
+
+    // An object pool for each type derived from Base, created the first time
+    // an object of that type is needed. Objects are destroyed through the
+    // pool they came from, so the caller only has to keep a Base pointer
+    // and its pool.
+    template<typename Base> class TypedPools
+    {
+    public:
+        class PoolBase
+        {
+        public:
+            virtual ~PoolBase()
+            {
+            }
+
+            virtual void Destroy(Base *obj) = 0;
+            virtual void GetStats(PoolStats& stats) const = 0;
+        };
+
+        template<typename T> class Pool : public PoolBase
+        {
+        public:
+            template<typename... Args> T *Create(Args&&... args)
+            {
+                return m_objects.Create(std::forward<Args>(args)...);
+            }
+
+            void Reserve(unsigned int count)
+            {
+                m_objects.Reserve(count);
+            }
+
+            void Destroy(Base *obj)
+            {
+                m_objects.Destroy(static_cast<T *>(obj));
+            }
+
+            void GetStats(PoolStats& stats) const
+            {
+                stats.name      = boost::core::demangle(typeid(T).name());
+                stats.live      = m_objects.Live();
+                stats.highWater = m_objects.HighWater();
+                stats.capacity  = m_objects.Capacity();
+            }
+
+        private:
+            ObjectPool<T> m_objects;
+        };
+
+        // Methods
+        template<typename T> Pool<T>& Get()
+        {
+            const unsigned int id = PoolTypeId::Get<T>();
+            if (id >= m_pools.size()) {
+                m_pools.resize(id + 1);
+            }
+            if (!m_pools[id]) {
+                m_pools[id].reset(new Pool<T>);
+            }
+
+            return static_cast<Pool<T>&>(*m_pools[id]);
+        }
+
+        void GetStats(PoolStatsVec& stats) const
+        {
+            for (typename PoolVec::const_iterator iter = m_pools.begin(); iter != m_pools.end(); ++iter)
+            {
+                if (*iter) {
+                    PoolStats poolStats;
+                    (*iter)->GetStats(poolStats);
+                    stats.push_back(poolStats);
+                }
+            }
+        }
+
+    private:
+        // Typedefs
+        typedef std::unique_ptr<PoolBase> PoolPtr;
+        typedef std::vector<PoolPtr>      PoolVec;
+
+        // Members
+        PoolVec m_pools;
+    };
+}
+
+#endif // _TYPED_POOL_H_
@@ -5,6 +5,8 @@
 #include "Utils.h"
 #include "TextureManager.h"
 #include "Colour.h"
+#include "Profiler.h"
+#include "RenderState.h"
 
 namespace typing
 {
@@ -14,8 +16,20 @@ namespace typing
 
     void DrawTexturedRect(const std::string& texture, float x, float y, float width, float height)
     {
-        glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+        DrawTexturedRect(TEXTURES.GetHandle(texture), x, y, width, height);
+    }
+
+    void DrawTexturedRect(const std::string& texture, const ColourRGBA& col, float x, float y, float width, float height)
+    {
+        DrawTexturedRect(TEXTURES.GetHandle(texture), col, x, y, width, height);
+    }
+
+    void DrawTexturedRect(TextureHandle texture, float x, float y, float width, float height)
+    {
+        RENDERSTATE.Colour(1.0f, 1.0f, 1.0f, 1.0f);
+        RENDERSTATE.Enable(GL_TEXTURE_2D);
         TEXTURES.Bind(texture);
+        PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
         glBegin(GL_QUADS);
             glTexCoord2f(0.0f, 0.0f);
             glVertex2f(x, y + height);
@@ -31,10 +45,12 @@ namespace typing
         glEnd();
     }
 
-    void DrawTexturedRect(const std::string& texture, const ColourRGBA& col, float x, float y, float width, float height)
+    void DrawTexturedRect(TextureHandle texture, const ColourRGBA& col, float x, float y, float width, float height)
     {
-        glColor4f(col.GetRed(), col.GetGreen(), col.GetBlue(), col.GetAlpha());
+        RENDERSTATE.Colour(col);
+        RENDERSTATE.Enable(GL_TEXTURE_2D);
         TEXTURES.Bind(texture);
+        PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
         glBegin(GL_QUADS);
             glTexCoord2f(0.0f, 0.0f);
             glVertex2f(x, y + height);
@@ -52,30 +68,28 @@ namespace typing
 
     void DrawRect(ColourRGBA col, float x, float y, float width, float height)
     {
-        glColor4f(col.GetRed(), col.GetGreen(), col.GetBlue(), col.GetAlpha());
-        glDisable(GL_TEXTURE_2D);
+        RENDERSTATE.Colour(col);
+        RENDERSTATE.Disable(GL_TEXTURE_2D);
 
+        PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
         glBegin(GL_QUADS);
             glVertex2f(x, y + height);
             glVertex2f(x + width, y + height);
             glVertex2f(x + width, y);
             glVertex2f(x, y);
         glEnd();
-
-        glEnable(GL_TEXTURE_2D);
     }
 
     void DrawLine(const ColourRGBA& col, float startX, float startY, float startZ, float endX, float endY, float endZ)
     {
-        glColor4f(col.GetRed(), col.GetGreen(), col.GetBlue(), col.GetAlpha());
-        glDisable(GL_TEXTURE_2D);
+        RENDERSTATE.Colour(col);
+        RENDERSTATE.Disable(GL_TEXTURE_2D);
 
+        PROFILER.Count(Profiler::COUNTER_DRAW_CALLS);
         glBegin(GL_LINES);
             glVertex3f(startX, startY, startZ);
             glVertex3f(endX, endY, endZ);
         glEnd();
-
-        glEnable(GL_TEXTURE_2D);
     }
 
     void DrawLine(const ColourRGBA& col, const juzutil::Vector3& start, const juzutil::Vector3& end)
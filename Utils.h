@@ -5,6 +5,7 @@
 #include <random>
 #include "Vector.h"
 #include "Matrix.h"
+#include "AssetHandle.h"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_opengl.h>
@@ -17,9 +18,14 @@ class ColourRGBA;
 
 namespace typing
 {
+    class Texture;
+    typedef AssetHandle<Texture> TextureHandle;
+
     // Drawing utility funcs
     void DrawTexturedRect(const std::string& texture, float x, float y, float width, float height);
     void DrawTexturedRect(const std::string& texture, const ColourRGBA& col, float x, float y, float width, float height);
+    void DrawTexturedRect(TextureHandle texture, float x, float y, float width, float height);
+    void DrawTexturedRect(TextureHandle texture, const ColourRGBA& col, float x, float y, float width, float height);
     void DrawRect(ColourRGBA col, float x, float y, float width, float height);
     void DrawLine(const ColourRGBA& col, float startX, float startY, float startZ, float endX, float endY, float endZ);
     void DrawLine(const ColourRGBA& col, const juzutil::Vector3& start, const juzutil::Vector3& end);
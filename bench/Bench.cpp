@@ -0,0 +1,415 @@
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+#include "App.h"
+#include "Game.h"
+#include "FontManager.h"
+#include "PhraseBook.h"
+#include "PhraseFeatures.h"
+#include "Phrase.h"
+#include "Explosion.h"
+#include "EnemyWave.h"
+#include "Random.h"
+#include "Vector.h"
+#include "Exceptions.h"
+
+// Microbenchmarks for the parts of the game that run every frame, or that
+// hold up startup. Each benchmark is run several times and the fastest run
+// is kept, as that is the one least disturbed by the rest of the machine.
+//
+// Results are written as CSV (name,ns_per_op,iterations). Given a baseline
+// in the same format, the run fails if any benchmark has got slower by more
+// than the threshold, or if the baseline is missing. Benchmarks the baseline
+// doesn't have yet are reported but don't fail the run.
+
+namespace typing
+{
+    namespace bench
+    {
+        struct Result
+        {
+            std::string   name;
+            double        nsPerOp;
+            unsigned long iterations;
+        };
+
+        typedef std::vector<Result>            ResultVec;
+        typedef std::map<std::string, double>  BaselineMap;
+
+        const unsigned int  REPEATS     = 5;
+        const unsigned int  SEED        = 1234;
+        const unsigned int  SAMPLE_SIZE = 256;
+        const float         TEXT_HEIGHT = 18.0f;
+
+        // Written to so the compiler can't throw away the work being timed.
+        volatile float g_sink = 0.0f;
+
+        template <typename Fn>
+        Result Run(const std::string& name, unsigned long iterations, Fn fn)
+        {
+            typedef std::chrono::steady_clock Clock;
+
+            // Warm up the caches and any lazily created state.
+            fn();
+
+            double best = 0.0;
+            for (unsigned int r = 0; r < REPEATS; ++r) {
+                const Clock::time_point start = Clock::now();
+                for (unsigned long i = 0; i < iterations; ++i) {
+                    fn();
+                }
+                const std::chrono::duration<double, std::nano> taken =
+                    Clock::now() - start;
+
+                const double perOp = taken.count() / iterations;
+                if (r == 0 || perOp < best) {
+                    best = perOp;
+                }
+            }
+
+            fprintf(stdout, "%s\n", (boost::format("%-28s %14.1f ns/op")
+                                     % name % best).str().c_str());
+
+            Result res;
+            res.name       = name;
+            res.nsPerOp    = best;
+            res.iterations = iterations;
+            return res;
+        }
+
+        // Checks that the phrases FindPhrase picks match the query, so that
+        // the benchmarks for it are timing the right thing.
+        void CheckFindPhrase(const PhraseBook& book, const PhraseQuery& query)
+        {
+            for (unsigned int i = 0; i < SAMPLE_SIZE; ++i) {
+                PhraseView phrase;
+                if (!book.FindPhrase(query, phrase)) {
+                    throw std::runtime_error(
+                        (boost::format("No phrase found starting with '%c'")
+                         % query.startChar).str());
+                }
+
+                if (phrase[0] != query.startChar ||
+                    phrase.length() < query.minLength ||
+                    phrase.length() > query.maxLength ||
+                    (GetPhraseCharMask(phrase.data(),
+                                       static_cast<unsigned int>(phrase.length())) &
+                     query.excludeChars) != 0) {
+                    throw std::runtime_error(
+                        "FindPhrase picked \"" + phrase.to_string() +
+                        "\", which doesn't match the query");
+                }
+            }
+        }
+
+        void RunAll(ResultVec& results)
+        {
+            const Font& font = FONTS.Get(Phrase::PHRASE_FONT);
+
+            // Loading is timed from the phrase file and from an index, each
+            // on its own, so that whether 'make phrases' has been run
+            // doesn't change what is being measured. The index is compiled
+            // here rather than using the game's, which may be out of date.
+            results.push_back(Run("phrasebook_load_text", 1, [&]() {
+                PhraseBook book;
+                book.Init(font, "");
+            }));
+
+            const std::string indexFile = PhraseBook::PHRASE_INDEX_FILE + ".bench";
+            PhraseBook::CompileIndex(font, PhraseBook::PHRASE_FILE, indexFile);
+            results.push_back(Run("phrasebook_map_index", 1, [&]() {
+                PhraseBook book;
+                book.Init(font, indexFile);
+            }));
+            remove(indexFile.c_str());
+
+            RAND.Seed(SEED);
+            PhraseBook book;
+            book.Init(font);
+
+            results.push_back(Run("phrasebook_get_phrase", 100000, [&]() {
+                const PhraseView phrase =
+                    book.GetPhrase(PhraseBook::PL_MEDIUM);
+                book.MakeCharAvail(phrase[0]);
+            }));
+
+            results.push_back(Run("phrasebook_get_combo_phrase", 100000, [&]() {
+                const std::string phrase =
+                    book.GetComboPhrase(3, PhraseBook::PL_SHORT);
+                book.MakeCharAvail(phrase[0]);
+            }));
+
+            // A harder than average phrase of a given length, as the game
+            // might ask for on a later level, with and without upper case
+            // and punctuation.
+            const PhraseQuery query('s', 8, 12, 0.6f, 0.8f);
+            const PhraseQuery plainQuery('s', 8, 12, 0.6f, 0.8f,
+                                         (uint64_t(1) << PCB_UPPER) |
+                                         (uint64_t(1) << PCB_PUNCTUATION));
+            CheckFindPhrase(book, query);
+            CheckFindPhrase(book, plainQuery);
+
+            results.push_back(Run("phrasebook_find_phrase", 100000, [&]() {
+                PhraseView phrase;
+                book.FindPhrase(query, phrase);
+                g_sink = static_cast<float>(phrase.length());
+            }));
+
+            results.push_back(Run("phrasebook_find_excluding", 100000, [&]() {
+                PhraseView phrase;
+                book.FindPhrase(plainQuery, phrase);
+                g_sink = static_cast<float>(phrase.length());
+            }));
+
+            // The text benchmarks work through a fixed sample of phrases, so
+            // that they see the same mix of lengths and letters as the game.
+            RAND.Seed(SEED);
+            std::vector<std::string> sample;
+            for (unsigned int i = 0; i < SAMPLE_SIZE; ++i) {
+                sample.push_back(book.GetPhrase(
+                    static_cast<PhraseBook::PhraseLength>(
+                        i % PhraseBook::PL_COUNT)).to_string());
+                book.MakeCharAvail(sample.back()[0]);
+            }
+
+            results.push_back(Run("font_line_width", 1000, [&]() {
+                float width = 0.0f;
+                for (const std::string& phrase : sample) {
+                    width += font.GetLineWidth(TEXT_HEIGHT, phrase);
+                }
+                g_sink = width;
+            }));
+
+            results.push_back(Run("font_print", 1000, [&]() {
+                for (const std::string& phrase : sample) {
+                    font.Print(0.0f, 0.0f, TEXT_HEIGHT,
+                               ColourRGBA(1.0f, 1.0f, 1.0f, 1.0f),
+                               Font::ALIGN_CENTER, phrase);
+                }
+                font.Flush();
+            }));
+
+            // A frame's worth of updates for a screen full of explosions,
+            // bursting them again once all of the fragments have died.
+            RAND.Seed(SEED);
+            std::vector<Explosion> explosions;
+            for (unsigned int i = 0; i < 32; ++i) {
+                explosions.push_back(Explosion(
+                    juzutil::Vector3(RAND.Range(-200.0f, 200.0f),
+                                     RAND.Range(-150.0f, 150.0f),
+                                     0.0f),
+                    ColourRGBA(1.0f, 0.5f, 0.0f, 1.0f)));
+            }
+
+            ParticleSystem& particles = GAME.GetParticles();
+            results.push_back(Run("explosion_update", 10000, [&]() {
+                if (particles.Count() == 0) {
+                    for (Explosion& explosion : explosions) {
+                        explosion.OnSpawn();
+                    }
+                }
+                for (Explosion& explosion : explosions) {
+                    explosion.Update();
+                }
+                particles.Update(1.0f / App::TICK_RATE);
+            }));
+            particles.Clear();
+
+            RAND.Seed(SEED);
+            std::vector<juzutil::Vector3> a(1024);
+            std::vector<juzutil::Vector3> b(1024);
+            for (unsigned int i = 0; i < a.size(); ++i) {
+                a[i] = juzutil::Vector3(RAND.Range(-1.0f, 1.0f),
+                                        RAND.Range(-1.0f, 1.0f),
+                                        RAND.Range(-1.0f, 1.0f));
+                b[i] = juzutil::Vector3(RAND.Range(-1.0f, 1.0f),
+                                        RAND.Range(-1.0f, 1.0f),
+                                        RAND.Range(-1.0f, 1.0f));
+            }
+
+            results.push_back(Run("vector3_arithmetic", 10000, [&]() {
+                float total = 0.0f;
+                for (unsigned int i = 0; i < a.size(); ++i) {
+                    juzutil::Vector3 dir = (a[i] - b[i]) * 0.5f + a[i] % b[i];
+                    total += dir * b[i] + dir.Size();
+                }
+                g_sink = total;
+            }));
+
+            RandomEnemyWaveFactory waves;
+            waves.AddWave<BasicEnemyWave>(0);
+            waves.AddWave<MissileEnemyWave>(1);
+            waves.AddWave<AccelEnemyWave>(2);
+            waves.AddWave<SeekerEnemyWave>(3);
+            waves.AddWave<BombEnemyWave>(4);
+
+            RAND.Seed(SEED);
+            unsigned int level = 0;
+            results.push_back(Run("wave_create", 100000, [&]() {
+                EnemyWavePtr wave = waves.CreateWave(level++ % 6);
+            }));
+        }
+
+        void Save(const std::string& fileName, const ResultVec& results)
+        {
+            std::ofstream file(fileName.c_str());
+            if (!file) {
+                throw FileWriteException(fileName);
+            }
+
+            file << "name,ns_per_op,iterations\n";
+            for (const Result& res : results) {
+                file << boost::format("%s,%.1f,%lu\n")
+                        % res.name % res.nsPerOp % res.iterations;
+            }
+
+            if (!file) {
+                throw FileWriteException(fileName);
+            }
+        }
+
+        void LoadBaseline(const std::string& fileName, BaselineMap& baseline)
+        {
+            std::ifstream file(fileName.c_str());
+            if (!file) {
+                throw FileNotFoundException(
+                    fileName + " (run with --update-baseline to create it)");
+            }
+
+            std::string line;
+            std::getline(file, line);
+            if (line.compare(0, 5, "name,")) {
+                throw FileCorruptException(fileName + ": Invalid header");
+            }
+
+            while (std::getline(file, line)) {
+                if (line.empty()) {
+                    continue;
+                }
+
+                std::istringstream fields(line);
+                std::string name;
+                std::string nsPerOp;
+                if (!std::getline(fields, name, ',') ||
+                    !std::getline(fields, nsPerOp, ',')) {
+                    throw FileCorruptException(fileName + ": Invalid line");
+                }
+
+                try {
+                    baseline[name] = std::stod(nsPerOp);
+                } catch (std::exception&) {
+                    throw FileCorruptException(fileName + ": Invalid time");
+                }
+            }
+        }
+
+        // Returns the number of benchmarks that have regressed.
+        unsigned int Compare(const ResultVec&   results,
+                             const BaselineMap& baseline,
+                             double             threshold)
+        {
+            unsigned int regressions = 0;
+
+            for (const Result& res : results) {
+                BaselineMap::const_iterator iter = baseline.find(res.name);
+                if (iter == baseline.end() || iter->second <= 0.0) {
+                    fprintf(stdout, "%s\n", (boost::format("%-28s    no baseline")
+                                             % res.name).str().c_str());
+                    continue;
+                }
+
+                const double change = res.nsPerOp / iter->second - 1.0;
+                const bool   failed = change > threshold;
+                if (failed) {
+                    ++regressions;
+                }
+
+                fprintf(stdout, "%s\n", (boost::format("%-28s %+13.1f%%%s")
+                                         % res.name % (change * 100.0)
+                                         % (failed ? "  REGRESSED" : ""))
+                                        .str().c_str());
+            }
+
+            return regressions;
+        }
+    }
+}
+
+int main (int argc, char *argv[])
+{
+    namespace po = boost::program_options;
+    using namespace typing;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("output,o",
+            po::value<std::string>()->default_value("bench.csv"),
+            "file to write the results to")
+        ("baseline,b",
+            po::value<std::string>(),
+            "results to compare against")
+        ("threshold",
+            po::value<double>()->default_value(0.15),
+            "fraction a benchmark may slow down by before failing")
+        ("update-baseline",
+            po::bool_switch(),
+            "write the results over the baseline instead of comparing")
+    ;
+
+    unsigned int regressions = 0;
+
+    try {
+        po::variables_map options;
+        po::store(po::parse_command_line(argc, argv, desc), options);
+        po::notify(options);
+
+        // The game is set up as it would be for simulated games, which
+        // loads the fonts and phrases without a window or audio.
+        char  appName[]  = "bench";
+        char  headless[] = "--headless";
+        char* appArgv[]  = { appName, headless };
+        APP.ParseOptions(2, appArgv);
+        APP.Init();
+
+        bench::ResultVec results;
+        bench::RunAll(results);
+        bench::Save(options["output"].as<std::string>(), results);
+
+        if (options.count("baseline")) {
+            const std::string baselineFile =
+                options["baseline"].as<std::string>();
+
+            if (options["update-baseline"].as<bool>()) {
+                bench::Save(baselineFile, results);
+            } else {
+                bench::BaselineMap baseline;
+                bench::LoadBaseline(baselineFile, baseline);
+                regressions = bench::Compare(
+                    results, baseline, options["threshold"].as<double>());
+            }
+        }
+    } catch (std::exception &e) {
+        APP.Log(App::LOG_ERROR, e.what());
+        APP.Shutdown();
+        return 2;
+    }
+
+    APP.Shutdown();
+
+    if (regressions) {
+        APP.Log(App::LOG_ERROR, (boost::format("%u benchmark(s) regressed")
+                                 % regressions).str());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <cstring>
+#include <SDL2/SDL_opengl.h>
+
+// No-op versions of the GL functions used by the game, so that the
+// benchmarks can run the drawing code without a window or GL context.
+// Only the CPU side of drawing is measured.
+
+void APIENTRY glBegin(GLenum mode) {}
+void APIENTRY glEnd() {}
+void APIENTRY glBindTexture(GLenum target, GLuint texture) {}
+void APIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor) {}
+void APIENTRY glClear(GLbitfield mask) {}
+void APIENTRY glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha) {}
+void APIENTRY glClearDepth(GLclampd depth) {}
+void APIENTRY glColor3f(GLfloat red, GLfloat green, GLfloat blue) {}
+void APIENTRY glColor4f(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {}
+void APIENTRY glEnable(GLenum cap) {}
+void APIENTRY glDisable(GLenum cap) {}
+void APIENTRY glEnableClientState(GLenum cap) {}
+void APIENTRY glDisableClientState(GLenum cap) {}
+void APIENTRY glHint(GLenum target, GLenum mode) {}
+void APIENTRY glLineWidth(GLfloat width) {}
+void APIENTRY glPixelStorei(GLenum pname, GLint param) {}
+
+// Matrices
+void APIENTRY glMatrixMode(GLenum mode) {}
+void APIENTRY glLoadIdentity() {}
+void APIENTRY glLoadMatrixf(const GLfloat *m) {}
+void APIENTRY glOrtho(GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear, GLdouble zFar) {}
+void APIENTRY glPushMatrix() {}
+void APIENTRY glPopMatrix() {}
+void APIENTRY glRotatef(GLfloat angle, GLfloat x, GLfloat y, GLfloat z) {}
+void APIENTRY glScalef(GLfloat x, GLfloat y, GLfloat z) {}
+void APIENTRY glTranslatef(GLfloat x, GLfloat y, GLfloat z) {}
+
+// Immediate mode
+void APIENTRY glTexCoord2f(GLfloat s, GLfloat t) {}
+void APIENTRY glVertex2f(GLfloat x, GLfloat y) {}
+void APIENTRY glVertex3f(GLfloat x, GLfloat y, GLfloat z) {}
+
+// Vertex arrays
+void APIENTRY glVertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *ptr) {}
+void APIENTRY glTexCoordPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *ptr) {}
+void APIENTRY glColorPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *ptr) {}
+void APIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count) {}
+
+// Display lists
+GLuint APIENTRY glGenLists(GLsizei range)
+{
+    return 1;
+}
+
+void APIENTRY glNewList(GLuint list, GLenum mode) {}
+void APIENTRY glEndList() {}
+void APIENTRY glCallList(GLuint list) {}
+
+// Textures
+void APIENTRY glGenTextures(GLsizei n, GLuint *textures)
+{
+    memset(textures, 0, n * sizeof(GLuint));
+}
+
+void APIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param) {}
+void APIENTRY glTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels) {}
+void APIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels) {}
+
+void APIENTRY glGetIntegerv(GLenum pname, GLint *params)
+{
+    // The viewport is the only query with more than one value.
+    memset(params, 0, (pname == GL_VIEWPORT ? 4 : 1) * sizeof(GLint));
+}
@@ -0,0 +1,55 @@
+#include <stdio.h>
+#include <exception>
+#include <string>
+#include <boost/program_options.hpp>
+#include "PhraseBook.h"
+#include "Phrase.h"
+#include "FontManager.h"
+#include "TextureManager.h"
+
+// Compiles a phrase file into the index that the game maps at startup,
+// keeping only the phrases that the phrase font can draw.
+
+int main (int argc, char *argv[])
+{
+    namespace po = boost::program_options;
+    using namespace typing;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("input,i",
+            po::value<std::string>()->default_value(PhraseBook::PHRASE_FILE),
+            "phrase file to compile")
+        ("output,o",
+            po::value<std::string>()->default_value(
+                PhraseBook::PHRASE_INDEX_FILE),
+            "index file to write")
+        ("font,f",
+            po::value<std::string>()->default_value(Phrase::PHRASE_FONT),
+            "font the phrases must be drawable in")
+    ;
+
+    try {
+        po::variables_map options;
+        po::store(po::parse_command_line(argc, argv, desc), options);
+        po::notify(options);
+
+        const std::string input  = options["input"].as<std::string>();
+        const std::string output = options["output"].as<std::string>();
+        const std::string font   = options["font"].as<std::string>();
+
+        // Only the font's metrics are needed, not its texture.
+        TEXTURES.SetHeadless(true);
+        FONTS.Add(font);
+
+        const unsigned int count =
+            PhraseBook::CompileIndex(FONTS.Get(font), input, output);
+        fprintf(stdout, "Wrote %u phrases from %s to %s\n",
+                count, input.c_str(), output.c_str());
+    } catch (std::exception &e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}